@@ -3,8 +3,26 @@
 
 #include <string>
 #include "CompiledStaticMesh/Interface.h"
+#include "CompiledStaticMesh/AlphaScanner.h"
+#include "CompiledStaticMesh/Analyzer.h"
+#include "CompiledStaticMesh/Compressed.h"
+#include "CompiledStaticMesh/Crc32c.h"
+#include "CompiledStaticMesh/Geometry.h"
+#include "CompiledStaticMesh/Hash.h"
+#include "CompiledStaticMesh/Lz.h"
+#include "CompiledStaticMesh/MappedFile.h"
+#include "CompiledStaticMesh/MipGenerator.h"
+#include "CompiledStaticMesh/NormalGenerator.h"
+#include "CompiledStaticMesh/Pack.h"
+#include "CompiledStaticMesh/Parallel.h"
+#include "CompiledStaticMesh/PixelConverter.h"
+#include "CompiledStaticMesh/Quantized.h"
+#include "CompiledStaticMesh/RadixSort.h"
+#include "CompiledStaticMesh/TangentGenerator.h"
+#include "CompiledStaticMesh/Tiled.h"
 #include "CompiledStaticMesh/Version2.h"
 #include "CompiledStaticMesh/Version3.h"
+#include "CompiledStaticMesh/Welder.h"
 
 namespace CompiledStaticMesh {
 
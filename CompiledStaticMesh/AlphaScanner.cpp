@@ -0,0 +1,69 @@
+#include "AlphaScanner.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ALPHASCANNER_SSE2
+#endif
+
+namespace CompiledStaticMesh {
+
+AlphaScanner::Coverage AlphaScanner::scanSoftware(const uint8_t *pixels, size_t pixelCount, bool hasZero)
+{
+    for (size_t i = 0; i < pixelCount; i++) {
+        uint8_t alpha = pixels[i * 4 + 3];
+
+        if (alpha == 0) {
+            hasZero = true;
+        } else if (alpha != 255) {
+            return Graded;
+        }
+    }
+
+    return hasZero ? Binary : Opaque;
+}
+
+AlphaScanner::Coverage AlphaScanner::scan(const void *rgbaPixels, size_t pixelCount)
+{
+    const uint8_t *pixels = reinterpret_cast<const uint8_t *>(rgbaPixels);
+    bool hasZero = false;
+    size_t i = 0;
+
+#if defined(ALPHASCANNER_SSE2)
+    /*
+        Sixteen pixels per step, alpha bytes sit in every fourth lane of the byte masks
+    */
+    static constexpr const int AlphaLanes = 0x8888;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi8(static_cast<char>(0xff));
+    int zeroLanes = 0;
+
+    for (; i + 16 <= pixelCount; i += 16) {
+        const __m128i *block = reinterpret_cast<const __m128i *>(pixels + i * 4);
+        __m128i a = _mm_loadu_si128(block);
+        __m128i b = _mm_loadu_si128(block + 1);
+        __m128i c = _mm_loadu_si128(block + 2);
+        __m128i d = _mm_loadu_si128(block + 3);
+
+        __m128i zeroA = _mm_cmpeq_epi8(a, zero);
+        __m128i zeroB = _mm_cmpeq_epi8(b, zero);
+        __m128i zeroC = _mm_cmpeq_epi8(c, zero);
+        __m128i zeroD = _mm_cmpeq_epi8(d, zero);
+
+        __m128i extreme = _mm_and_si128(
+            _mm_and_si128(_mm_or_si128(zeroA, _mm_cmpeq_epi8(a, full)), _mm_or_si128(zeroB, _mm_cmpeq_epi8(b, full))),
+            _mm_and_si128(_mm_or_si128(zeroC, _mm_cmpeq_epi8(c, full)), _mm_or_si128(zeroD, _mm_cmpeq_epi8(d, full))));
+
+        if ((_mm_movemask_epi8(extreme) & AlphaLanes) != AlphaLanes) {
+            return Graded;
+        }
+
+        zeroLanes |= _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(zeroA, zeroB), _mm_or_si128(zeroC, zeroD)));
+    }
+
+    hasZero = (zeroLanes & AlphaLanes) != 0;
+#endif
+
+    return scanSoftware(pixels + i * 4, pixelCount - i, hasZero);
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,33 @@
+#ifndef COMPILEDSTATICMESH_ALPHASCANNER_H
+#define COMPILEDSTATICMESH_ALPHASCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CompiledStaticMesh {
+
+class AlphaScanner
+{
+
+public:
+    /*
+        Binary alpha only holds 0 and 255 and can be alpha tested, anything
+        in between needs blending
+    */
+    enum Coverage {
+        Opaque,
+        Binary,
+        Graded
+    };
+
+private:
+    static Coverage scanSoftware(const uint8_t *pixels, size_t pixelCount, bool hasZero);
+
+public:
+    static Coverage scan(const void *rgbaPixels, size_t pixelCount);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_ALPHASCANNER_H
@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <cmath>
+#include "Analyzer.h"
+#include "Parallel.h"
+
+namespace CompiledStaticMesh {
+
+static uint32_t partitionOf(uint32_t index, uint32_t vertexCount, uint32_t partitionCount)
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(index) * partitionCount / vertexCount);
+}
+
+/*
+    Counting sort of one partition by the smallest vertex index, then a short
+    insertion sort inside each vertex group, which is usually only a few items long
+*/
+template<typename T, typename Compare, typename Visitor>
+static void groupByVertex(std::vector<std::vector<std::vector<T>>> &threadItems, uint32_t partition,
+    uint32_t firstVertex, uint32_t lastVertex, Compare compare, Visitor visitor)
+{
+    std::vector<uint32_t> offsets(lastVertex - firstVertex + 1, 0);
+
+    for (std::vector<std::vector<T>> &items : threadItems) {
+        for (const T &item : items[partition]) {
+            offsets[item.index[0] - firstVertex + 1]++;
+        }
+    }
+
+    for (size_t i = 1; i < offsets.size(); i++) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    std::vector<T> sorted(offsets.back());
+    std::vector<uint32_t> positions(offsets.begin(), offsets.end() - 1);
+
+    for (std::vector<std::vector<T>> &items : threadItems) {
+        for (const T &item : items[partition]) {
+            sorted[positions[item.index[0] - firstVertex]++] = item;
+        }
+
+        items[partition] = std::vector<T>();
+    }
+
+    for (size_t i = 0; i + 1 < offsets.size(); i++) {
+        T *begin = sorted.data() + offsets[i];
+        T *end = sorted.data() + offsets[i + 1];
+
+        for (T *j = begin + 1; j < end; j++) {
+            T item = *j;
+            T *k = j;
+
+            while (k > begin && compare(item, *(k - 1))) {
+                *k = *(k - 1);
+                k--;
+            }
+
+            *k = item;
+        }
+
+        if (begin != end) {
+            visitor(begin, end);
+        }
+    }
+}
+
+static void joinIndices(std::vector<uint32_t> *indices, std::vector<std::vector<uint32_t>> &parts,
+    bool sortUnique)
+{
+    size_t size = 0;
+
+    for (const std::vector<uint32_t> &part : parts) {
+        size += part.size();
+    }
+
+    indices->clear();
+    indices->reserve(size);
+
+    for (std::vector<uint32_t> &part : parts) {
+        indices->insert(indices->end(), part.begin(), part.end());
+        part = std::vector<uint32_t>();
+    }
+
+    if (sortUnique) {
+        std::sort(indices->begin(), indices->end());
+        indices->erase(std::unique(indices->begin(), indices->end()), indices->end());
+    }
+}
+
+Analyzer::Analyzer()
+{
+    clear();
+}
+
+void Analyzer::clear()
+{
+    for (uint32_t i = 0; i < IssueCount; i++) {
+        m_counts[i] = 0;
+        m_indices[i].clear();
+    }
+}
+
+bool Analyzer::analyze(const Interface *mesh, const void *faceData, const void *vertexData)
+{
+    clear();
+
+    if (mesh == nullptr || faceData == nullptr || vertexData == nullptr) {
+        return false;
+    }
+
+    std::vector<uint8_t> validFaces(mesh->faceCount(), 0);
+
+    analyzeFaces(mesh, faceData, vertexData, &validFaces);
+    analyzeEdges(mesh, faceData, validFaces);
+    analyzeDuplicates(mesh, faceData, validFaces);
+    analyzeVertices(mesh, faceData);
+
+    return true;
+}
+
+uint32_t Analyzer::count(Issue issue) const
+{
+    return m_counts[issue];
+}
+
+const std::vector<uint32_t> &Analyzer::indices(Issue issue) const
+{
+    return m_indices[issue];
+}
+
+void Analyzer::analyzeFaces(const Interface *mesh, const void *faceData, const void *vertexData,
+    std::vector<uint8_t> *validFaces)
+{
+    uint32_t faceCount = mesh->faceCount();
+    uint32_t vertexCount = mesh->vertexCount();
+    uint32_t threadCount = Parallel::threadCount(faceCount);
+
+    std::vector<std::vector<uint32_t>> degenerateFaces(threadCount);
+    std::vector<std::vector<uint32_t>> zeroAreaFaces(threadCount);
+
+    Parallel::forEach(faceCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t index[3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                index[j] = mesh->faceVertexIndex(faceData, i, j);
+            }
+
+            if (index[0] >= vertexCount || index[1] >= vertexCount || index[2] >= vertexCount ||
+                index[0] == index[1] || index[1] == index[2] || index[2] == index[0]) {
+                degenerateFaces[thread].push_back(i);
+                continue;
+            }
+
+            (*validFaces)[i] = 1;
+
+            float position[3][3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                mesh->vertexPosition(vertexData, index[j], position[j]);
+            }
+
+            float edge[3][3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                edge[0][j] = position[1][j] - position[0][j];
+                edge[1][j] = position[2][j] - position[0][j];
+                edge[2][j] = position[2][j] - position[1][j];
+            }
+
+            float cross[3] = {
+                edge[0][1] * edge[1][2] - edge[0][2] * edge[1][1],
+                edge[0][2] * edge[1][0] - edge[0][0] * edge[1][2],
+                edge[0][0] * edge[1][1] - edge[0][1] * edge[1][0]
+            };
+
+            float crossLength = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+            float edgeLength = 0.0f;
+
+            for (uint32_t j = 0; j < 3; j++) {
+                edgeLength = std::max(edgeLength,
+                    edge[j][0] * edge[j][0] + edge[j][1] * edge[j][1] + edge[j][2] * edge[j][2]);
+            }
+
+            /*
+                Area relative to the longest edge, so the test does not depend on model scale
+            */
+            float threshold = edgeLength * ZeroAreaEpsilon;
+
+            if (!(crossLength > threshold * threshold)) {
+                zeroAreaFaces[thread].push_back(i);
+            }
+        }
+    });
+
+    joinIndices(&m_indices[DegenerateFaces], degenerateFaces, false);
+    joinIndices(&m_indices[ZeroAreaFaces], zeroAreaFaces, false);
+    m_counts[DegenerateFaces] = static_cast<uint32_t>(m_indices[DegenerateFaces].size());
+    m_counts[ZeroAreaFaces] = static_cast<uint32_t>(m_indices[ZeroAreaFaces].size());
+}
+
+void Analyzer::analyzeEdges(const Interface *mesh, const void *faceData,
+    const std::vector<uint8_t> &validFaces)
+{
+    uint32_t faceCount = mesh->faceCount();
+    uint32_t vertexCount = mesh->vertexCount();
+    uint32_t threadCount = Parallel::threadCount(faceCount);
+    uint32_t partitionCount = threadCount;
+
+    /*
+        Split edges into vertex ranges per thread, then group each range independently
+    */
+    std::vector<std::vector<std::vector<Edge>>> threadEdges(threadCount,
+        std::vector<std::vector<Edge>>(partitionCount));
+
+    Parallel::forEach(faceCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        std::vector<std::vector<Edge>> &edges = threadEdges[thread];
+
+        for (std::vector<Edge> &partition : edges) {
+            partition.reserve(static_cast<size_t>(end - begin) * 3 / partitionCount + 16);
+        }
+
+        for (uint32_t i = begin; i < end; i++) {
+            if (validFaces[i] == 0) {
+                continue;
+            }
+
+            uint32_t index[3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                index[j] = mesh->faceVertexIndex(faceData, i, j);
+            }
+
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t a = index[j];
+                uint32_t b = index[(j + 1) % 3];
+
+                Edge edge;
+                edge.index[0] = a < b ? a : b;
+                edge.index[1] = a < b ? b : a;
+                edge.face = i;
+                edges[partitionOf(edge.index[0], vertexCount, partitionCount)].push_back(edge);
+            }
+        }
+    });
+
+    std::vector<std::vector<uint32_t>> openEdgeFaces(partitionCount);
+    std::vector<std::vector<uint32_t>> nonManifoldEdgeFaces(partitionCount);
+    std::vector<uint32_t> openEdgeCounts(partitionCount, 0);
+    std::vector<uint32_t> nonManifoldEdgeCounts(partitionCount, 0);
+
+    Parallel::forEachThread(partitionCount, [&](uint32_t partition) {
+        uint32_t firstVertex = static_cast<uint32_t>(
+            (static_cast<uint64_t>(vertexCount) * partition + partitionCount - 1) / partitionCount);
+        uint32_t lastVertex = static_cast<uint32_t>(
+            (static_cast<uint64_t>(vertexCount) * (partition + 1) + partitionCount - 1) / partitionCount);
+
+        groupByVertex(threadEdges, partition, firstVertex, lastVertex,
+            [](const Edge &a, const Edge &b) {
+            return a.index[1] < b.index[1];
+        }, [&](const Edge *begin, const Edge *end) {
+            for (const Edge *i = begin; i < end;) {
+                const Edge *j = i + 1;
+
+                while (j < end && j->index[1] == i->index[1]) {
+                    j++;
+                }
+
+                if (j - i == 1) {
+                    openEdgeCounts[partition]++;
+                    openEdgeFaces[partition].push_back(i->face);
+                } else if (j - i > 2) {
+                    nonManifoldEdgeCounts[partition]++;
+
+                    for (const Edge *k = i; k < j; k++) {
+                        nonManifoldEdgeFaces[partition].push_back(k->face);
+                    }
+                }
+
+                i = j;
+            }
+        });
+    });
+
+    for (uint32_t i = 0; i < partitionCount; i++) {
+        m_counts[OpenEdges] += openEdgeCounts[i];
+        m_counts[NonManifoldEdges] += nonManifoldEdgeCounts[i];
+    }
+
+    joinIndices(&m_indices[OpenEdges], openEdgeFaces, true);
+    joinIndices(&m_indices[NonManifoldEdges], nonManifoldEdgeFaces, true);
+}
+
+void Analyzer::analyzeDuplicates(const Interface *mesh, const void *faceData,
+    const std::vector<uint8_t> &validFaces)
+{
+    uint32_t faceCount = mesh->faceCount();
+    uint32_t vertexCount = mesh->vertexCount();
+    uint32_t threadCount = Parallel::threadCount(faceCount);
+    uint32_t partitionCount = threadCount;
+
+    std::vector<std::vector<std::vector<FaceKey>>> threadKeys(threadCount,
+        std::vector<std::vector<FaceKey>>(partitionCount));
+
+    Parallel::forEach(faceCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        std::vector<std::vector<FaceKey>> &keys = threadKeys[thread];
+
+        for (uint32_t i = begin; i < end; i++) {
+            if (validFaces[i] == 0) {
+                continue;
+            }
+
+            FaceKey key;
+
+            for (uint32_t j = 0; j < 3; j++) {
+                key.index[j] = mesh->faceVertexIndex(faceData, i, j);
+            }
+
+            std::sort(key.index, key.index + 3);
+            key.face = i;
+            keys[partitionOf(key.index[0], vertexCount, partitionCount)].push_back(key);
+        }
+    });
+
+    std::vector<std::vector<uint32_t>> duplicateFaces(partitionCount);
+
+    Parallel::forEachThread(partitionCount, [&](uint32_t partition) {
+        uint32_t firstVertex = static_cast<uint32_t>(
+            (static_cast<uint64_t>(vertexCount) * partition + partitionCount - 1) / partitionCount);
+        uint32_t lastVertex = static_cast<uint32_t>(
+            (static_cast<uint64_t>(vertexCount) * (partition + 1) + partitionCount - 1) / partitionCount);
+
+        groupByVertex(threadKeys, partition, firstVertex, lastVertex,
+            [](const FaceKey &a, const FaceKey &b) {
+            if (a.index[1] != b.index[1]) {
+                return a.index[1] < b.index[1];
+            }
+
+            if (a.index[2] != b.index[2]) {
+                return a.index[2] < b.index[2];
+            }
+
+            return a.face < b.face;
+        }, [&](const FaceKey *begin, const FaceKey *end) {
+            for (const FaceKey *i = begin + 1; i < end; i++) {
+                if (i->index[1] == (i - 1)->index[1] && i->index[2] == (i - 1)->index[2]) {
+                    duplicateFaces[partition].push_back(i->face);
+                }
+            }
+        });
+    });
+
+    joinIndices(&m_indices[DuplicateFaces], duplicateFaces, true);
+    m_counts[DuplicateFaces] = static_cast<uint32_t>(m_indices[DuplicateFaces].size());
+}
+
+void Analyzer::analyzeVertices(const Interface *mesh, const void *faceData)
+{
+    uint32_t faceCount = mesh->faceCount();
+    uint32_t vertexCount = mesh->vertexCount();
+    uint32_t threadCount = Parallel::threadCount(faceCount);
+    uint32_t wordCount = (vertexCount + 63) / 64;
+
+    std::vector<std::vector<uint64_t>> threadReferences(threadCount);
+
+    Parallel::forEach(faceCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        std::vector<uint64_t> &references = threadReferences[thread];
+        references.assign(wordCount, 0);
+
+        for (uint32_t i = begin; i < end; i++) {
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t index = mesh->faceVertexIndex(faceData, i, j);
+                if (index < vertexCount) {
+                    references[index / 64] |= 1ULL << (index % 64);
+                }
+            }
+        }
+    });
+
+    std::vector<std::vector<uint32_t>> unreferencedVertices(Parallel::threadCount(wordCount));
+
+    Parallel::forEach(wordCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint64_t word = 0;
+
+            for (const std::vector<uint64_t> &references : threadReferences) {
+                if (!references.empty()) {
+                    word |= references[i];
+                }
+            }
+
+            for (uint32_t j = 0; j < 64 && i * 64 + j < vertexCount; j++) {
+                if ((word & (1ULL << j)) == 0) {
+                    unreferencedVertices[thread].push_back(i * 64 + j);
+                }
+            }
+        }
+    });
+
+    joinIndices(&m_indices[UnreferencedVertices], unreferencedVertices, false);
+    m_counts[UnreferencedVertices] = static_cast<uint32_t>(m_indices[UnreferencedVertices].size());
+}
+
+} // namespace CompiledStaticMesh
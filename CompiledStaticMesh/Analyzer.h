@@ -0,0 +1,63 @@
+#ifndef COMPILEDSTATICMESH_ANALYZER_H
+#define COMPILEDSTATICMESH_ANALYZER_H
+
+#include <cstdint>
+#include <vector>
+#include "Interface.h"
+
+namespace CompiledStaticMesh {
+
+class Analyzer
+{
+
+public:
+    /*
+        Face issues list face indices, edge issues list the faces sharing
+        the offending edges and UnreferencedVertices lists vertex indices.
+    */
+    enum Issue {
+        DegenerateFaces,
+        ZeroAreaFaces,
+        DuplicateFaces,
+        NonManifoldEdges,
+        OpenEdges,
+        UnreferencedVertices,
+        IssueCount
+    };
+
+    static constexpr const float ZeroAreaEpsilon = 1.0e-6f;
+
+private:
+    struct Edge {
+        uint32_t index[2];
+        uint32_t face;
+    };
+
+    struct FaceKey {
+        uint32_t index[3];
+        uint32_t face;
+    };
+
+    uint32_t m_counts[IssueCount];
+    std::vector<uint32_t> m_indices[IssueCount];
+
+    void analyzeFaces(const Interface *mesh, const void *faceData, const void *vertexData,
+        std::vector<uint8_t> *validFaces);
+    void analyzeEdges(const Interface *mesh, const void *faceData,
+        const std::vector<uint8_t> &validFaces);
+    void analyzeDuplicates(const Interface *mesh, const void *faceData,
+        const std::vector<uint8_t> &validFaces);
+    void analyzeVertices(const Interface *mesh, const void *faceData);
+
+public:
+    Analyzer();
+    void clear();
+    bool analyze(const Interface *mesh, const void *faceData, const void *vertexData);
+    uint32_t count(Issue issue) const;
+    const std::vector<uint32_t> &indices(Issue issue) const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_ANALYZER_H
@@ -0,0 +1,619 @@
+#include <cstring>
+#include "Compressed.h"
+#include "Lz.h"
+#include "Parallel.h"
+#include "Version2.h"
+#include "Version3.h"
+
+namespace CompiledStaticMesh {
+
+Compressed::Compressed() :
+    Interface(),
+    m_format(nullptr)
+{
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+Compressed::~Compressed()
+{
+    Compressed::close();
+}
+
+bool Compressed::createFormat(uint32_t version)
+{
+    if (m_format != nullptr) {
+        delete m_format;
+        m_format = nullptr;
+    }
+
+    switch (version) {
+    case Version2::Version:
+        m_format = new Version2;
+        break;
+
+    case Version3::Version:
+        m_format = new Version3;
+        break;
+
+    default:
+        return false;
+    }
+
+    if (m_format->headerSize() > MaxSourceHeaderSize) {
+        return false;
+    }
+
+    m_header.sourceVersion = version;
+    m_header.sourceHeaderSize = m_format->headerSize();
+
+    return true;
+}
+
+uint32_t Compressed::blockElementCount(const Section &section) const
+{
+    uint32_t count = m_header.blockSize / section.elementSize;
+    if (count < 1) {
+        count = 1;
+    }
+
+    return count;
+}
+
+void Compressed::shuffle(const uint8_t *source, uint8_t *target, uint32_t count, uint32_t elementSize)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < elementSize; j++) {
+            target[static_cast<size_t>(j) * count + i] = source[static_cast<size_t>(i) * elementSize + j];
+        }
+    }
+}
+
+void Compressed::unshuffle(const uint8_t *source, uint8_t *target, uint32_t count, uint32_t elementSize)
+{
+    for (uint32_t j = 0; j < elementSize; j++) {
+        const uint8_t *plane = source + static_cast<size_t>(j) * count;
+
+        for (uint32_t i = 0; i < count; i++) {
+            target[static_cast<size_t>(i) * elementSize + j] = plane[i];
+        }
+    }
+}
+
+bool Compressed::writeSection(Section *section)
+{
+    section->elementCount = static_cast<uint32_t>(m_pending.size() / section->elementSize);
+
+    uint32_t blockElements = blockElementCount(*section);
+    uint32_t blockCount = (section->elementCount + blockElements - 1) / blockElements;
+    size_t blockCapacity = Lz::bound(static_cast<size_t>(blockElements) * section->elementSize);
+
+    std::vector<uint8_t> blocks(blockCapacity * blockCount);
+    std::vector<uint32_t> blockSizes(blockCount);
+
+    uint32_t threadCount = Parallel::threadCount();
+    if (threadCount > blockCount) {
+        threadCount = blockCount;
+    }
+
+    if (threadCount > 0) {
+        Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+            std::vector<uint8_t> shuffled(static_cast<size_t>(blockElements) * section->elementSize);
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(blockCount) * thread / threadCount);
+            uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(blockCount) * (thread + 1) / threadCount);
+
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t first = i * blockElements;
+                uint32_t count = section->elementCount - first < blockElements ?
+                    section->elementCount - first : blockElements;
+                size_t rawSize = static_cast<size_t>(count) * section->elementSize;
+                const uint8_t *source = m_pending.data() + static_cast<size_t>(first) * section->elementSize;
+                uint8_t *target = blocks.data() + blockCapacity * i;
+
+                shuffle(source, shuffled.data(), count, section->elementSize);
+                size_t size = Lz::compress(shuffled.data(), rawSize, target, blockCapacity);
+
+                /*
+                    Keep incompressible blocks as they are
+                */
+                if (size == 0 || size >= rawSize) {
+                    std::memcpy(target, source, rawSize);
+                    blockSizes[i] = static_cast<uint32_t>(rawSize) | BlockStored;
+                } else {
+                    blockSizes[i] = static_cast<uint32_t>(size);
+                }
+            }
+        });
+    }
+
+    std::vector<Block> blockTable(blockCount);
+
+    for (uint32_t i = 0; i < blockCount; i++) {
+        if (!Interface::getCurrentOffset(&blockTable[i].offset)) {
+            return false;
+        }
+
+        blockTable[i].size = blockSizes[i];
+
+        if (!Interface::write(blocks.data() + blockCapacity * i, blockSizes[i] & ~BlockStored)) {
+            return false;
+        }
+    }
+
+    if (!Interface::getCurrentOffset(&section->blockTableOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(blockTable.data(), sizeof(Block) * blockCount)) {
+        return false;
+    }
+
+    section->blockCount = blockCount;
+    m_pending.clear();
+    m_pending.shrink_to_fit();
+
+    return true;
+}
+
+bool Compressed::readSection(const Section &section, void *data)
+{
+    /*
+        Block count follows from the element count, anything else is a damaged table
+    */
+    uint32_t blockElements = blockElementCount(section);
+    uint64_t expectedBlockCount = (static_cast<uint64_t>(section.elementCount) + blockElements - 1) /
+        blockElements;
+
+    if (section.blockCount != expectedBlockCount) {
+        return false;
+    }
+
+    if (section.blockCount == 0) {
+        return true;
+    }
+
+    uint32_t fileSize;
+
+    if (!Interface::getSize(&fileSize) || section.blockTableOffset > fileSize ||
+        static_cast<uint64_t>(section.blockCount) * sizeof(Block) > fileSize - section.blockTableOffset) {
+        return false;
+    }
+
+    std::vector<Block> blockTable(section.blockCount);
+
+    if (!Interface::setCurrentOffset(section.blockTableOffset)) {
+        return false;
+    }
+
+    if (!Interface::read(blockTable.data(), sizeof(Block) * section.blockCount)) {
+        return false;
+    }
+
+    /*
+        Blocks are stored back to back, so the whole section is one read,
+        every block has to lie inside it
+    */
+    uint64_t first = blockTable.front().offset;
+    uint64_t last = static_cast<uint64_t>(blockTable.back().offset) + (blockTable.back().size & ~BlockStored);
+
+    if (last < first || last > fileSize) {
+        return false;
+    }
+
+    for (const Block &block : blockTable) {
+        if (block.offset < first || block.offset + static_cast<uint64_t>(block.size & ~BlockStored) > last) {
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> compressed(static_cast<size_t>(last - first));
+
+    if (!Interface::setCurrentOffset(static_cast<uint32_t>(first))) {
+        return false;
+    }
+
+    if (!Interface::read(compressed.data(), compressed.size())) {
+        return false;
+    }
+
+    uint32_t threadCount = Parallel::threadCount();
+    if (threadCount > section.blockCount) {
+        threadCount = section.blockCount;
+    }
+
+    std::vector<uint8_t> threadResults(threadCount, 1);
+    uint8_t *target = reinterpret_cast<uint8_t *>(data);
+
+    Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+        std::vector<uint8_t> shuffled(static_cast<size_t>(blockElements) * section.elementSize);
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(section.blockCount) * thread / threadCount);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(section.blockCount) * (thread + 1) / threadCount);
+
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t firstElement = i * blockElements;
+            uint32_t count = section.elementCount - firstElement < blockElements ?
+                section.elementCount - firstElement : blockElements;
+            size_t rawSize = static_cast<size_t>(count) * section.elementSize;
+            uint32_t size = blockTable[i].size & ~BlockStored;
+            uint8_t *output = target + static_cast<size_t>(firstElement) * section.elementSize;
+
+            const uint8_t *input = compressed.data() + (blockTable[i].offset - first);
+
+            if (blockTable[i].size & BlockStored) {
+                if (size != rawSize) {
+                    threadResults[thread] = 0;
+                    return;
+                }
+
+                std::memcpy(output, input, rawSize);
+                continue;
+            }
+
+            if (!Lz::decompress(input, size, shuffled.data(), rawSize)) {
+                threadResults[thread] = 0;
+                return;
+            }
+
+            unshuffle(shuffled.data(), output, count, section.elementSize);
+        }
+    });
+
+    for (uint8_t threadResult : threadResults) {
+        if (threadResult == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Compressed::open(const std::string &filename, Interface::Mode mode)
+{
+    Compressed::close();
+
+    if (!Interface::open(filename, mode)) {
+        return false;
+    }
+
+    if (mode == Interface::Write) {
+        m_header.signature = Signature;
+        m_header.version = Version;
+        m_header.headerSize = sizeof(Header);
+        m_header.blockSize = BlockSize;
+        return true;
+    }
+
+    if (!Interface::read(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    if (m_header.signature != Signature || m_header.version != Version ||
+        m_header.headerSize != sizeof(Header) || m_header.blockSize == 0) {
+        return false;
+    }
+
+    if (!createFormat(m_header.sourceVersion) || m_header.sourceHeaderSize != m_format->headerSize()) {
+        return false;
+    }
+
+    m_format->setHeader(m_header.sourceHeader);
+
+    if (m_header.faces.elementSize != m_format->faceSize() ||
+        m_header.vertices.elementSize != m_format->vertexSize()) {
+        return false;
+    }
+
+    return true;
+}
+
+void Compressed::close()
+{
+    Interface::close();
+
+    if (m_format != nullptr) {
+        delete m_format;
+        m_format = nullptr;
+    }
+
+    m_pending.clear();
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+uint32_t Compressed::version() const
+{
+    if (!Interface::isOpen()) {
+        return false;
+    }
+
+    return m_header.version;
+}
+
+void Compressed::setVersion(uint32_t version)
+{
+    m_header.version = version;
+}
+
+uint32_t Compressed::flags() const
+{
+    if (m_format == nullptr) {
+        return 0;
+    }
+
+    return m_format->flags();
+}
+
+void Compressed::setFlags(uint32_t flags)
+{
+    if (m_format != nullptr) {
+        m_format->setFlags(flags);
+    }
+}
+
+uint32_t Compressed::headerSize() const
+{
+    return m_header.sourceHeaderSize;
+}
+
+const void *Compressed::header() const
+{
+    /*
+        Expose the wrapped header so the mesh can be written back uncompressed
+    */
+    if (m_format == nullptr) {
+        return nullptr;
+    }
+
+    return m_format->header();
+}
+
+void Compressed::setHeader(const void *header)
+{
+    uint32_t version = reinterpret_cast<const uint32_t *>(header)[1];
+
+    if (!createFormat(version)) {
+        return;
+    }
+
+    m_format->setHeader(header);
+
+    m_header.materialDataOffset = 0;
+    m_header.materialDataEnd = 0;
+    std::memset(&m_header.faces, 0, sizeof(Section));
+    std::memset(&m_header.vertices, 0, sizeof(Section));
+}
+
+uint32_t Compressed::faceCount() const
+{
+    return m_header.faces.elementCount;
+}
+
+uint32_t Compressed::faceSize() const
+{
+    return m_format->faceSize();
+}
+
+uint16_t Compressed::faceMaterialIndex(const void *faceData, uint32_t faceIndex) const
+{
+    return m_format->faceMaterialIndex(faceData, faceIndex);
+}
+
+int32_t Compressed::faceLightmapGroup(const void *faceData, uint32_t faceIndex) const
+{
+    return m_format->faceLightmapGroup(faceData, faceIndex);
+}
+
+void Compressed::faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    float *lightmapCoord) const
+{
+    m_format->faceLightmapCoord(faceData, faceIndex, vertexIndex, lightmapCoord);
+}
+
+uint32_t Compressed::faceVertexIndex(const void *faceData, uint32_t faceIndex,
+    uint32_t vertexIndex) const
+{
+    return m_format->faceVertexIndex(faceData, faceIndex, vertexIndex);
+}
+
+void Compressed::setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    uint32_t index) const
+{
+    m_format->setFaceVertexIndex(faceData, faceIndex, vertexIndex, index);
+}
+
+uint32_t Compressed::vertexCount() const
+{
+    return m_header.vertices.elementCount;
+}
+
+void Compressed::setVertexCount(uint32_t vertexCount)
+{
+    m_header.vertices.elementCount = vertexCount;
+}
+
+uint32_t Compressed::vertexSize() const
+{
+    return m_format->vertexSize();
+}
+
+void Compressed::vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const
+{
+    m_format->vertex(faceData, faceIndex, vertexData, vertexIndex, position, textureCoord, normal);
+}
+
+void Compressed::vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, uint8_t *color) const
+{
+    m_format->vertexColor(faceData, faceIndex, vertexData, vertexIndex, color);
+}
+
+void Compressed::vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const
+{
+    m_format->vertexPosition(vertexData, vertexIndex, position);
+}
+
+void Compressed::vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const
+{
+    m_format->vertexNormal(vertexData, vertexIndex, normal);
+}
+
+bool Compressed::beginWriteMaterials()
+{
+    if (!Interface::getCurrentOffset(&m_header.materialDataOffset)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Compressed::writeMaterial(const std::string &name)
+{
+    if (!Interface::write(name.c_str(), name.size())) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Compressed::endWriteMaterials()
+{
+    if (!Interface::write("\0", 1)) {
+        return false;
+    }
+
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    if (m_header.materialDataOffset > currentOffset) {
+        return false;
+    }
+
+    m_header.materialDataEnd = currentOffset;
+
+    return true;
+}
+
+bool Compressed::readMaterials(std::vector<std::string> *materials)
+{
+    materials->clear();
+
+    if (!Interface::setCurrentOffset(m_header.materialDataOffset)) {
+        return false;
+    }
+
+    std::string material;
+
+    while (true) {
+        char c;
+        if (!Interface::read(&c, sizeof(char))) {
+            return false;
+        }
+
+        if (c == ' ') {
+            if (!material.empty()) {
+                materials->push_back(material);
+                material.clear();
+            }
+
+            continue;
+        }
+
+        if (c == '\0') {
+            break;
+        }
+
+        material.push_back(c);
+    }
+
+    return true;
+}
+
+bool Compressed::beginWriteFaces()
+{
+    if (m_format == nullptr) {
+        return false;
+    }
+
+    m_pending.clear();
+    m_header.faces.elementSize = m_format->faceSize();
+    m_header.faces.elementCount = 0;
+
+    return true;
+}
+
+bool Compressed::writeFace(void *face)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(face);
+    m_pending.insert(m_pending.end(), data, data + m_header.faces.elementSize);
+
+    return true;
+}
+
+bool Compressed::endWriteFaces()
+{
+    return writeSection(&m_header.faces);
+}
+
+bool Compressed::readFaces(void *faces)
+{
+    return readSection(m_header.faces, faces);
+}
+
+bool Compressed::beginWriteVertices()
+{
+    if (m_format == nullptr) {
+        return false;
+    }
+
+    m_pending.clear();
+    m_header.vertices.elementSize = m_format->vertexSize();
+    m_header.vertices.elementCount = 0;
+
+    return true;
+}
+
+bool Compressed::writeVertex(void *vertex)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(vertex);
+    m_pending.insert(m_pending.end(), data, data + m_header.vertices.elementSize);
+
+    return true;
+}
+
+bool Compressed::endWriteVertices()
+{
+    return writeSection(&m_header.vertices);
+}
+
+bool Compressed::readVertices(void *vertices)
+{
+    return readSection(m_header.vertices, vertices);
+}
+
+bool Compressed::writeHeader()
+{
+    if (m_format == nullptr) {
+        return false;
+    }
+
+    std::memcpy(m_header.sourceHeader, m_format->header(), m_header.sourceHeaderSize);
+
+    if (!Interface::setCurrentOffset(0)) {
+        return false;
+    }
+
+    if (!Interface::write(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t Compressed::sourceVersion() const
+{
+    return m_header.sourceVersion;
+}
+
+} // namespace CompiledStaticMesh
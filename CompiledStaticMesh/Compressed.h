@@ -0,0 +1,115 @@
+#ifndef COMPILEDSTATICMESH_COMPRESSED_H
+#define COMPILEDSTATICMESH_COMPRESSED_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Interface.h"
+
+namespace CompiledStaticMesh {
+
+/*
+    Container for Version2/Version3 meshes with faces and vertices split into
+    independently compressed blocks. Blocks are byte shuffled by record size
+    before compression so matching fields of neighbouring records line up.
+*/
+class Compressed: public Interface
+{
+
+public:
+    static constexpr const uint32_t Version = 32;
+    static constexpr const uint32_t Signature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'Z';
+    static constexpr const uint32_t BlockSize = 256 * 1024;
+    static constexpr const uint32_t BlockStored = 0x80000000;
+    static constexpr const uint32_t MaxSourceHeaderSize = 2048;
+
+    struct Block {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct Section {
+        uint32_t blockTableOffset;
+        uint32_t blockCount;
+        uint32_t elementSize;
+        uint32_t elementCount;
+    };
+
+    struct Header {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t blockSize;
+        uint32_t sourceVersion;
+        uint32_t sourceHeaderSize;
+        uint32_t materialDataOffset;
+        uint32_t materialDataEnd;
+        Section faces;
+        Section vertices;
+        uint8_t sourceHeader[MaxSourceHeaderSize];
+    };
+
+private:
+    Header m_header;
+    Interface *m_format;
+    std::vector<uint8_t> m_pending;
+
+    bool createFormat(uint32_t version);
+    uint32_t blockElementCount(const Section &section) const;
+    bool writeSection(Section *section);
+    bool readSection(const Section &section, void *data);
+    static void shuffle(const uint8_t *source, uint8_t *target, uint32_t count, uint32_t elementSize);
+    static void unshuffle(const uint8_t *source, uint8_t *target, uint32_t count, uint32_t elementSize);
+
+public:
+    Compressed();
+    ~Compressed() override;
+    bool open(const std::string &filename, Interface::Mode mode) override;
+    void close() override;
+    uint32_t version() const override;
+    void setVersion(uint32_t version) override;
+    uint32_t flags() const override;
+    void setFlags(uint32_t flags) override;
+    uint32_t headerSize() const override;
+    const void *header() const override;
+    void setHeader(const void *header) override;
+    uint32_t faceCount() const override;
+    uint32_t faceSize() const override;
+    uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const override;
+    int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const override;
+    void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const override;
+    uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const override;
+    void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const override;
+    uint32_t vertexCount() const override;
+    void setVertexCount(uint32_t vertexCount) override;
+    uint32_t vertexSize() const override;
+    void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const override;
+    void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const override;
+    void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const override;
+    void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const override;
+    bool beginWriteMaterials() override;
+    bool writeMaterial(const std::string &name) override;
+    bool endWriteMaterials() override;
+    bool readMaterials(std::vector<std::string> *materials) override;
+    bool beginWriteFaces() override;
+    bool writeFace(void *face) override;
+    bool endWriteFaces() override;
+    bool readFaces(void *faces) override;
+    bool beginWriteVertices() override;
+    bool writeVertex(void *vertex) override;
+    bool endWriteVertices() override;
+    bool readVertices(void *vertices) override;
+    bool writeHeader() override;
+    uint32_t sourceVersion() const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_COMPRESSED_H
@@ -0,0 +1,220 @@
+#include <cstring>
+#include <vector>
+#include "Crc32c.h"
+#include "Parallel.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE
+#define CRC32C_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#endif
+
+namespace CompiledStaticMesh {
+
+bool Crc32c::hardwareSupported()
+{
+#if defined(CRC32C_HARDWARE)
+    static const bool supported = []() {
+        /*
+            SSE4.2 is reported in bit 20 of ECX for leaf 1
+        */
+#if defined(_MSC_VER)
+        int registers[4];
+        __cpuid(registers, 1);
+        return (registers[2] & (1 << 20)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+
+        return (ecx & (1 << 20)) != 0;
+#endif
+    }();
+
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint32_t Crc32c::updateSoftware(uint32_t crc, const uint8_t *data, size_t size)
+{
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> result(256);
+
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+
+            for (uint32_t j = 0; j < 8; j++) {
+                value = (value >> 1) ^ (Polynomial & (0u - (value & 1)));
+            }
+
+            result[i] = value;
+        }
+
+        return result;
+    }();
+
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+#if defined(CRC32C_HARDWARE)
+CRC32C_TARGET uint32_t Crc32c::updateHardware(uint32_t crc, const uint8_t *data, size_t size)
+{
+    size_t offset = 0;
+
+#if defined(_M_X64) || defined(__x86_64__)
+    uint64_t value = crc;
+
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        value = _mm_crc32_u64(value, word);
+    }
+
+    crc = static_cast<uint32_t>(value);
+#else
+    for (; offset + sizeof(uint32_t) <= size; offset += sizeof(uint32_t)) {
+        uint32_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+#endif
+
+    for (; offset < size; offset++) {
+        crc = _mm_crc32_u8(crc, data[offset]);
+    }
+
+    return crc;
+}
+#else
+uint32_t Crc32c::updateHardware(uint32_t crc, const uint8_t *data, size_t size)
+{
+    return updateSoftware(crc, data, size);
+}
+#endif
+
+uint32_t Crc32c::update(uint32_t crc, const void *data, size_t size)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+
+    if (hardwareSupported()) {
+        return ~updateHardware(~crc, bytes, size);
+    }
+
+    return ~updateSoftware(~crc, bytes, size);
+}
+
+uint32_t Crc32c::multiply(const uint32_t *matrix, uint32_t vector)
+{
+    uint32_t value = 0;
+
+    for (uint32_t i = 0; vector != 0; i++, vector >>= 1) {
+        if (vector & 1) {
+            value ^= matrix[i];
+        }
+    }
+
+    return value;
+}
+
+void Crc32c::square(uint32_t *square, const uint32_t *matrix)
+{
+    for (uint32_t i = 0; i < 32; i++) {
+        square[i] = multiply(matrix, matrix[i]);
+    }
+}
+
+uint32_t Crc32c::combine(uint32_t first, uint32_t second, size_t secondSize)
+{
+    if (secondSize == 0) {
+        return first;
+    }
+
+    /*
+        Advance the first CRC over secondSize zero bytes by repeated squaring
+        of the one-bit shift operator, then fold in the second CRC
+    */
+    uint32_t even[32];
+    uint32_t odd[32];
+
+    odd[0] = Polynomial;
+    for (uint32_t i = 1; i < 32; i++) {
+        odd[i] = 1u << (i - 1);
+    }
+
+    square(even, odd);
+    square(odd, even);
+
+    do {
+        square(even, odd);
+        if (secondSize & 1) {
+            first = multiply(even, first);
+        }
+
+        secondSize >>= 1;
+        if (secondSize == 0) {
+            break;
+        }
+
+        square(odd, even);
+        if (secondSize & 1) {
+            first = multiply(odd, first);
+        }
+
+        secondSize >>= 1;
+    } while (secondSize != 0);
+
+    return first ^ second;
+}
+
+uint32_t Crc32c::compute(const void *data, size_t size)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    uint32_t blockCount = static_cast<uint32_t>((size + BlockSize - 1) / BlockSize);
+
+    uint32_t threadCount = Parallel::threadCount();
+    if (threadCount > blockCount) {
+        threadCount = blockCount;
+    }
+
+    if (threadCount < 2) {
+        return update(0, bytes, size);
+    }
+
+    std::vector<uint32_t> blocks(blockCount);
+
+    Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(blockCount) * thread / threadCount);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(blockCount) * (thread + 1) / threadCount);
+
+        for (uint32_t i = begin; i < end; i++) {
+            size_t offset = static_cast<size_t>(i) * BlockSize;
+            size_t blockSize = size - offset < BlockSize ? size - offset : BlockSize;
+            blocks[i] = update(0, bytes + offset, blockSize);
+        }
+    });
+
+    uint32_t value = blocks[0];
+
+    for (uint32_t i = 1; i < blockCount; i++) {
+        size_t offset = static_cast<size_t>(i) * BlockSize;
+        size_t blockSize = size - offset < BlockSize ? size - offset : BlockSize;
+        value = combine(value, blocks[i], blockSize);
+    }
+
+    return value;
+}
+
+} // namespace CompiledStaticMesh
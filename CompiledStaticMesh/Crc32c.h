@@ -0,0 +1,36 @@
+#ifndef COMPILEDSTATICMESH_CRC32C_H
+#define COMPILEDSTATICMESH_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CompiledStaticMesh {
+
+class Crc32c
+{
+
+public:
+    /*
+        Large buffers are split into blocks checked on all threads, the block
+        values are then combined in order into the CRC of the whole buffer
+    */
+    static constexpr const size_t BlockSize = 1 << 20;
+    static constexpr const uint32_t Polynomial = 0x82f63b78;
+
+private:
+    static bool hardwareSupported();
+    static uint32_t updateSoftware(uint32_t crc, const uint8_t *data, size_t size);
+    static uint32_t updateHardware(uint32_t crc, const uint8_t *data, size_t size);
+    static uint32_t multiply(const uint32_t *matrix, uint32_t vector);
+    static void square(uint32_t *square, const uint32_t *matrix);
+
+public:
+    static uint32_t update(uint32_t crc, const void *data, size_t size);
+    static uint32_t combine(uint32_t first, uint32_t second, size_t secondSize);
+    static uint32_t compute(const void *data, size_t size);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_CRC32C_H
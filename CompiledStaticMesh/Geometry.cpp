@@ -0,0 +1,782 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Geometry.h"
+
+namespace CompiledStaticMesh {
+
+Geometry::Geometry() :
+    Interface(),
+    m_mappedData(nullptr),
+    m_mappedSize(0)
+{
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+Geometry::~Geometry()
+{
+    Geometry::close();
+}
+
+bool Geometry::align()
+{
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    static const uint8_t padding[SectionAlignment] = {};
+    uint32_t remainder = currentOffset % SectionAlignment;
+
+    if (remainder != 0) {
+        if (!Interface::write(padding, SectionAlignment - remainder)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Geometry::validSection(uint32_t offset, uint64_t size) const
+{
+    if (offset % sizeof(uint32_t) != 0) {
+        return false;
+    }
+
+    if (static_cast<uint64_t>(offset) + size > m_mappedSize) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::validAttribute(const Attribute &attribute) const
+{
+    static const uint32_t componentCounts[ColorSemantic + 1] = {3, 3, 2, 3, 3, 2, 4};
+    static const uint32_t componentSizes[U16Type + 1] = {4, 4, 2};
+
+    if (attribute.semantic > ColorSemantic || attribute.componentType > U16Type) {
+        return false;
+    }
+
+    uint64_t size = static_cast<uint64_t>(componentCounts[attribute.semantic]) *
+        componentSizes[attribute.componentType];
+
+    if (static_cast<uint64_t>(attribute.offset) + size > m_header.stride) {
+        return false;
+    }
+
+    return true;
+}
+
+const Geometry::Attribute *Geometry::findAttribute(Semantic semantic) const
+{
+    for (uint32_t i = 0; i < m_header.attributeCount; i++) {
+        if (m_header.attributes[i].semantic == static_cast<uint32_t>(semantic)) {
+            return &m_header.attributes[i];
+        }
+    }
+
+    return nullptr;
+}
+
+void Geometry::readAttribute(const uint8_t *vertex, Semantic semantic, uint32_t count, float *data) const
+{
+    const Attribute *attribute = findAttribute(semantic);
+
+    if (attribute == nullptr || attribute->componentType != F32Type) {
+        std::memset(data, 0, sizeof(float) * count);
+        return;
+    }
+
+    std::memcpy(data, vertex + attribute->offset, sizeof(float) * count);
+}
+
+const Geometry::Subset *Geometry::findSubset(uint32_t faceIndex) const
+{
+    const Subset *subset = subsets();
+    uint32_t index = faceIndex * 3;
+    uint32_t begin = 0;
+    uint32_t end = m_header.subsetCount;
+
+    while (begin < end) {
+        uint32_t middle = begin + (end - begin) / 2;
+
+        if (index < subset[middle].offset) {
+            end = middle;
+        } else if (index >= subset[middle].offset + subset[middle].count) {
+            begin = middle + 1;
+        } else {
+            return &subset[middle];
+        }
+    }
+
+    return nullptr;
+}
+
+bool Geometry::open(const std::string &filename, Interface::Mode mode)
+{
+    Geometry::close();
+
+    if (!Interface::open(filename, mode)) {
+        return false;
+    }
+
+    if (mode == Interface::Write) {
+        m_header.signature = Signature;
+        m_header.version = Version;
+        m_header.headerSize = sizeof(Header);
+        return true;
+    }
+
+    /*
+        Sections are used in place from the mapping, or from the memory of a pack member
+    */
+    if (Interface::memory() != nullptr) {
+        m_mappedData = Interface::memory();
+        m_mappedSize = Interface::memorySize();
+    } else {
+        if (!m_mappedFile.open(filename)) {
+            return false;
+        }
+
+        m_mappedData = m_mappedFile.data();
+        m_mappedSize = m_mappedFile.size();
+    }
+
+    if (m_mappedSize < sizeof(Header)) {
+        return false;
+    }
+
+    std::memcpy(&m_header, m_mappedData, sizeof(Header));
+
+    if (m_header.signature != Signature || m_header.version != Version ||
+        m_header.headerSize != sizeof(Header)) {
+        return false;
+    }
+
+    if (m_header.attributeCount > MaxAttributes || m_header.indexCount % 3 != 0 ||
+        m_header.materialDataEnd < m_header.materialDataOffset) {
+        return false;
+    }
+
+    if (!validSection(m_header.materialDataOffset, m_header.materialDataEnd - m_header.materialDataOffset) ||
+        !validSection(m_header.subsetDataOffset, static_cast<uint64_t>(m_header.subsetCount) * sizeof(Subset)) ||
+        !validSection(m_header.vertexDataOffset, static_cast<uint64_t>(m_header.vertexCount) * m_header.stride) ||
+        !validSection(m_header.indexDataOffset, static_cast<uint64_t>(m_header.indexCount) * sizeof(uint32_t)) ||
+        !validSection(m_header.normalDataOffset, static_cast<uint64_t>(m_header.normalVertexCount) * sizeof(Vector3)) ||
+        !validSection(m_header.gridDataOffset, static_cast<uint64_t>(m_header.gridVertexCount) * sizeof(Vector3))) {
+        return false;
+    }
+
+    /*
+        Attributes are read in place from each vertex, none may reach into the next one
+    */
+    for (uint32_t i = 0; i < m_header.attributeCount; i++) {
+        if (!validAttribute(m_header.attributes[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Geometry::close()
+{
+    Interface::close();
+    m_mappedFile.close();
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+uint32_t Geometry::version() const
+{
+    if (!Interface::isOpen()) {
+        return false;
+    }
+
+    return m_header.version;
+}
+
+void Geometry::setVersion(uint32_t version)
+{
+    m_header.version = version;
+}
+
+uint32_t Geometry::flags() const
+{
+    return m_header.flags;
+}
+
+void Geometry::setFlags(uint32_t flags)
+{
+    m_header.flags = flags;
+}
+
+uint32_t Geometry::headerSize() const
+{
+    return sizeof(Header);
+}
+
+const void *Geometry::header() const
+{
+    return &m_header;
+}
+
+void Geometry::setHeader(const void *header)
+{
+    std::memcpy(&m_header, header, sizeof(Header));
+
+    /*
+        Section layout belongs to the file being written
+    */
+    m_header.materialDataOffset = 0;
+    m_header.materialDataEnd = 0;
+    m_header.subsetDataOffset = 0;
+    m_header.subsetCount = 0;
+    m_header.vertexDataOffset = 0;
+    m_header.vertexCount = 0;
+    m_header.indexDataOffset = 0;
+    m_header.indexCount = 0;
+    m_header.normalDataOffset = 0;
+    m_header.normalVertexCount = 0;
+    m_header.gridDataOffset = 0;
+    m_header.gridVertexCount = 0;
+}
+
+uint32_t Geometry::faceCount() const
+{
+    return m_header.indexCount / 3;
+}
+
+uint32_t Geometry::faceSize() const
+{
+    return sizeof(Face);
+}
+
+uint16_t Geometry::faceMaterialIndex(const void *faceData, uint32_t faceIndex) const
+{
+    (void)faceData;
+
+    const Subset *subset = findSubset(faceIndex);
+    if (subset == nullptr) {
+        return 0;
+    }
+
+    return static_cast<uint16_t>(subset->material);
+}
+
+int32_t Geometry::faceLightmapGroup(const void *faceData, uint32_t faceIndex) const
+{
+    (void)faceData;
+
+    const Subset *subset = findSubset(faceIndex);
+    if (subset == nullptr) {
+        return -1;
+    }
+
+    return subset->lightmapGroup;
+}
+
+void Geometry::faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    float *lightmapCoord) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    const uint8_t *vertex = reinterpret_cast<const uint8_t *>(vertexData()) +
+        static_cast<size_t>(face->index[vertexIndex]) * m_header.stride;
+
+    readAttribute(vertex, LightmapCoordSemantic, 2, lightmapCoord);
+}
+
+uint32_t Geometry::faceVertexIndex(const void *faceData, uint32_t faceIndex,
+    uint32_t vertexIndex) const
+{
+    return reinterpret_cast<const Face *>(faceData)[faceIndex].index[vertexIndex];
+}
+
+void Geometry::setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    uint32_t index) const
+{
+    reinterpret_cast<Face *>(faceData)[faceIndex].index[vertexIndex] = index;
+}
+
+uint32_t Geometry::vertexCount() const
+{
+    return m_header.vertexCount;
+}
+
+void Geometry::setVertexCount(uint32_t vertexCount)
+{
+    m_header.vertexCount = vertexCount;
+}
+
+uint32_t Geometry::vertexSize() const
+{
+    return m_header.stride;
+}
+
+void Geometry::vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    const uint8_t *vertex = reinterpret_cast<const uint8_t *>(vertexData) +
+        static_cast<size_t>(face->index[vertexIndex]) * m_header.stride;
+
+    /*
+        Stored vertices are already in render space
+    */
+    readAttribute(vertex, PositionSemantic, 3, position);
+    readAttribute(vertex, TextureCoordSemantic, 2, textureCoord);
+    readAttribute(vertex, NormalSemantic, 3, normal);
+}
+
+void Geometry::vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, uint8_t *color) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    const uint8_t *vertex = reinterpret_cast<const uint8_t *>(vertexData) +
+        static_cast<size_t>(face->index[vertexIndex]) * m_header.stride;
+    const Attribute *attribute = findAttribute(ColorSemantic);
+
+    if (attribute == nullptr || attribute->componentType != F32Type) {
+        std::memset(color, 255, 4);
+        return;
+    }
+
+    float data[4];
+    readAttribute(vertex, ColorSemantic, 4, data);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        color[i] = static_cast<uint8_t>(std::lround(std::min(std::max(data[i], 0.0f), 1.0f) * 255.0f));
+    }
+}
+
+void Geometry::vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const
+{
+    const uint8_t *vertex = reinterpret_cast<const uint8_t *>(vertexData) +
+        static_cast<size_t>(vertexIndex) * m_header.stride;
+
+    float data[3];
+    readAttribute(vertex, PositionSemantic, 3, data);
+    position[0] = data[0];
+    position[1] = data[2];
+    position[2] = data[1];
+}
+
+void Geometry::vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const
+{
+    const uint8_t *vertex = reinterpret_cast<const uint8_t *>(vertexData) +
+        static_cast<size_t>(vertexIndex) * m_header.stride;
+
+    float data[3];
+    readAttribute(vertex, NormalSemantic, 3, data);
+    normal[0] = data[0];
+    normal[1] = data[2];
+    normal[2] = data[1];
+}
+
+bool Geometry::beginWriteMaterials()
+{
+    if (!align()) {
+        return false;
+    }
+
+    if (!Interface::getCurrentOffset(&m_header.materialDataOffset)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::writeMaterial(const std::string &name)
+{
+    if (!Interface::write(name.c_str(), name.size())) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::endWriteMaterials()
+{
+    if (!Interface::write("\0", 1)) {
+        return false;
+    }
+
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    if (m_header.materialDataOffset > currentOffset) {
+        return false;
+    }
+
+    m_header.materialDataEnd = currentOffset;
+
+    return true;
+}
+
+bool Geometry::readMaterials(std::vector<std::string> *materials)
+{
+    materials->clear();
+
+    if (m_mappedData == nullptr) {
+        return false;
+    }
+
+    const char *data = reinterpret_cast<const char *>(m_mappedData);
+    std::string material;
+
+    for (uint32_t i = m_header.materialDataOffset; i < m_header.materialDataEnd; i++) {
+        char c = data[i];
+
+        if (c == ' ') {
+            if (!material.empty()) {
+                materials->push_back(material);
+                material.clear();
+            }
+
+            continue;
+        }
+
+        if (c == '\0') {
+            return true;
+        }
+
+        material.push_back(c);
+    }
+
+    return false;
+}
+
+bool Geometry::beginWriteFaces()
+{
+    m_header.indexCount = 0;
+
+    if (!align()) {
+        return false;
+    }
+
+    if (!Interface::getCurrentOffset(&m_header.indexDataOffset)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::writeFace(void *face)
+{
+    if (!Interface::isOpen()) {
+        return false;
+    }
+
+    m_header.indexCount += 3;
+
+    if (!Interface::write(face, sizeof(Face))) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::endWriteFaces()
+{
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    if (m_header.indexDataOffset > currentOffset) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::readFaces(void *faces)
+{
+    if (m_mappedData == nullptr) {
+        return false;
+    }
+
+    std::memcpy(faces, m_mappedData + m_header.indexDataOffset,
+        sizeof(uint32_t) * m_header.indexCount);
+
+    return true;
+}
+
+bool Geometry::beginWriteVertices()
+{
+    m_header.vertexCount = 0;
+
+    if (!align()) {
+        return false;
+    }
+
+    if (!Interface::getCurrentOffset(&m_header.vertexDataOffset)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::writeVertex(void *vertex)
+{
+    m_header.vertexCount++;
+
+    if (!Interface::write(vertex, m_header.stride)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::endWriteVertices()
+{
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    if (m_header.vertexDataOffset > currentOffset) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Geometry::readVertices(void *vertices)
+{
+    if (m_mappedData == nullptr) {
+        return false;
+    }
+
+    std::memcpy(vertices, m_mappedData + m_header.vertexDataOffset,
+        static_cast<size_t>(m_header.vertexCount) * m_header.stride);
+
+    return true;
+}
+
+bool Geometry::writeHeader()
+{
+    if (!Interface::setCurrentOffset(0)) {
+        return false;
+    }
+
+    if (!Interface::write(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t Geometry::sourceVersion() const
+{
+    return m_header.sourceVersion;
+}
+
+void Geometry::setSourceVersion(uint32_t sourceVersion)
+{
+    m_header.sourceVersion = sourceVersion;
+}
+
+uint32_t Geometry::buildFlags() const
+{
+    return m_header.buildFlags;
+}
+
+void Geometry::setBuildFlags(uint32_t buildFlags)
+{
+    m_header.buildFlags = buildFlags;
+}
+
+const Geometry::SourceStamp &Geometry::sourceStamp() const
+{
+    return m_header.sourceStamp;
+}
+
+void Geometry::setSourceStamp(const SourceStamp &sourceStamp)
+{
+    m_header.sourceStamp = sourceStamp;
+}
+
+void Geometry::boundingBox(float *min, float *max) const
+{
+    std::memcpy(min, &m_header.boundingBox.min, sizeof(Vector3));
+    std::memcpy(max, &m_header.boundingBox.max, sizeof(Vector3));
+}
+
+void Geometry::setBoundingBox(const float *min, const float *max)
+{
+    std::memcpy(&m_header.boundingBox.min, min, sizeof(Vector3));
+    std::memcpy(&m_header.boundingBox.max, max, sizeof(Vector3));
+}
+
+uint32_t Geometry::stride() const
+{
+    return m_header.stride;
+}
+
+uint32_t Geometry::attributeCount() const
+{
+    return m_header.attributeCount;
+}
+
+const Geometry::Attribute &Geometry::attribute(uint32_t index) const
+{
+    return m_header.attributes[index];
+}
+
+bool Geometry::setAttributes(const Attribute *attributes, uint32_t count, uint32_t stride)
+{
+    if (count > MaxAttributes) {
+        return false;
+    }
+
+    std::memset(m_header.attributes, 0, sizeof(m_header.attributes));
+    std::memcpy(m_header.attributes, attributes, sizeof(Attribute) * count);
+    m_header.attributeCount = count;
+    m_header.stride = stride;
+
+    return true;
+}
+
+uint32_t Geometry::subsetCount() const
+{
+    return m_header.subsetCount;
+}
+
+const Geometry::Subset *Geometry::subsets() const
+{
+    return reinterpret_cast<const Subset *>(m_mappedData + m_header.subsetDataOffset);
+}
+
+bool Geometry::writeSubsets(const Subset *subsets, uint32_t count)
+{
+    if (!align()) {
+        return false;
+    }
+
+    if (!Interface::getCurrentOffset(&m_header.subsetDataOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(subsets, sizeof(Subset) * count)) {
+        return false;
+    }
+
+    m_header.subsetCount = count;
+
+    return true;
+}
+
+const void *Geometry::vertexData() const
+{
+    return m_mappedData + m_header.vertexDataOffset;
+}
+
+bool Geometry::writeVertexData(const void *vertices, uint32_t count)
+{
+    if (!beginWriteVertices()) {
+        return false;
+    }
+
+    if (!Interface::write(vertices, static_cast<size_t>(count) * m_header.stride)) {
+        return false;
+    }
+
+    m_header.vertexCount = count;
+
+    return endWriteVertices();
+}
+
+uint32_t Geometry::indexCount() const
+{
+    return m_header.indexCount;
+}
+
+const uint32_t *Geometry::indexData() const
+{
+    return reinterpret_cast<const uint32_t *>(m_mappedData + m_header.indexDataOffset);
+}
+
+bool Geometry::writeIndexData(const uint32_t *indices, uint32_t count)
+{
+    if (!beginWriteFaces()) {
+        return false;
+    }
+
+    if (!Interface::write(indices, sizeof(uint32_t) * count)) {
+        return false;
+    }
+
+    m_header.indexCount = count;
+
+    return endWriteFaces();
+}
+
+uint32_t Geometry::normalVertexCount() const
+{
+    return m_header.normalVertexCount;
+}
+
+const void *Geometry::normalData() const
+{
+    return m_mappedData + m_header.normalDataOffset;
+}
+
+bool Geometry::writeNormalData(const void *vertices, uint32_t count)
+{
+    if (!align()) {
+        return false;
+    }
+
+    if (!Interface::getCurrentOffset(&m_header.normalDataOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(vertices, sizeof(Vector3) * count)) {
+        return false;
+    }
+
+    m_header.normalVertexCount = count;
+
+    return true;
+}
+
+uint32_t Geometry::gridVertexCount() const
+{
+    return m_header.gridVertexCount;
+}
+
+const void *Geometry::gridData() const
+{
+    return m_mappedData + m_header.gridDataOffset;
+}
+
+bool Geometry::writeGridData(const void *vertices, uint32_t count)
+{
+    if (!align()) {
+        return false;
+    }
+
+    if (!Interface::getCurrentOffset(&m_header.gridDataOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(vertices, sizeof(Vector3) * count)) {
+        return false;
+    }
+
+    m_header.gridVertexCount = count;
+
+    return true;
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,198 @@
+#ifndef COMPILEDSTATICMESH_GEOMETRY_H
+#define COMPILEDSTATICMESH_GEOMETRY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Interface.h"
+#include "MappedFile.h"
+
+namespace CompiledStaticMesh {
+
+/*
+    Render-ready cache: interleaved vertices, 32-bit indices, subsets and overlays
+    stored exactly as uploaded, so reading only maps the file
+*/
+class Geometry: public Interface
+{
+
+public:
+    static constexpr const uint32_t Version = 19;
+    static constexpr const uint32_t Signature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'G';
+    static constexpr const uint32_t MaxAttributes = 8;
+    static constexpr const uint32_t SectionAlignment = 16;
+    static constexpr const uint32_t SubsetFlagsNone = 0x00000000;
+    static constexpr const uint32_t SubsetHasTangents = 0x00000001;
+    static constexpr const uint32_t BuildFlagsNone = 0x00000000;
+    static constexpr const uint32_t BuildWelded = 0x00000001;
+    static constexpr const uint32_t BuildNormalsRecomputed = 0x00000002;
+
+    enum Semantic {
+        PositionSemantic,
+        NormalSemantic,
+        TextureCoordSemantic,
+        TangentSemantic,
+        BinormalSemantic,
+        LightmapCoordSemantic,
+        ColorSemantic
+    };
+
+    enum ComponentType {
+        F32Type,
+        U32Type,
+        U16Type
+    };
+
+    struct Vector3 {
+        float x;
+        float y;
+        float z;
+    };
+
+    struct Face {
+        uint32_t index[3];
+    };
+
+    struct Attribute {
+        uint32_t semantic;
+        uint32_t offset;
+        uint32_t componentType;
+    };
+
+    struct SourceStamp {
+        uint64_t size;
+        int64_t time;
+        uint64_t hash;
+    };
+
+    struct Subset {
+        uint32_t material;
+        int32_t lightmapGroup;
+        uint32_t flags;
+        uint32_t offset;
+        uint32_t count;
+        Vector3 boundsMin;
+        Vector3 boundsMax;
+    };
+
+    struct Header {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t flags;
+        uint32_t sourceVersion;
+        uint32_t buildFlags;
+        SourceStamp sourceStamp;
+
+        struct {
+            Vector3 min;
+            Vector3 max;
+        } boundingBox;
+
+        uint32_t stride;
+        uint32_t attributeCount;
+        Attribute attributes[MaxAttributes];
+        uint32_t materialDataOffset;
+        uint32_t materialDataEnd;
+        uint32_t subsetDataOffset;
+        uint32_t subsetCount;
+        uint32_t vertexDataOffset;
+        uint32_t vertexCount;
+        uint32_t indexDataOffset;
+        uint32_t indexCount;
+        uint32_t normalDataOffset;
+        uint32_t normalVertexCount;
+        uint32_t gridDataOffset;
+        uint32_t gridVertexCount;
+    };
+
+private:
+    Header m_header;
+    MappedFile m_mappedFile;
+    const uint8_t *m_mappedData;
+    size_t m_mappedSize;
+
+    bool align();
+    bool validSection(uint32_t offset, uint64_t size) const;
+    bool validAttribute(const Attribute &attribute) const;
+    const Attribute *findAttribute(Semantic semantic) const;
+    const Subset *findSubset(uint32_t faceIndex) const;
+    void readAttribute(const uint8_t *vertex, Semantic semantic, uint32_t count, float *data) const;
+
+public:
+    Geometry();
+    ~Geometry() override;
+    bool open(const std::string &filename, Interface::Mode mode) override;
+    void close() override;
+    uint32_t version() const override;
+    void setVersion(uint32_t version) override;
+    uint32_t flags() const override;
+    void setFlags(uint32_t flags) override;
+    uint32_t headerSize() const override;
+    const void *header() const override;
+    void setHeader(const void *header) override;
+    uint32_t faceCount() const override;
+    uint32_t faceSize() const override;
+    uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const override;
+    int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const override;
+    void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const override;
+    uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const override;
+    void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const override;
+    uint32_t vertexCount() const override;
+    void setVertexCount(uint32_t vertexCount) override;
+    uint32_t vertexSize() const override;
+    void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const override;
+    void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const override;
+    void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const override;
+    void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const override;
+    bool beginWriteMaterials() override;
+    bool writeMaterial(const std::string &name) override;
+    bool endWriteMaterials() override;
+    bool readMaterials(std::vector<std::string> *materials) override;
+    bool beginWriteFaces() override;
+    bool writeFace(void *face) override;
+    bool endWriteFaces() override;
+    bool readFaces(void *faces) override;
+    bool beginWriteVertices() override;
+    bool writeVertex(void *vertex) override;
+    bool endWriteVertices() override;
+    bool readVertices(void *vertices) override;
+    bool writeHeader() override;
+    uint32_t sourceVersion() const;
+    void setSourceVersion(uint32_t sourceVersion);
+    uint32_t buildFlags() const;
+    void setBuildFlags(uint32_t buildFlags);
+    const SourceStamp &sourceStamp() const;
+    void setSourceStamp(const SourceStamp &sourceStamp);
+    void boundingBox(float *min, float *max) const;
+    void setBoundingBox(const float *min, const float *max);
+    uint32_t stride() const;
+    uint32_t attributeCount() const;
+    const Attribute &attribute(uint32_t index) const;
+    bool setAttributes(const Attribute *attributes, uint32_t count, uint32_t stride);
+    uint32_t subsetCount() const;
+    const Subset *subsets() const;
+    bool writeSubsets(const Subset *subsets, uint32_t count);
+    const void *vertexData() const;
+    bool writeVertexData(const void *vertices, uint32_t count);
+    uint32_t indexCount() const;
+    const uint32_t *indexData() const;
+    bool writeIndexData(const uint32_t *indices, uint32_t count);
+    uint32_t normalVertexCount() const;
+    const void *normalData() const;
+    bool writeNormalData(const void *vertices, uint32_t count);
+    uint32_t gridVertexCount() const;
+    const void *gridData() const;
+    bool writeGridData(const void *vertices, uint32_t count);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_GEOMETRY_H
@@ -0,0 +1,82 @@
+#include <cstring>
+#include <vector>
+#include "Hash.h"
+#include "Parallel.h"
+
+namespace CompiledStaticMesh {
+
+uint64_t Hash::mix(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+
+    return value;
+}
+
+uint64_t Hash::block(const uint8_t *data, size_t size, uint64_t seed)
+{
+    static constexpr const uint64_t Prime = 0x100000001b3ull;
+
+    /*
+        Four independent lanes keep the multiplies pipelined
+    */
+    uint64_t lanes[4] = {seed, seed ^ Prime, seed + Prime, seed - Prime};
+    size_t offset = 0;
+
+    for (; offset + sizeof(uint64_t) * 4 <= size; offset += sizeof(uint64_t) * 4) {
+        for (uint32_t i = 0; i < 4; i++) {
+            uint64_t word;
+            std::memcpy(&word, data + offset + i * sizeof(uint64_t), sizeof(word));
+            lanes[i] = (lanes[i] ^ word) * Prime;
+            lanes[i] ^= lanes[i] >> 29;
+        }
+    }
+
+    uint64_t value = mix(lanes[0]) ^ mix(lanes[1] + 1) ^ mix(lanes[2] + 2) ^ mix(lanes[3] + 3);
+
+    for (; offset < size; offset++) {
+        value = (value ^ data[offset]) * Prime;
+    }
+
+    return mix(value ^ size);
+}
+
+uint64_t Hash::compute(const void *data, size_t size)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    uint32_t blockCount = static_cast<uint32_t>((size + BlockSize - 1) / BlockSize);
+    std::vector<uint64_t> blocks(blockCount);
+
+    uint32_t threadCount = Parallel::threadCount();
+    if (threadCount > blockCount) {
+        threadCount = blockCount;
+    }
+
+    if (threadCount < 1) {
+        return mix(Seed ^ size);
+    }
+
+    Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(blockCount) * thread / threadCount);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(blockCount) * (thread + 1) / threadCount);
+
+        for (uint32_t i = begin; i < end; i++) {
+            size_t offset = static_cast<size_t>(i) * BlockSize;
+            size_t blockSize = size - offset < BlockSize ? size - offset : BlockSize;
+            blocks[i] = block(bytes + offset, blockSize, Seed + i);
+        }
+    });
+
+    uint64_t value = mix(Seed ^ size);
+
+    for (uint64_t blockValue : blocks) {
+        value = mix(value ^ blockValue);
+    }
+
+    return value;
+}
+
+} // namespace CompiledStaticMesh
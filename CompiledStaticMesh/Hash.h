@@ -0,0 +1,31 @@
+#ifndef COMPILEDSTATICMESH_HASH_H
+#define COMPILEDSTATICMESH_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CompiledStaticMesh {
+
+class Hash
+{
+
+public:
+    /*
+        Blocks are hashed independently and then combined in order, so the
+        result does not depend on the number of threads
+    */
+    static constexpr const size_t BlockSize = 1 << 20;
+    static constexpr const uint64_t Seed = 0x9e3779b97f4a7c15ull;
+
+private:
+    static uint64_t mix(uint64_t value);
+    static uint64_t block(const uint8_t *data, size_t size, uint64_t seed);
+
+public:
+    static uint64_t compute(const void *data, size_t size);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_HASH_H
@@ -1,9 +1,15 @@
+#include <cstring>
 #include "Interface.h"
 
 namespace CompiledStaticMesh {
 
 Interface::Interface() :
-    m_file(nullptr)
+    m_file(nullptr),
+    m_memory(nullptr),
+    m_memorySize(0),
+    m_memoryOffset(0),
+    m_pendingMemory(nullptr),
+    m_pendingMemorySize(0)
 {
 
 }
@@ -13,12 +19,27 @@ Interface::~Interface()
 
 }
 
+const uint8_t *Interface::memory() const
+{
+    return m_memory;
+}
+
+uint32_t Interface::memorySize() const
+{
+    return m_memorySize;
+}
+
 bool Interface::getCurrentOffset(uint32_t *offset)
 {
     if (!isOpen()) {
         return false;
     }
 
+    if (m_memory != nullptr) {
+        *offset = m_memoryOffset;
+        return true;
+    }
+
     long position = std::ftell(m_file);
     if (position != 1L) {
         *offset = static_cast<uint32_t>(position);
@@ -34,6 +55,15 @@ bool Interface::setCurrentOffset(uint32_t offset)
         return false;
     }
 
+    if (m_memory != nullptr) {
+        if (offset > m_memorySize) {
+            return false;
+        }
+
+        m_memoryOffset = offset;
+        return true;
+    }
+
     if (std::fseek(m_file, static_cast<long>(offset), SEEK_SET) != 0) {
         return false;
     }
@@ -41,12 +71,50 @@ bool Interface::setCurrentOffset(uint32_t offset)
     return true;
 }
 
+bool Interface::getSize(uint32_t *size)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    if (m_memory != nullptr) {
+        *size = m_memorySize;
+        return true;
+    }
+
+    long position = std::ftell(m_file);
+
+    if (position == -1L || std::fseek(m_file, 0, SEEK_END) != 0) {
+        return false;
+    }
+
+    long end = std::ftell(m_file);
+
+    if (end == -1L || std::fseek(m_file, position, SEEK_SET) != 0) {
+        return false;
+    }
+
+    *size = static_cast<uint32_t>(end);
+
+    return true;
+}
+
 bool Interface::read(void *data, size_t size)
 {
     if (!isOpen()) {
         return false;
     }
 
+    if (m_memory != nullptr) {
+        if (size > m_memorySize - m_memoryOffset) {
+            return false;
+        }
+
+        std::memcpy(data, m_memory + m_memoryOffset, size);
+        m_memoryOffset += static_cast<uint32_t>(size);
+        return true;
+    }
+
     if (std::fread(data, 1, size, m_file) != size) {
         return false;
     }
@@ -56,7 +124,7 @@ bool Interface::read(void *data, size_t size)
 
 bool Interface::write(const void *data, size_t size)
 {
-    if (!isOpen()) {
+    if (!isOpen() || m_memory != nullptr) {
         return false;
     }
 
@@ -69,7 +137,7 @@ bool Interface::write(const void *data, size_t size)
 
 bool Interface::isOpen() const
 {
-    if (m_file == nullptr) {
+    if (m_file == nullptr && m_memory == nullptr) {
         return false;
     }
 
@@ -80,6 +148,20 @@ bool Interface::open(const std::string &filename, Mode mode)
 {
     close();
 
+    /*
+        Memory given to openMemory replaces the file, read only
+    */
+    if (m_pendingMemory != nullptr) {
+        if (mode != Mode::Read) {
+            return false;
+        }
+
+        m_memory = m_pendingMemory;
+        m_memorySize = m_pendingMemorySize;
+        m_memoryOffset = 0;
+        return true;
+    }
+
     if (mode == Mode::Write) {
         m_file = std::fopen(filename.c_str(), "wb");
     } else {
@@ -93,12 +175,46 @@ bool Interface::open(const std::string &filename, Mode mode)
     return true;
 }
 
+bool Interface::openMemory(const void *data, uint32_t size)
+{
+    /*
+        Formats open through their usual open, which picks up the pending memory
+    */
+    m_pendingMemory = reinterpret_cast<const uint8_t *>(data);
+    m_pendingMemorySize = size;
+
+    bool result = open(std::string(), Mode::Read);
+
+    m_pendingMemory = nullptr;
+    m_pendingMemorySize = 0;
+
+    if (!result) {
+        close();
+    }
+
+    return result;
+}
+
 void Interface::close()
 {
     if (m_file != nullptr) {
         std::fclose(m_file);
         m_file = nullptr;
     }
+
+    m_memory = nullptr;
+    m_memorySize = 0;
+    m_memoryOffset = 0;
+}
+
+bool Interface::selectRegion(const float *planes, uint32_t planeCount)
+{
+    /*
+        Formats without a spatial index can only provide the whole mesh
+    */
+    (void)planes;
+
+    return planeCount == 0;
 }
 
 uint32_t Interface::fileVersion(const std::string &filename)
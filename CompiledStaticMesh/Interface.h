@@ -19,9 +19,17 @@ public:
 
 protected:
     std::FILE *m_file;
+    const uint8_t *m_memory;
+    uint32_t m_memorySize;
+    uint32_t m_memoryOffset;
+    const uint8_t *m_pendingMemory;
+    uint32_t m_pendingMemorySize;
 
+    const uint8_t *memory() const;
+    uint32_t memorySize() const;
     bool getCurrentOffset(uint32_t *offset);
     bool setCurrentOffset(uint32_t offset);
+    bool getSize(uint32_t *size);
     bool read(void *data, size_t size);
     bool write(const void *data, size_t size);
 
@@ -30,18 +38,34 @@ public:
     virtual ~Interface();
     bool isOpen() const;
     virtual bool open(const std::string &filename, Mode mode);
+    bool openMemory(const void *data, uint32_t size);
     virtual void close();
     virtual uint32_t version() const = 0;
     virtual void setVersion(uint32_t version) = 0;
     virtual uint32_t flags() const = 0;
     virtual void setFlags(uint32_t flags) = 0;
+    virtual uint32_t headerSize() const = 0;
+    virtual const void *header() const = 0;
+    virtual void setHeader(const void *header) = 0;
     virtual uint32_t faceCount() const = 0;
     virtual uint32_t faceSize() const = 0;
     virtual uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const = 0;
+    virtual int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const = 0;
+    virtual void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const = 0;
+    virtual uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const = 0;
+    virtual void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const = 0;
     virtual uint32_t vertexCount() const = 0;
+    virtual void setVertexCount(uint32_t vertexCount) = 0;
     virtual uint32_t vertexSize() const = 0;
     virtual void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
         uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const = 0;
+    virtual void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const = 0;
+    virtual void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const = 0;
+    virtual void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const = 0;
     virtual bool beginWriteMaterials() = 0;
     virtual bool writeMaterial(const std::string &name) = 0;
     virtual bool endWriteMaterials() = 0;
@@ -55,6 +79,7 @@ public:
     virtual bool endWriteVertices() = 0;
     virtual bool readVertices(void *vertices) = 0;
     virtual bool writeHeader() = 0;
+    virtual bool selectRegion(const float *planes, uint32_t planeCount);
     static uint32_t fileVersion(const std::string &filename);
 
 };
@@ -0,0 +1,199 @@
+#include <cstring>
+#include <vector>
+#include "Lz.h"
+
+namespace CompiledStaticMesh {
+
+uint32_t Lz::hash(uint32_t value)
+{
+    return (value * 2654435761u) >> (32 - HashBits);
+}
+
+void Lz::writeLength(uint8_t **target, uint32_t length)
+{
+    while (length >= 255) {
+        *(*target)++ = 255;
+        length -= 255;
+    }
+
+    *(*target)++ = static_cast<uint8_t>(length);
+}
+
+size_t Lz::bound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t Lz::compress(const uint8_t *source, size_t size, uint8_t *target, size_t capacity)
+{
+    if (capacity < bound(size)) {
+        return 0;
+    }
+
+    std::vector<uint32_t> table(static_cast<size_t>(1) << HashBits, 0);
+    const uint8_t *anchor = source;
+    const uint8_t *current = source + 1;
+    const uint8_t *end = source + size;
+    const uint8_t *matchLimit = size > MinMatch ? end - MinMatch : source;
+    uint8_t *output = target;
+
+    while (current < matchLimit) {
+        uint32_t value;
+        std::memcpy(&value, current, sizeof(value));
+
+        uint32_t &slot = table[hash(value)];
+        const uint8_t *match = source + slot;
+        slot = static_cast<uint32_t>(current - source);
+
+        uint32_t candidate;
+        std::memcpy(&candidate, match, sizeof(candidate));
+
+        if (match >= current || current - match > MaxOffset || candidate != value) {
+            /*
+                Step faster through data that does not match
+            */
+            current += 1 + ((current - anchor) >> 6);
+            continue;
+        }
+
+        while (current > anchor && match > source && current[-1] == match[-1]) {
+            current--;
+            match--;
+        }
+
+        const uint8_t *matchEnd = current + MinMatch;
+        const uint8_t *reference = match + MinMatch;
+
+        while (matchEnd < end && *matchEnd == *reference) {
+            matchEnd++;
+            reference++;
+        }
+
+        uint32_t literalLength = static_cast<uint32_t>(current - anchor);
+        uint32_t matchLength = static_cast<uint32_t>(matchEnd - current) - MinMatch;
+        uint8_t *token = output++;
+
+        *token = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+        if (literalLength >= 15) {
+            writeLength(&output, literalLength - 15);
+        }
+
+        std::memcpy(output, anchor, literalLength);
+        output += literalLength;
+
+        uint32_t offset = static_cast<uint32_t>(current - match);
+        *output++ = static_cast<uint8_t>(offset);
+        *output++ = static_cast<uint8_t>(offset >> 8);
+
+        *token |= static_cast<uint8_t>(matchLength < 15 ? matchLength : 15);
+        if (matchLength >= 15) {
+            writeLength(&output, matchLength - 15);
+        }
+
+        current = matchEnd;
+        anchor = current;
+
+        if (current < matchLimit) {
+            uint32_t previous;
+            std::memcpy(&previous, current - 2, sizeof(previous));
+            table[hash(previous)] = static_cast<uint32_t>(current - 2 - source);
+        }
+    }
+
+    uint32_t literalLength = static_cast<uint32_t>(end - anchor);
+    *output++ = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+    if (literalLength >= 15) {
+        writeLength(&output, literalLength - 15);
+    }
+
+    std::memcpy(output, anchor, literalLength);
+    output += literalLength;
+
+    return static_cast<size_t>(output - target);
+}
+
+bool Lz::decompress(const uint8_t *source, size_t size, uint8_t *target, size_t targetSize)
+{
+    const uint8_t *input = source;
+    const uint8_t *inputEnd = source + size;
+    uint8_t *output = target;
+    uint8_t *outputEnd = target + targetSize;
+
+    while (input < inputEnd) {
+        uint8_t token = *input++;
+        size_t literalLength = token >> 4;
+
+        if (literalLength == 15) {
+            uint8_t extra;
+
+            do {
+                if (input >= inputEnd) {
+                    return false;
+                }
+
+                extra = *input++;
+                literalLength += extra;
+            } while (extra == 255);
+        }
+
+        if (literalLength > static_cast<size_t>(inputEnd - input) ||
+            literalLength > static_cast<size_t>(outputEnd - output)) {
+            return false;
+        }
+
+        std::memcpy(output, input, literalLength);
+        input += literalLength;
+        output += literalLength;
+
+        if (input == inputEnd) {
+            break;
+        }
+
+        if (inputEnd - input < 2) {
+            return false;
+        }
+
+        size_t offset = input[0] | (input[1] << 8);
+        input += 2;
+
+        if (offset == 0 || offset > static_cast<size_t>(output - target)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+
+        if (matchLength == 15) {
+            uint8_t extra;
+
+            do {
+                if (input >= inputEnd) {
+                    return false;
+                }
+
+                extra = *input++;
+                matchLength += extra;
+            } while (extra == 255);
+        }
+
+        matchLength += MinMatch;
+
+        if (matchLength > static_cast<size_t>(outputEnd - output)) {
+            return false;
+        }
+
+        const uint8_t *match = output - offset;
+
+        if (offset >= matchLength) {
+            std::memcpy(output, match, matchLength);
+            output += matchLength;
+        } else {
+            for (size_t i = 0; i < matchLength; i++) {
+                *output++ = *match++;
+            }
+        }
+    }
+
+    return output == outputEnd;
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,35 @@
+#ifndef COMPILEDSTATICMESH_LZ_H
+#define COMPILEDSTATICMESH_LZ_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CompiledStaticMesh {
+
+/*
+    Byte-oriented LZ77 block codec: each sequence is a token (literal and
+    match length nibbles), the literals, a 16-bit match offset and any
+    length extension bytes. The final sequence carries literals only.
+*/
+class Lz
+{
+
+public:
+    static constexpr const uint32_t MinMatch = 4;
+    static constexpr const uint32_t MaxOffset = 0xffff;
+    static constexpr const uint32_t HashBits = 14;
+
+private:
+    static uint32_t hash(uint32_t value);
+    static void writeLength(uint8_t **target, uint32_t length);
+
+public:
+    static size_t bound(size_t size);
+    static size_t compress(const uint8_t *source, size_t size, uint8_t *target, size_t capacity);
+    static bool decompress(const uint8_t *source, size_t size, uint8_t *target, size_t targetSize);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_LZ_H
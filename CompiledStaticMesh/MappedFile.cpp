@@ -0,0 +1,168 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "MappedFile.h"
+
+namespace CompiledStaticMesh {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() :
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr),
+    m_data(nullptr),
+    m_size(0)
+{
+
+}
+
+#else
+
+MappedFile::MappedFile() :
+    m_file(-1),
+    m_data(nullptr),
+    m_size(0)
+{
+
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (m_mapping == nullptr) {
+        close();
+        return false;
+    }
+
+    m_data = reinterpret_cast<const uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (m_data == nullptr) {
+        close();
+        return false;
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    m_file = ::open(filename.c_str(), O_RDONLY);
+
+    if (m_file == -1) {
+        return false;
+    }
+
+    struct stat status;
+
+    if (fstat(m_file, &status) != 0 || status.st_size == 0) {
+        close();
+        return false;
+    }
+
+    void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+
+    if (data == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    m_data = reinterpret_cast<const uint8_t *>(data);
+    m_size = static_cast<size_t>(status.st_size);
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr) {
+        munmap(const_cast<uint8_t *>(m_data), m_size);
+        m_data = nullptr;
+    }
+
+    if (m_file != -1) {
+        ::close(m_file);
+        m_file = -1;
+    }
+
+    m_size = 0;
+}
+
+#endif
+
+bool MappedFile::isOpen() const
+{
+    if (m_data == nullptr) {
+        return false;
+    }
+
+    return true;
+}
+
+const uint8_t *MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,38 @@
+#ifndef COMPILEDSTATICMESH_MAPPEDFILE_H
+#define COMPILEDSTATICMESH_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CompiledStaticMesh {
+
+class MappedFile
+{
+
+private:
+#ifdef _WIN32
+    void *m_file;
+    void *m_mapping;
+#else
+    int m_file;
+#endif
+    const uint8_t *m_data;
+    size_t m_size;
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen() const;
+    const uint8_t *data() const;
+    size_t size() const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_MAPPEDFILE_H
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include "MipGenerator.h"
+#include "Parallel.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIPGENERATOR_SSE2
+#endif
+
+namespace CompiledStaticMesh {
+
+const MipGenerator::Tables &MipGenerator::tables()
+{
+    static const Tables instance = []() {
+        Tables result;
+
+        for (uint32_t i = 0; i < 256; i++) {
+            float encoded = static_cast<float>(i) / 255.0f;
+            float linear = encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+
+            for (uint32_t c = 0; c < 3; c++) {
+                result.toLinear[c][i] = static_cast<uint16_t>(std::lround(linear * LinearMax));
+            }
+
+            result.toLinear[3][i] = static_cast<uint16_t>((i * LinearMax + 127) / 255);
+        }
+
+        for (uint32_t i = 0; i <= LinearMax; i++) {
+            float linear = static_cast<float>(i) / LinearMax;
+            float encoded = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+
+            for (uint32_t c = 0; c < 3; c++) {
+                result.toEncoded[c][i] = static_cast<uint8_t>(std::lround(std::min(std::max(encoded, 0.0f), 1.0f) * 255));
+            }
+
+            result.toEncoded[3][i] = static_cast<uint8_t>((i * 255 + LinearMax / 2) / LinearMax);
+        }
+
+        return result;
+    }();
+
+    return instance;
+}
+
+uint32_t MipGenerator::levelSize(uint32_t size, uint32_t level)
+{
+    return std::max<uint32_t>(1, size >> level);
+}
+
+uint32_t MipGenerator::levelCount(uint32_t width, uint32_t height)
+{
+    uint32_t count = 1;
+
+    while (width > 1 || height > 1) {
+        width = std::max<uint32_t>(1, width / 2);
+        height = std::max<uint32_t>(1, height / 2);
+        count++;
+    }
+
+    return count;
+}
+
+void MipGenerator::downsampleRows(const uint8_t *source, uint32_t width, uint32_t height, uint8_t *target,
+    uint32_t begin, uint32_t end)
+{
+    const Tables &table = tables();
+    uint32_t targetWidth = levelSize(width, 1);
+    uint32_t targetHeight = levelSize(height, 1);
+    std::vector<uint16_t> rows[3] = {std::vector<uint16_t>(width * 4), std::vector<uint16_t>(width * 4),
+        std::vector<uint16_t>(width * 4)};
+    uint16_t sums[8];
+
+    for (uint32_t y = begin; y < end; y++) {
+        /*
+            Source rows go to linear light first. The last row and column of an odd
+            size are folded into the last target row and column, a size of one repeats
+        */
+        uint32_t rowCount = y == targetHeight - 1 && height > 1 && height % 2 == 1 ? 3 : 2;
+
+        for (uint32_t r = 0; r < rowCount; r++) {
+            const uint8_t *sourceRow = source + static_cast<size_t>(std::min(y * 2 + r, height - 1)) * width * 4;
+
+            for (uint32_t i = 0; i < width * 4; i++) {
+                rows[r][i] = table.toLinear[i & 3][sourceRow[i]];
+            }
+        }
+
+        uint8_t *targetRow = target + static_cast<size_t>(y) * targetWidth * 4;
+
+        for (uint32_t x = 0; x < targetWidth; x++) {
+            uint32_t columnCount = x == targetWidth - 1 && width > 1 && width % 2 == 1 ? 3 : 2;
+
+            if (rowCount == 2 && columnCount == 2) {
+                uint32_t left = std::min(x * 2, width - 1) * 4;
+                uint32_t right = std::min(x * 2 + 1, width - 1) * 4;
+
+#if defined(MIPGENERATOR_SSE2)
+                __m128i top = _mm_unpacklo_epi64(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&rows[0][left])),
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&rows[0][right])));
+                __m128i bottom = _mm_unpacklo_epi64(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&rows[1][left])),
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&rows[1][right])));
+                __m128i sum = _mm_add_epi16(top, bottom);
+                sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+                sum = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(sums), sum);
+#else
+                for (uint32_t c = 0; c < 4; c++) {
+                    sums[c] = static_cast<uint16_t>((rows[0][left + c] + rows[0][right + c] +
+                        rows[1][left + c] + rows[1][right + c] + 2) >> 2);
+                }
+#endif
+            } else {
+                uint32_t count = rowCount * columnCount;
+
+                for (uint32_t c = 0; c < 4; c++) {
+                    uint32_t sum = 0;
+
+                    for (uint32_t r = 0; r < rowCount; r++) {
+                        for (uint32_t k = 0; k < columnCount; k++) {
+                            sum += rows[r][std::min(x * 2 + k, width - 1) * 4 + c];
+                        }
+                    }
+
+                    sums[c] = static_cast<uint16_t>((sum + count / 2) / count);
+                }
+            }
+
+            for (uint32_t c = 0; c < 4; c++) {
+                targetRow[x * 4 + c] = table.toEncoded[c][sums[c]];
+            }
+        }
+    }
+}
+
+void MipGenerator::downsample(const uint8_t *source, uint32_t width, uint32_t height, uint8_t *target,
+    bool parallel)
+{
+    uint32_t targetWidth = levelSize(width, 1);
+    uint32_t targetHeight = levelSize(height, 1);
+    uint32_t threadCount = parallel ? std::min(Parallel::threadCount(targetWidth * targetHeight), targetHeight) : 1;
+
+    Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(targetHeight) * thread / threadCount);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(targetHeight) * (thread + 1) / threadCount);
+
+        if (begin < end) {
+            downsampleRows(source, width, height, target, begin, end);
+        }
+    });
+}
+
+void MipGenerator::generate(const uint8_t *source, uint32_t width, uint32_t height, uint32_t levelCount,
+    std::vector<std::vector<uint8_t>> *levels, bool parallel)
+{
+    /*
+        Levels below the source, each one filtered from the previous
+    */
+    levels->clear();
+
+    for (uint32_t level = 1; level < levelCount && (width > 1 || height > 1); level++) {
+        uint32_t targetWidth = levelSize(width, 1);
+        uint32_t targetHeight = levelSize(height, 1);
+
+        levels->emplace_back(static_cast<size_t>(targetWidth) * targetHeight * 4);
+        downsample(source, width, height, levels->back().data(), parallel);
+
+        source = levels->back().data();
+        width = targetWidth;
+        height = targetHeight;
+    }
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,44 @@
+#ifndef COMPILEDSTATICMESH_MIPGENERATOR_H
+#define COMPILEDSTATICMESH_MIPGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+namespace CompiledStaticMesh {
+
+/*
+    Box filtered mip levels for sRGB encoded RGBA8 images. Color is averaged
+    in linear light through 12 bit tables, alpha is averaged as stored.
+    Callers already running on a pool thread pass parallel false so rows
+    are not split across more threads.
+*/
+class MipGenerator
+{
+
+public:
+    static constexpr const uint32_t LinearBits = 12;
+    static constexpr const uint32_t LinearMax = (1 << LinearBits) - 1;
+
+private:
+    struct Tables {
+        uint16_t toLinear[4][256];
+        uint8_t toEncoded[4][LinearMax + 1];
+    };
+
+    static const Tables &tables();
+    static void downsampleRows(const uint8_t *source, uint32_t width, uint32_t height, uint8_t *target,
+        uint32_t begin, uint32_t end);
+
+public:
+    static uint32_t levelSize(uint32_t size, uint32_t level);
+    static uint32_t levelCount(uint32_t width, uint32_t height);
+    static void downsample(const uint8_t *source, uint32_t width, uint32_t height, uint8_t *target,
+        bool parallel);
+    static void generate(const uint8_t *source, uint32_t width, uint32_t height, uint32_t levelCount,
+        std::vector<std::vector<uint8_t>> *levels, bool parallel);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_MIPGENERATOR_H
@@ -0,0 +1,278 @@
+#include <cmath>
+#include "NormalGenerator.h"
+#include "Parallel.h"
+
+namespace CompiledStaticMesh {
+
+NormalGenerator::NormalGenerator() :
+    m_creaseAngle(DefaultCreaseAngle)
+{
+
+}
+
+float NormalGenerator::creaseAngle() const
+{
+    return m_creaseAngle;
+}
+
+void NormalGenerator::setCreaseAngle(float creaseAngle)
+{
+    m_creaseAngle = creaseAngle;
+}
+
+bool NormalGenerator::generate(const Interface *mesh, const void *faceData, const void *vertexData,
+    const Welder *welder)
+{
+    m_normals.clear();
+
+    if (mesh == nullptr || faceData == nullptr || vertexData == nullptr) {
+        return false;
+    }
+
+    uint32_t faceCount = mesh->faceCount();
+    uint32_t sourceVertexCount = mesh->vertexCount();
+    uint32_t vertexCount = sourceVertexCount;
+
+    if (welder != nullptr) {
+        if (welder->remap().size() != sourceVertexCount) {
+            return false;
+        }
+
+        vertexCount = welder->vertexCount();
+    }
+
+    uint32_t threadCount = Parallel::threadCount(faceCount);
+    uint32_t partitionCount = threadCount;
+
+    /*
+        Face normals, corner angles and the corners of every vertex, split into vertex ranges
+    */
+    std::vector<float> faceNormals(static_cast<size_t>(faceCount) * 3, 0.0f);
+    std::vector<float> cornerAngles(static_cast<size_t>(faceCount) * 3, 0.0f);
+    std::vector<uint32_t> cornerVertices(static_cast<size_t>(faceCount) * 3, Welder::InvalidIndex);
+    std::vector<std::vector<std::vector<Corner>>> threadCorners(threadCount,
+        std::vector<std::vector<Corner>>(partitionCount));
+    std::vector<int64_t> threadOrientations(threadCount, 0);
+
+    Parallel::forEach(faceCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t index[3];
+            bool isValid = true;
+
+            for (uint32_t j = 0; j < 3; j++) {
+                index[j] = mesh->faceVertexIndex(faceData, i, j);
+                if (index[j] >= sourceVertexCount) {
+                    isValid = false;
+                }
+            }
+
+            if (!isValid) {
+                continue;
+            }
+
+            float position[3][3];
+            float normal[3] = { 0.0f, 0.0f, 0.0f };
+
+            for (uint32_t j = 0; j < 3; j++) {
+                float vertexNormal[3];
+                mesh->vertexPosition(vertexData, index[j], position[j]);
+                mesh->vertexNormal(vertexData, index[j], vertexNormal);
+
+                normal[0] += vertexNormal[0];
+                normal[1] += vertexNormal[1];
+                normal[2] += vertexNormal[2];
+            }
+
+            float *faceNormal = &faceNormals[static_cast<size_t>(i) * 3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                const float *a = position[j];
+                const float *b = position[(j + 1) % 3];
+                const float *c = position[(j + 2) % 3];
+
+                float edge[2][3] = {
+                    { b[0] - a[0], b[1] - a[1], b[2] - a[2] },
+                    { c[0] - a[0], c[1] - a[1], c[2] - a[2] }
+                };
+
+                if (j == 0) {
+                    faceNormal[0] = edge[0][1] * edge[1][2] - edge[0][2] * edge[1][1];
+                    faceNormal[1] = edge[0][2] * edge[1][0] - edge[0][0] * edge[1][2];
+                    faceNormal[2] = edge[0][0] * edge[1][1] - edge[0][1] * edge[1][0];
+                }
+
+                float length = std::sqrt(
+                    (edge[0][0] * edge[0][0] + edge[0][1] * edge[0][1] + edge[0][2] * edge[0][2]) *
+                    (edge[1][0] * edge[1][0] + edge[1][1] * edge[1][1] + edge[1][2] * edge[1][2]));
+
+                if (length > 0.0f) {
+                    float cos = (edge[0][0] * edge[1][0] + edge[0][1] * edge[1][1] +
+                        edge[0][2] * edge[1][2]) / length;
+                    cornerAngles[static_cast<size_t>(i) * 3 + j] =
+                        std::acos(std::fmax(-1.0f, std::fmin(1.0f, cos)));
+                }
+            }
+
+            float length = std::sqrt(faceNormal[0] * faceNormal[0] + faceNormal[1] * faceNormal[1] +
+                faceNormal[2] * faceNormal[2]);
+
+            if (!(length > 0.0f)) {
+                faceNormal[0] = 0.0f;
+                faceNormal[1] = 0.0f;
+                faceNormal[2] = 0.0f;
+
+                for (uint32_t j = 0; j < 3; j++) {
+                    cornerVertices[static_cast<size_t>(i) * 3 + j] =
+                        welder != nullptr ? welder->remap()[index[j]] : index[j];
+                }
+
+                continue;
+            }
+
+            faceNormal[0] /= length;
+            faceNormal[1] /= length;
+            faceNormal[2] /= length;
+
+            float orientation = faceNormal[0] * normal[0] + faceNormal[1] * normal[1] +
+                faceNormal[2] * normal[2];
+
+            if (orientation > 0.0f) {
+                threadOrientations[thread]++;
+            } else if (orientation < 0.0f) {
+                threadOrientations[thread]--;
+            }
+
+            for (uint32_t j = 0; j < 3; j++) {
+                Corner corner;
+                corner.vertex = welder != nullptr ? welder->remap()[index[j]] : index[j];
+                corner.corner = i * 3 + j;
+
+                cornerVertices[corner.corner] = corner.vertex;
+                threadCorners[thread][static_cast<uint32_t>(
+                    static_cast<uint64_t>(corner.vertex) * partitionCount / vertexCount)].push_back(corner);
+            }
+        }
+    });
+
+    /*
+        Winding is not stored in the file, so follow the side most stored normals point to
+    */
+    int64_t orientation = 0;
+
+    for (int64_t threadOrientation : threadOrientations) {
+        orientation += threadOrientation;
+    }
+
+    float orientationSign = orientation < 0 ? -1.0f : 1.0f;
+
+    /*
+        Build vertex to corner adjacency, each partition owns a contiguous vertex range
+    */
+    std::vector<uint32_t> partitionOffsets(partitionCount + 1, 0);
+
+    for (uint32_t i = 0; i < partitionCount; i++) {
+        partitionOffsets[i + 1] = partitionOffsets[i];
+
+        for (uint32_t j = 0; j < threadCount; j++) {
+            partitionOffsets[i + 1] += static_cast<uint32_t>(threadCorners[j][i].size());
+        }
+    }
+
+    std::vector<uint32_t> offsets(static_cast<size_t>(vertexCount) + 1, 0);
+    std::vector<uint32_t> adjacency(partitionOffsets[partitionCount]);
+    offsets[vertexCount] = partitionOffsets[partitionCount];
+
+    Parallel::forEachThread(partitionCount, [&](uint32_t partition) {
+        uint32_t firstVertex = static_cast<uint32_t>(
+            (static_cast<uint64_t>(vertexCount) * partition + partitionCount - 1) / partitionCount);
+        uint32_t lastVertex = static_cast<uint32_t>(
+            (static_cast<uint64_t>(vertexCount) * (partition + 1) + partitionCount - 1) / partitionCount);
+
+        for (uint32_t i = firstVertex; i < lastVertex; i++) {
+            offsets[i] = 0;
+        }
+
+        for (uint32_t i = 0; i < threadCount; i++) {
+            for (const Corner &corner : threadCorners[i][partition]) {
+                offsets[corner.vertex]++;
+            }
+        }
+
+        uint32_t offset = partitionOffsets[partition];
+
+        for (uint32_t i = firstVertex; i < lastVertex; i++) {
+            uint32_t count = offsets[i];
+            offsets[i] = offset;
+            offset += count;
+        }
+
+        std::vector<uint32_t> positions(offsets.begin() + firstVertex, offsets.begin() + lastVertex);
+
+        for (uint32_t i = 0; i < threadCount; i++) {
+            for (const Corner &corner : threadCorners[i][partition]) {
+                adjacency[positions[corner.vertex - firstVertex]++] = corner.corner;
+            }
+
+            threadCorners[i][partition] = std::vector<Corner>();
+        }
+    });
+
+    /*
+        Every corner gathers the faces around its vertex that lie within the crease angle
+    */
+    float creaseCos = std::cos(m_creaseAngle * 3.14159265358979f / 180.0f);
+    m_normals.assign(static_cast<size_t>(faceCount) * 9, 0.0f);
+
+    Parallel::forEach(faceCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        (void)thread;
+
+        for (uint32_t i = begin; i < end; i++) {
+            const float *faceNormal = &faceNormals[static_cast<size_t>(i) * 3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t corner = i * 3 + j;
+                float *normal = &m_normals[static_cast<size_t>(corner) * 3];
+                uint32_t vertex = cornerVertices[corner];
+
+                if (vertex == Welder::InvalidIndex) {
+                    continue;
+                }
+
+                for (uint32_t k = offsets[vertex]; k < offsets[vertex + 1]; k++) {
+                    uint32_t otherCorner = adjacency[k];
+                    const float *otherNormal = &faceNormals[static_cast<size_t>(otherCorner / 3) * 3];
+
+                    if (faceNormal[0] * otherNormal[0] + faceNormal[1] * otherNormal[1] +
+                        faceNormal[2] * otherNormal[2] < creaseCos) {
+                        continue;
+                    }
+
+                    float weight = cornerAngles[otherCorner];
+                    normal[0] += otherNormal[0] * weight;
+                    normal[1] += otherNormal[1] * weight;
+                    normal[2] += otherNormal[2] * weight;
+                }
+
+                float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+                    normal[2] * normal[2]);
+
+                if (length > 0.0f) {
+                    normal[0] = normal[0] / length * orientationSign;
+                    normal[1] = normal[1] / length * orientationSign;
+                    normal[2] = normal[2] / length * orientationSign;
+                } else {
+                    mesh->vertexNormal(vertexData, mesh->faceVertexIndex(faceData, i, j), normal);
+                }
+            }
+        }
+    });
+
+    return true;
+}
+
+const float *NormalGenerator::normal(uint32_t faceIndex, uint32_t vertexIndex) const
+{
+    return &m_normals[(static_cast<size_t>(faceIndex) * 3 + vertexIndex) * 3];
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,38 @@
+#ifndef COMPILEDSTATICMESH_NORMALGENERATOR_H
+#define COMPILEDSTATICMESH_NORMALGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "Interface.h"
+#include "Welder.h"
+
+namespace CompiledStaticMesh {
+
+class NormalGenerator
+{
+
+public:
+    static constexpr const float DefaultCreaseAngle = 60.0f;
+
+private:
+    struct Corner {
+        uint32_t vertex;
+        uint32_t corner;
+    };
+
+    float m_creaseAngle;
+    std::vector<float> m_normals;
+
+public:
+    NormalGenerator();
+    float creaseAngle() const;
+    void setCreaseAngle(float creaseAngle);
+    bool generate(const Interface *mesh, const void *faceData, const void *vertexData,
+        const Welder *welder = nullptr);
+    const float *normal(uint32_t faceIndex, uint32_t vertexIndex) const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_NORMALGENERATOR_H
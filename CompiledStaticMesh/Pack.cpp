@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cstring>
+#include "Pack.h"
+#include "Version2.h"
+#include "Version3.h"
+
+namespace CompiledStaticMesh {
+
+Pack::Pack() :
+    m_file(nullptr),
+    m_entries(nullptr),
+    m_directory(nullptr)
+{
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+Pack::~Pack()
+{
+    close();
+}
+
+bool Pack::writeAligned(const void *data, uint32_t size, uint32_t *offset)
+{
+    long position = std::ftell(m_file);
+    if (position == -1L) {
+        return false;
+    }
+
+    /*
+        Members are aligned so mapped records can be used in place
+    */
+    static const uint8_t padding[DataAlignment] = {};
+    uint32_t paddingSize = (DataAlignment - static_cast<uint32_t>(position) % DataAlignment) % DataAlignment;
+
+    if (std::fwrite(padding, 1, paddingSize, m_file) != paddingSize) {
+        return false;
+    }
+
+    *offset = static_cast<uint32_t>(position) + paddingSize;
+
+    if (std::fwrite(data, 1, size, m_file) != size) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Pack::writeDirectory()
+{
+    /*
+        Entries sorted by name, followed by the names and the member headers
+    */
+    std::vector<uint32_t> order(m_pendingEntries.size());
+
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return m_pendingNames[a] < m_pendingNames[b];
+    });
+
+    std::vector<Entry> entries(order.size());
+    std::vector<uint8_t> names;
+    uint32_t namesOffset = static_cast<uint32_t>(sizeof(Entry) * entries.size());
+
+    for (uint32_t i = 0; i < order.size(); i++) {
+        const std::string &name = m_pendingNames[order[i]];
+
+        entries[i] = m_pendingEntries[order[i]];
+        entries[i].nameOffset = namesOffset + static_cast<uint32_t>(names.size());
+        entries[i].nameSize = static_cast<uint32_t>(name.size());
+        names.insert(names.end(), name.begin(), name.end());
+    }
+
+    uint32_t headersOffset = namesOffset + static_cast<uint32_t>(names.size());
+
+    for (Entry &entry : entries) {
+        entry.headerOffset += headersOffset;
+    }
+
+    std::vector<uint8_t> directory(sizeof(Entry) * entries.size());
+    std::memcpy(directory.data(), entries.data(), directory.size());
+    directory.insert(directory.end(), names.begin(), names.end());
+    directory.insert(directory.end(), m_pendingHeaders.begin(), m_pendingHeaders.end());
+
+    if (!writeAligned(directory.data(), static_cast<uint32_t>(directory.size()), &m_header.directoryOffset)) {
+        return false;
+    }
+
+    m_header.entryCount = static_cast<uint32_t>(entries.size());
+    m_header.directorySize = static_cast<uint32_t>(directory.size());
+
+    if (std::fseek(m_file, 0, SEEK_SET) != 0) {
+        return false;
+    }
+
+    if (std::fwrite(&m_header, sizeof(Header), 1, m_file) != 1) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Pack::validDirectory() const
+{
+    uint64_t fileSize = m_mappedFile.size();
+
+    if (m_header.directoryOffset % DataAlignment != 0 ||
+        static_cast<uint64_t>(m_header.directoryOffset) + m_header.directorySize > fileSize ||
+        static_cast<uint64_t>(m_header.entryCount) * sizeof(Entry) > m_header.directorySize) {
+        return false;
+    }
+
+    const Entry *entries = reinterpret_cast<const Entry *>(m_mappedFile.data() + m_header.directoryOffset);
+
+    for (uint32_t i = 0; i < m_header.entryCount; i++) {
+        const Entry &entry = entries[i];
+
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameSize > m_header.directorySize ||
+            static_cast<uint64_t>(entry.headerOffset) + entry.headerSize > m_header.directorySize ||
+            static_cast<uint64_t>(entry.dataOffset) + entry.dataSize > fileSize ||
+            static_cast<uint64_t>(entry.thumbnailOffset) + entry.thumbnailSize > fileSize) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Pack::open(const std::string &filename, Interface::Mode mode)
+{
+    close();
+
+    if (mode == Interface::Write) {
+        m_file = std::fopen(filename.c_str(), "wb");
+        if (m_file == nullptr) {
+            return false;
+        }
+
+        m_header.signature = Signature;
+        m_header.version = Version;
+        m_header.headerSize = sizeof(Header);
+
+        if (std::fwrite(&m_header, sizeof(Header), 1, m_file) != 1) {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    if (!m_mappedFile.open(filename) || m_mappedFile.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    std::memcpy(&m_header, m_mappedFile.data(), sizeof(Header));
+
+    if (m_header.signature != Signature || m_header.version != Version ||
+        m_header.headerSize != sizeof(Header) || !validDirectory()) {
+        close();
+        return false;
+    }
+
+    m_directory = reinterpret_cast<const char *>(m_mappedFile.data() + m_header.directoryOffset);
+    m_entries = reinterpret_cast<const Entry *>(m_directory);
+
+    return true;
+}
+
+bool Pack::close()
+{
+    bool result = true;
+
+    if (m_file != nullptr) {
+        result = writeDirectory();
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    m_mappedFile.close();
+    m_entries = nullptr;
+    m_directory = nullptr;
+    m_pendingEntries.clear();
+    m_pendingNames.clear();
+    m_pendingHeaders.clear();
+    std::memset(&m_header, 0, sizeof(Header));
+
+    return result;
+}
+
+bool Pack::isOpen() const
+{
+    return m_file != nullptr || m_mappedFile.isOpen();
+}
+
+uint32_t Pack::entryCount() const
+{
+    if (m_entries == nullptr) {
+        return 0;
+    }
+
+    return m_header.entryCount;
+}
+
+const Pack::Entry &Pack::entry(uint32_t index) const
+{
+    return m_entries[index];
+}
+
+std::string Pack::entryName(uint32_t index) const
+{
+    return std::string(m_directory + m_entries[index].nameOffset, m_entries[index].nameSize);
+}
+
+int32_t Pack::findEntry(const std::string &name) const
+{
+    uint32_t begin = 0;
+    uint32_t end = entryCount();
+
+    while (begin < end) {
+        uint32_t middle = begin + (end - begin) / 2;
+        const Entry &entry = m_entries[middle];
+        int compare = name.compare(0, std::string::npos, m_directory + entry.nameOffset, entry.nameSize);
+
+        if (compare == 0) {
+            return static_cast<int32_t>(middle);
+        }
+
+        if (compare > 0) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    return -1;
+}
+
+const uint8_t *Pack::entryData(uint32_t index) const
+{
+    return m_mappedFile.data() + m_entries[index].dataOffset;
+}
+
+const uint8_t *Pack::entryHeader(uint32_t index) const
+{
+    return reinterpret_cast<const uint8_t *>(m_directory + m_entries[index].headerOffset);
+}
+
+const uint8_t *Pack::entryThumbnail(uint32_t index) const
+{
+    if (m_entries[index].thumbnailSize == 0) {
+        return nullptr;
+    }
+
+    return m_mappedFile.data() + m_entries[index].thumbnailOffset;
+}
+
+bool Pack::openEntry(uint32_t index, Interface *compiledStaticMesh) const
+{
+    if (index >= entryCount()) {
+        return false;
+    }
+
+    return compiledStaticMesh->openMemory(entryData(index), m_entries[index].dataSize);
+}
+
+bool Pack::writeEntry(const std::string &name, const void *data, uint32_t size,
+    const void *thumbnail, uint32_t thumbnailSize)
+{
+    if (m_file == nullptr || name.empty() ||
+        std::find(m_pendingNames.begin(), m_pendingNames.end(), name) != m_pendingNames.end()) {
+        return false;
+    }
+
+    Entry entry;
+    std::memset(&entry, 0, sizeof(Entry));
+    entry.dataSize = size;
+
+    if (!writeAligned(data, size, &entry.dataOffset)) {
+        return false;
+    }
+
+    if (thumbnail != nullptr && thumbnailSize > 0) {
+        entry.thumbnailSize = thumbnailSize;
+
+        if (!writeAligned(thumbnail, thumbnailSize, &entry.thumbnailOffset)) {
+            return false;
+        }
+    }
+
+    /*
+        Members start with signature and version, containers then give their header size
+    */
+    uint32_t memberHeader[3] = {};
+    std::memcpy(memberHeader, data, std::min<size_t>(size, sizeof(memberHeader)));
+    entry.version = memberHeader[1];
+
+    uint32_t headerSize = memberHeader[2];
+
+    if (entry.version == Version2::Version) {
+        headerSize = sizeof(Version2::Header);
+    } else if (entry.version == Version3::Version) {
+        headerSize = sizeof(Version3::Header);
+    }
+    entry.headerSize = std::min(std::min(headerSize, size), MaxMemberHeaderSize);
+
+    entry.headerOffset = static_cast<uint32_t>(m_pendingHeaders.size());
+    const uint8_t *headerData = reinterpret_cast<const uint8_t *>(data);
+    m_pendingHeaders.insert(m_pendingHeaders.end(), headerData, headerData + entry.headerSize);
+
+    m_pendingEntries.push_back(entry);
+    m_pendingNames.push_back(name);
+
+    return true;
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,86 @@
+#ifndef COMPILEDSTATICMESH_PACK_H
+#define COMPILEDSTATICMESH_PACK_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Interface.h"
+#include "MappedFile.h"
+
+namespace CompiledStaticMesh {
+
+/*
+    Many meshes concatenated into one file with a central directory at the
+    end. The directory holds member names sorted for lookup, a copy of every
+    member header, data ranges and optional thumbnails. Packs are read
+    through one mapping and members open from memory with openMemory.
+*/
+class Pack
+{
+
+public:
+    static constexpr const uint32_t Version = 80;
+    static constexpr const uint32_t Signature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'P';
+    static constexpr const uint32_t DataAlignment = 16;
+    static constexpr const uint32_t MaxMemberHeaderSize = 4096;
+
+    struct Entry {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t dataOffset;
+        uint32_t dataSize;
+        uint32_t version;
+        uint32_t headerOffset;
+        uint32_t headerSize;
+        uint32_t thumbnailOffset;
+        uint32_t thumbnailSize;
+    };
+
+    struct Header {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t entryCount;
+        uint32_t directoryOffset;
+        uint32_t directorySize;
+    };
+
+private:
+    Header m_header;
+    std::FILE *m_file;
+    MappedFile m_mappedFile;
+    const Entry *m_entries;
+    const char *m_directory;
+    std::vector<Entry> m_pendingEntries;
+    std::vector<std::string> m_pendingNames;
+    std::vector<uint8_t> m_pendingHeaders;
+
+    bool writeAligned(const void *data, uint32_t size, uint32_t *offset);
+    bool writeDirectory();
+    bool validDirectory() const;
+
+public:
+    Pack();
+    ~Pack();
+    Pack(const Pack &) = delete;
+    Pack &operator=(const Pack &) = delete;
+    bool open(const std::string &filename, Interface::Mode mode);
+    bool close();
+    bool isOpen() const;
+    uint32_t entryCount() const;
+    const Entry &entry(uint32_t index) const;
+    std::string entryName(uint32_t index) const;
+    int32_t findEntry(const std::string &name) const;
+    const uint8_t *entryData(uint32_t index) const;
+    const uint8_t *entryHeader(uint32_t index) const;
+    const uint8_t *entryThumbnail(uint32_t index) const;
+    bool openEntry(uint32_t index, Interface *compiledStaticMesh) const;
+    bool writeEntry(const std::string &name, const void *data, uint32_t size,
+        const void *thumbnail = nullptr, uint32_t thumbnailSize = 0);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_PACK_H
@@ -0,0 +1,66 @@
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+
+namespace CompiledStaticMesh {
+
+uint32_t Parallel::threadCount()
+{
+    uint32_t count = std::thread::hardware_concurrency();
+    if (count < 1) {
+        count = 1;
+    }
+
+    return count;
+}
+
+uint32_t Parallel::threadCount(uint32_t itemCount)
+{
+    uint32_t count = itemCount / MinItemsPerThread;
+    if (count < 1) {
+        count = 1;
+    }
+
+    if (count > threadCount()) {
+        count = threadCount();
+    }
+
+    return count;
+}
+
+void Parallel::forEach(uint32_t itemCount, const RangeFunction &function)
+{
+    uint32_t count = threadCount(itemCount);
+
+    forEachThread(count, [&](uint32_t thread) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(itemCount) * thread / count);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(itemCount) * (thread + 1) / count);
+
+        if (begin < end) {
+            function(thread, begin, end);
+        }
+    });
+}
+
+void Parallel::forEachThread(uint32_t threadCount, const ThreadFunction &function)
+{
+    if (threadCount < 2) {
+        function(0);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+
+    for (uint32_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(function, i);
+    }
+
+    function(0);
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,27 @@
+#ifndef COMPILEDSTATICMESH_PARALLEL_H
+#define COMPILEDSTATICMESH_PARALLEL_H
+
+#include <cstdint>
+#include <functional>
+
+namespace CompiledStaticMesh {
+
+class Parallel
+{
+
+public:
+    static constexpr const uint32_t MinItemsPerThread = 4096;
+
+    using RangeFunction = std::function<void(uint32_t thread, uint32_t begin, uint32_t end)>;
+    using ThreadFunction = std::function<void(uint32_t thread)>;
+
+    static uint32_t threadCount();
+    static uint32_t threadCount(uint32_t itemCount);
+    static void forEach(uint32_t itemCount, const RangeFunction &function);
+    static void forEachThread(uint32_t threadCount, const ThreadFunction &function);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_PARALLEL_H
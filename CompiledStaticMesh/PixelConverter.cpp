@@ -0,0 +1,94 @@
+#include "PixelConverter.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXELCONVERTER_SSE2
+#endif
+
+namespace CompiledStaticMesh {
+
+void PixelConverter::swapRedBlueSoftware(uint8_t *pixels, size_t pixelCount)
+{
+    for (size_t i = 0; i < pixelCount; i++) {
+        uint8_t red = pixels[i * 4 + 2];
+        pixels[i * 4 + 2] = pixels[i * 4];
+        pixels[i * 4] = red;
+    }
+}
+
+void PixelConverter::setOpaqueSoftware(uint8_t *pixels, size_t pixelCount)
+{
+    for (size_t i = 0; i < pixelCount; i++) {
+        pixels[i * 4 + 3] = 255;
+    }
+}
+
+void PixelConverter::swapRedBlue(void *pixels, size_t pixelCount)
+{
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(pixels);
+    size_t i = 0;
+
+#if defined(PIXELCONVERTER_SSE2)
+    /*
+        Four pixels per step, green and alpha stay while the outer bytes trade places
+    */
+    const __m128i greenAlpha = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+    const __m128i low = _mm_set1_epi32(0xff);
+
+    for (; i + 4 <= pixelCount; i += 4) {
+        __m128i *block = reinterpret_cast<__m128i *>(bytes + i * 4);
+        __m128i value = _mm_loadu_si128(block);
+        __m128i swapped = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(value, 16), low),
+            _mm_slli_epi32(_mm_and_si128(value, low), 16));
+
+        _mm_storeu_si128(block, _mm_or_si128(_mm_and_si128(value, greenAlpha), swapped));
+    }
+#endif
+
+    swapRedBlueSoftware(bytes + i * 4, pixelCount - i);
+}
+
+void PixelConverter::setOpaque(void *pixels, size_t pixelCount)
+{
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(pixels);
+    size_t i = 0;
+
+#if defined(PIXELCONVERTER_SSE2)
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+    for (; i + 4 <= pixelCount; i += 4) {
+        __m128i *block = reinterpret_cast<__m128i *>(bytes + i * 4);
+        _mm_storeu_si128(block, _mm_or_si128(_mm_loadu_si128(block), alpha));
+    }
+#endif
+
+    setOpaqueSoftware(bytes + i * 4, pixelCount - i);
+}
+
+void PixelConverter::expandBgr(const void *bgrPixels, void *rgbaPixels, size_t pixelCount)
+{
+    const uint8_t *source = reinterpret_cast<const uint8_t *>(bgrPixels);
+    uint8_t *target = reinterpret_cast<uint8_t *>(rgbaPixels);
+
+    for (size_t i = 0; i < pixelCount; i++) {
+        target[i * 4] = source[i * 3 + 2];
+        target[i * 4 + 1] = source[i * 3 + 1];
+        target[i * 4 + 2] = source[i * 3];
+        target[i * 4 + 3] = 255;
+    }
+}
+
+void PixelConverter::expandGray(const void *grayPixels, void *rgbaPixels, size_t pixelCount)
+{
+    const uint8_t *source = reinterpret_cast<const uint8_t *>(grayPixels);
+    uint8_t *target = reinterpret_cast<uint8_t *>(rgbaPixels);
+
+    for (size_t i = 0; i < pixelCount; i++) {
+        target[i * 4] = source[i];
+        target[i * 4 + 1] = source[i];
+        target[i * 4 + 2] = source[i];
+        target[i * 4 + 3] = 255;
+    }
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,30 @@
+#ifndef COMPILEDSTATICMESH_PIXELCONVERTER_H
+#define COMPILEDSTATICMESH_PIXELCONVERTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CompiledStaticMesh {
+
+/*
+    Conversions of decoded rows to RGBA8, in place where the pixel size
+    does not change so decoders can write straight into the final buffer.
+*/
+class PixelConverter
+{
+
+private:
+    static void swapRedBlueSoftware(uint8_t *pixels, size_t pixelCount);
+    static void setOpaqueSoftware(uint8_t *pixels, size_t pixelCount);
+
+public:
+    static void swapRedBlue(void *pixels, size_t pixelCount);
+    static void setOpaque(void *pixels, size_t pixelCount);
+    static void expandBgr(const void *bgrPixels, void *rgbaPixels, size_t pixelCount);
+    static void expandGray(const void *grayPixels, void *rgbaPixels, size_t pixelCount);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_PIXELCONVERTER_H
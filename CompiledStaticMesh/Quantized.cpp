@@ -0,0 +1,821 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "Parallel.h"
+#include "Quantized.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define QUANTIZED_SSE2
+#endif
+
+namespace CompiledStaticMesh {
+
+Quantized::Quantized() :
+    Interface()
+{
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+Quantized::~Quantized()
+{
+    Quantized::close();
+}
+
+uint32_t Quantized::zigzag(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t Quantized::unzigzag(uint32_t value)
+{
+    return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+}
+
+void Quantized::encodeNormal(const Version3::Vector3 &normal, int32_t *encoded)
+{
+    float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+
+    if (length <= 0.0f) {
+        encoded[0] = 0;
+        encoded[1] = 0;
+        return;
+    }
+
+    float u = normal.x / length;
+    float v = normal.y / length;
+
+    /*
+        Fold the lower hemisphere over the diagonals of the octahedron
+    */
+    if (normal.z < 0.0f) {
+        float foldedU = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    encoded[0] = static_cast<int32_t>(std::lround(u * NormalScale));
+    encoded[1] = static_cast<int32_t>(std::lround(v * NormalScale));
+}
+
+void Quantized::decodeNormal(int32_t u, int32_t v, Version3::Vector3 *normal)
+{
+    float x = static_cast<float>(u) / NormalScale;
+    float y = static_cast<float>(v) / NormalScale;
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+    float t = z < 0.0f ? -z : 0.0f;
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+
+    float length = std::sqrt(x * x + y * y + z * z);
+    normal->x = x / length;
+    normal->y = y / length;
+    normal->z = z / length;
+}
+
+bool Quantized::quantize(float value, float step, int32_t *quantized)
+{
+    /*
+        Values too far from the origin for the grid fail instead of wrapping
+    */
+    double steps = std::round(static_cast<double>(value) / static_cast<double>(step));
+
+    if (!(steps >= static_cast<double>(std::numeric_limits<int32_t>::min()) &&
+        steps <= static_cast<double>(std::numeric_limits<int32_t>::max()))) {
+        return false;
+    }
+
+    *quantized = static_cast<int32_t>(steps);
+    return true;
+}
+
+void Quantized::encodeBlock(const int32_t *columns, uint32_t columnCount, uint32_t rowCount,
+    std::vector<uint8_t> *data)
+{
+    uint32_t deltas[BlockRows];
+
+    for (uint32_t i = 0; i < columnCount; i++) {
+        const int32_t *column = columns + i * BlockRows;
+        uint32_t bits = 0;
+
+        for (uint32_t j = 1; j < rowCount; j++) {
+            deltas[j] = zigzag(static_cast<int32_t>(static_cast<uint32_t>(column[j]) -
+                static_cast<uint32_t>(column[j - 1])));
+            bits |= deltas[j];
+        }
+
+        /*
+            Widths are rounded up to nibble and byte boundaries so whole groups of deltas
+            unpack without bit shifts
+        */
+        uint8_t width = 0;
+        while (width < 32 && (bits >> width) != 0) {
+            width = width < 8 ? width + 4 : width * 2;
+        }
+
+        /*
+            Width, first value, then the deltas packed little-endian at that width
+        */
+        size_t offset = data->size();
+        size_t packedSize = (static_cast<size_t>(width) * (rowCount - 1) + 7) / 8;
+        data->resize(offset + 1 + sizeof(int32_t) + packedSize, 0);
+
+        uint8_t *target = data->data() + offset;
+        target[0] = width;
+        std::memcpy(target + 1, &column[0], sizeof(int32_t));
+        target += 1 + sizeof(int32_t);
+
+        uint64_t bit = 0;
+
+        for (uint32_t j = 1; j < rowCount && width > 0; j++) {
+            uint64_t value = deltas[j];
+
+            for (uint32_t k = 0; k < width; k++, bit++) {
+                target[bit >> 3] |= static_cast<uint8_t>(((value >> k) & 1) << (bit & 7));
+            }
+        }
+    }
+}
+
+bool Quantized::decodeBlock(const uint8_t *data, size_t size, uint32_t columnCount, uint32_t rowCount,
+    int32_t *columns)
+{
+    const uint8_t *source = data;
+    const uint8_t *sourceEnd = data + size;
+
+    for (uint32_t i = 0; i < columnCount; i++) {
+        int32_t *column = columns + i * BlockRows;
+
+        if (sourceEnd - source < static_cast<ptrdiff_t>(1 + sizeof(int32_t))) {
+            return false;
+        }
+
+        uint32_t width = source[0];
+        if (width != 0 && width != 4 && width != 8 && width != 16 && width != 32) {
+            return false;
+        }
+
+        std::memcpy(&column[0], source + 1, sizeof(int32_t));
+        source += 1 + sizeof(int32_t);
+
+        size_t packedSize = (static_cast<size_t>(width) * (rowCount - 1) + 7) / 8;
+        if (static_cast<size_t>(sourceEnd - source) < packedSize) {
+            return false;
+        }
+
+        uint32_t j = 1;
+
+#if defined(QUANTIZED_SSE2)
+        /*
+            Four deltas per step are widened to 32-bit lanes, unzigzagged and summed
+            in place, then offset by the last value of the previous step
+        */
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i lowNibbles = _mm_set1_epi8(0x0f);
+        __m128i previous = _mm_set1_epi32(column[0]);
+
+        for (; j + 4 <= rowCount; j += 4) {
+            const uint8_t *packed = source + ((static_cast<size_t>(j - 1) * width) >> 3);
+            __m128i deltas;
+
+            switch (width) {
+            case 0:
+                deltas = zero;
+                break;
+
+            case 4: {
+                uint16_t nibbles;
+                std::memcpy(&nibbles, packed, sizeof(nibbles));
+                __m128i bytes = _mm_cvtsi32_si128(nibbles);
+                bytes = _mm_unpacklo_epi8(_mm_and_si128(bytes, lowNibbles),
+                    _mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibbles));
+                deltas = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+                break;
+            }
+
+            case 8: {
+                uint32_t bytes;
+                std::memcpy(&bytes, packed, sizeof(bytes));
+                deltas = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(bytes)), zero), zero);
+                break;
+            }
+
+            case 16:
+                deltas = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(packed)), zero);
+                break;
+
+            default:
+                deltas = _mm_loadu_si128(reinterpret_cast<const __m128i *>(packed));
+                break;
+            }
+
+            deltas = _mm_xor_si128(_mm_srli_epi32(deltas, 1), _mm_sub_epi32(zero, _mm_and_si128(deltas, one)));
+            deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+            deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+
+            __m128i values = _mm_add_epi32(previous, deltas);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(column + j), values);
+            previous = _mm_shuffle_epi32(values, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+#endif
+
+        /*
+            Sections are padded, so every remaining delta is one unaligned 64-bit load and a shift
+        */
+        uint64_t mask = width == 32 ? 0xffffffffull : (1ull << width) - 1;
+        uint32_t value = static_cast<uint32_t>(column[j - 1]);
+
+        for (; j < rowCount; j++) {
+            uint64_t bit = static_cast<uint64_t>(j - 1) * width;
+            uint64_t word;
+            std::memcpy(&word, source + (bit >> 3), sizeof(word));
+
+            value += static_cast<uint32_t>(unzigzag(static_cast<uint32_t>((word >> (bit & 7)) & mask)));
+            column[j] = static_cast<int32_t>(value);
+        }
+
+        source += packedSize;
+    }
+
+    return true;
+}
+
+bool Quantized::encodeRows(SectionType type, const uint8_t *rows, uint32_t rowCount, int32_t *columns) const
+{
+    if (type == VertexSection) {
+        for (uint32_t i = 0; i < rowCount; i++) {
+            const Version3::Vertex *vertex = reinterpret_cast<const Version3::Vertex *>(rows) + i;
+            float position[3] = {vertex->position.x, vertex->position.y, vertex->position.z};
+            float origin[3] = {m_header.positionOrigin.x, m_header.positionOrigin.y, m_header.positionOrigin.z};
+
+            for (uint32_t j = 0; j < 3; j++) {
+                if (!quantize(position[j] - origin[j], m_header.positionStep, &columns[j * BlockRows + i])) {
+                    return false;
+                }
+            }
+
+            int32_t normal[2];
+            encodeNormal(vertex->normal, normal);
+            columns[3 * BlockRows + i] = normal[0];
+            columns[4 * BlockRows + i] = normal[1];
+
+            int32_t color;
+            std::memcpy(&color, &vertex->color, sizeof(int32_t));
+            columns[5 * BlockRows + i] = color;
+        }
+
+        return true;
+    }
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        const Version3::Face *face = reinterpret_cast<const Version3::Face *>(rows) + i;
+        columns[0 * BlockRows + i] = face->material;
+        columns[1 * BlockRows + i] = face->flags;
+
+        for (uint32_t j = 0; j < 3; j++) {
+            columns[(2 + j) * BlockRows + i] = static_cast<int32_t>(face->index[j]);
+        }
+
+        columns[5 * BlockRows + i] = face->lightmapGroup;
+        columns[6 * BlockRows + i] = face->detailGroup;
+
+        for (uint32_t j = 0; j < 3; j++) {
+            if (!quantize(face->textureCoord[j].x, m_header.textureCoordStep,
+                    &columns[(7 + j * 2) * BlockRows + i]) ||
+                !quantize(face->textureCoord[j].y, m_header.textureCoordStep,
+                    &columns[(8 + j * 2) * BlockRows + i]) ||
+                !quantize(face->lightmapCoord[j].x, m_header.lightmapCoordStep,
+                    &columns[(13 + j * 2) * BlockRows + i]) ||
+                !quantize(face->lightmapCoord[j].y, m_header.lightmapCoordStep,
+                    &columns[(14 + j * 2) * BlockRows + i])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void Quantized::decodeRows(SectionType type, const int32_t *columns, uint32_t rowCount, uint8_t *rows) const
+{
+    if (type == VertexSection) {
+        for (uint32_t i = 0; i < rowCount; i++) {
+            Version3::Vertex *vertex = reinterpret_cast<Version3::Vertex *>(rows) + i;
+            vertex->position.x = m_header.positionOrigin.x +
+                static_cast<float>(columns[0 * BlockRows + i]) * m_header.positionStep;
+            vertex->position.y = m_header.positionOrigin.y +
+                static_cast<float>(columns[1 * BlockRows + i]) * m_header.positionStep;
+            vertex->position.z = m_header.positionOrigin.z +
+                static_cast<float>(columns[2 * BlockRows + i]) * m_header.positionStep;
+            decodeNormal(columns[3 * BlockRows + i], columns[4 * BlockRows + i], &vertex->normal);
+            std::memcpy(&vertex->color, &columns[5 * BlockRows + i], sizeof(int32_t));
+        }
+
+        return;
+    }
+
+    for (uint32_t i = 0; i < rowCount; i++) {
+        Version3::Face *face = reinterpret_cast<Version3::Face *>(rows) + i;
+        face->material = static_cast<uint16_t>(columns[0 * BlockRows + i]);
+        face->flags = static_cast<uint16_t>(columns[1 * BlockRows + i]);
+
+        for (uint32_t j = 0; j < 3; j++) {
+            face->index[j] = static_cast<uint32_t>(columns[(2 + j) * BlockRows + i]);
+        }
+
+        face->lightmapGroup = columns[5 * BlockRows + i];
+        face->detailGroup = columns[6 * BlockRows + i];
+
+        for (uint32_t j = 0; j < 3; j++) {
+            face->textureCoord[j].x = static_cast<float>(columns[(7 + j * 2) * BlockRows + i]) *
+                m_header.textureCoordStep;
+            face->textureCoord[j].y = static_cast<float>(columns[(8 + j * 2) * BlockRows + i]) *
+                m_header.textureCoordStep;
+            face->lightmapCoord[j].x = static_cast<float>(columns[(13 + j * 2) * BlockRows + i]) *
+                m_header.lightmapCoordStep;
+            face->lightmapCoord[j].y = static_cast<float>(columns[(14 + j * 2) * BlockRows + i]) *
+                m_header.lightmapCoordStep;
+        }
+    }
+}
+
+bool Quantized::writeSection(SectionType type, Section *section)
+{
+    uint32_t rowSize = type == VertexSection ? sizeof(Version3::Vertex) : sizeof(Version3::Face);
+    uint32_t columnCount = type == VertexSection ? VertexColumns : FaceColumns;
+
+    section->count = static_cast<uint32_t>(m_pending.size() / rowSize);
+    section->blockCount = (section->count + BlockRows - 1) / BlockRows;
+
+    uint32_t threadCount = Parallel::threadCount();
+    if (threadCount > section->blockCount) {
+        threadCount = section->blockCount;
+    }
+
+    std::vector<std::vector<uint8_t>> blocks(section->blockCount);
+    std::vector<uint8_t> threadResults(threadCount, 1);
+
+    if (threadCount > 0) {
+        Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+            std::vector<int32_t> columns(static_cast<size_t>(columnCount) * BlockRows);
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(section->blockCount) * thread / threadCount);
+            uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(section->blockCount) * (thread + 1) / threadCount);
+
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t first = i * BlockRows;
+                uint32_t rowCount = section->count - first < BlockRows ? section->count - first : BlockRows;
+
+                if (!encodeRows(type, m_pending.data() + static_cast<size_t>(first) * rowSize, rowCount,
+                    columns.data())) {
+                    threadResults[thread] = 0;
+                    return;
+                }
+
+                encodeBlock(columns.data(), columnCount, rowCount, &blocks[i]);
+            }
+        });
+    }
+
+    for (uint8_t threadResult : threadResults) {
+        if (threadResult == 0) {
+            return false;
+        }
+    }
+
+    /*
+        Block offset table, then the blocks back to back, then padding for the decoder
+    */
+    std::vector<uint32_t> blockOffsets(section->blockCount + 1, 0);
+
+    for (uint32_t i = 0; i < section->blockCount; i++) {
+        blockOffsets[i + 1] = blockOffsets[i] + static_cast<uint32_t>(blocks[i].size());
+    }
+
+    if (!Interface::getCurrentOffset(&section->dataOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(blockOffsets.data(), sizeof(uint32_t) * blockOffsets.size())) {
+        return false;
+    }
+
+    for (const std::vector<uint8_t> &block : blocks) {
+        if (!Interface::write(block.data(), block.size())) {
+            return false;
+        }
+    }
+
+    uint8_t padding[SectionPadding] = {};
+
+    if (!Interface::write(padding, SectionPadding)) {
+        return false;
+    }
+
+    section->size = static_cast<uint32_t>(sizeof(uint32_t) * blockOffsets.size()) +
+        blockOffsets.back() + SectionPadding;
+
+    m_pending.clear();
+    m_pending.shrink_to_fit();
+
+    return true;
+}
+
+bool Quantized::readSection(SectionType type, const Section &section, void *data)
+{
+    uint32_t rowSize = type == VertexSection ? sizeof(Version3::Vertex) : sizeof(Version3::Face);
+    uint32_t columnCount = type == VertexSection ? VertexColumns : FaceColumns;
+
+    if (section.blockCount != (section.count + BlockRows - 1) / BlockRows) {
+        return false;
+    }
+
+    if (section.blockCount == 0) {
+        return true;
+    }
+
+    size_t tableSize = sizeof(uint32_t) * (static_cast<size_t>(section.blockCount) + 1);
+
+    if (section.size < tableSize + SectionPadding) {
+        return false;
+    }
+
+    std::vector<uint8_t> encoded(section.size);
+
+    if (!Interface::setCurrentOffset(section.dataOffset)) {
+        return false;
+    }
+
+    if (!Interface::read(encoded.data(), encoded.size())) {
+        return false;
+    }
+
+    const uint32_t *blockOffsets = reinterpret_cast<const uint32_t *>(encoded.data());
+    const uint8_t *blockData = encoded.data() + tableSize;
+    size_t blockDataSize = section.size - tableSize - SectionPadding;
+
+    uint32_t threadCount = Parallel::threadCount();
+    if (threadCount > section.blockCount) {
+        threadCount = section.blockCount;
+    }
+
+    std::vector<uint8_t> threadResults(threadCount, 1);
+    uint8_t *rows = reinterpret_cast<uint8_t *>(data);
+
+    Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+        std::vector<int32_t> columns(static_cast<size_t>(columnCount) * BlockRows);
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(section.blockCount) * thread / threadCount);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(section.blockCount) * (thread + 1) / threadCount);
+
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t first = i * BlockRows;
+            uint32_t rowCount = section.count - first < BlockRows ? section.count - first : BlockRows;
+
+            if (blockOffsets[i] > blockOffsets[i + 1] || blockOffsets[i + 1] > blockDataSize ||
+                !decodeBlock(blockData + blockOffsets[i], blockOffsets[i + 1] - blockOffsets[i],
+                columnCount, rowCount, columns.data())) {
+                threadResults[thread] = 0;
+                return;
+            }
+
+            decodeRows(type, columns.data(), rowCount, rows + static_cast<size_t>(first) * rowSize);
+        }
+    });
+
+    for (uint8_t threadResult : threadResults) {
+        if (threadResult == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Quantized::open(const std::string &filename, Interface::Mode mode)
+{
+    Quantized::close();
+
+    if (!Interface::open(filename, mode)) {
+        return false;
+    }
+
+    if (mode == Interface::Write) {
+        m_header.signature = Signature;
+        m_header.version = Version;
+        m_header.headerSize = sizeof(Header);
+        m_header.positionStep = PositionStep;
+        m_header.textureCoordStep = TextureCoordStep;
+        m_header.lightmapCoordStep = LightmapCoordStep;
+        return true;
+    }
+
+    if (!Interface::read(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    if (m_header.signature != Signature || m_header.version != Version ||
+        m_header.headerSize != sizeof(Header) || m_header.source.version != Version3::Version ||
+        !(m_header.positionStep > 0.0f) || !(m_header.textureCoordStep > 0.0f) ||
+        !(m_header.lightmapCoordStep > 0.0f)) {
+        return false;
+    }
+
+    m_format.setHeader(&m_header.source);
+
+    return true;
+}
+
+void Quantized::close()
+{
+    Interface::close();
+    m_pending.clear();
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+uint32_t Quantized::version() const
+{
+    if (!Interface::isOpen()) {
+        return false;
+    }
+
+    return m_header.version;
+}
+
+void Quantized::setVersion(uint32_t version)
+{
+    m_header.version = version;
+}
+
+uint32_t Quantized::flags() const
+{
+    return m_format.flags();
+}
+
+void Quantized::setFlags(uint32_t flags)
+{
+    m_format.setFlags(flags);
+}
+
+uint32_t Quantized::headerSize() const
+{
+    return m_format.headerSize();
+}
+
+const void *Quantized::header() const
+{
+    /*
+        Expose the Version3 header so the mesh can be written back unquantized
+    */
+    return m_format.header();
+}
+
+void Quantized::setHeader(const void *header)
+{
+    m_format.setHeader(header);
+    m_format.setVersion(Version3::Version);
+
+    m_header.materialDataOffset = 0;
+    m_header.materialDataEnd = 0;
+    std::memset(&m_header.faces, 0, sizeof(Section));
+    std::memset(&m_header.vertices, 0, sizeof(Section));
+}
+
+uint32_t Quantized::faceCount() const
+{
+    return m_header.faces.count;
+}
+
+uint32_t Quantized::faceSize() const
+{
+    return m_format.faceSize();
+}
+
+uint16_t Quantized::faceMaterialIndex(const void *faceData, uint32_t faceIndex) const
+{
+    return m_format.faceMaterialIndex(faceData, faceIndex);
+}
+
+int32_t Quantized::faceLightmapGroup(const void *faceData, uint32_t faceIndex) const
+{
+    return m_format.faceLightmapGroup(faceData, faceIndex);
+}
+
+void Quantized::faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    float *lightmapCoord) const
+{
+    m_format.faceLightmapCoord(faceData, faceIndex, vertexIndex, lightmapCoord);
+}
+
+uint32_t Quantized::faceVertexIndex(const void *faceData, uint32_t faceIndex,
+    uint32_t vertexIndex) const
+{
+    return m_format.faceVertexIndex(faceData, faceIndex, vertexIndex);
+}
+
+void Quantized::setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    uint32_t index) const
+{
+    m_format.setFaceVertexIndex(faceData, faceIndex, vertexIndex, index);
+}
+
+uint32_t Quantized::vertexCount() const
+{
+    return m_header.vertices.count;
+}
+
+void Quantized::setVertexCount(uint32_t vertexCount)
+{
+    m_header.vertices.count = vertexCount;
+}
+
+uint32_t Quantized::vertexSize() const
+{
+    return m_format.vertexSize();
+}
+
+void Quantized::vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const
+{
+    m_format.vertex(faceData, faceIndex, vertexData, vertexIndex, position, textureCoord, normal);
+}
+
+void Quantized::vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, uint8_t *color) const
+{
+    m_format.vertexColor(faceData, faceIndex, vertexData, vertexIndex, color);
+}
+
+void Quantized::vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const
+{
+    m_format.vertexPosition(vertexData, vertexIndex, position);
+}
+
+void Quantized::vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const
+{
+    m_format.vertexNormal(vertexData, vertexIndex, normal);
+}
+
+bool Quantized::beginWriteMaterials()
+{
+    if (!Interface::getCurrentOffset(&m_header.materialDataOffset)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Quantized::writeMaterial(const std::string &name)
+{
+    if (!Interface::write(name.c_str(), name.size())) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Quantized::endWriteMaterials()
+{
+    if (!Interface::write("\0", 1)) {
+        return false;
+    }
+
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    if (m_header.materialDataOffset > currentOffset) {
+        return false;
+    }
+
+    m_header.materialDataEnd = currentOffset;
+
+    return true;
+}
+
+bool Quantized::readMaterials(std::vector<std::string> *materials)
+{
+    materials->clear();
+
+    if (!Interface::setCurrentOffset(m_header.materialDataOffset)) {
+        return false;
+    }
+
+    std::string material;
+
+    while (true) {
+        char c;
+        if (!Interface::read(&c, sizeof(char))) {
+            return false;
+        }
+
+        if (c == ' ') {
+            if (!material.empty()) {
+                materials->push_back(material);
+                material.clear();
+            }
+
+            continue;
+        }
+
+        if (c == '\0') {
+            break;
+        }
+
+        material.push_back(c);
+    }
+
+    return true;
+}
+
+bool Quantized::beginWriteFaces()
+{
+    m_pending.clear();
+    m_header.faces.count = 0;
+
+    return true;
+}
+
+bool Quantized::writeFace(void *face)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(face);
+    m_pending.insert(m_pending.end(), data, data + sizeof(Version3::Face));
+
+    return true;
+}
+
+bool Quantized::endWriteFaces()
+{
+    return writeSection(FaceSection, &m_header.faces);
+}
+
+bool Quantized::readFaces(void *faces)
+{
+    return readSection(FaceSection, m_header.faces, faces);
+}
+
+bool Quantized::beginWriteVertices()
+{
+    m_pending.clear();
+    m_header.vertices.count = 0;
+
+    return true;
+}
+
+bool Quantized::writeVertex(void *vertex)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(vertex);
+    m_pending.insert(m_pending.end(), data, data + sizeof(Version3::Vertex));
+
+    return true;
+}
+
+bool Quantized::endWriteVertices()
+{
+    /*
+        The position grid starts at the minimum corner so quantized values stay small
+    */
+    uint32_t count = static_cast<uint32_t>(m_pending.size() / sizeof(Version3::Vertex));
+    const Version3::Vertex *vertices = reinterpret_cast<const Version3::Vertex *>(m_pending.data());
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (i == 0 || vertices[i].position.x < m_header.positionOrigin.x) {
+            m_header.positionOrigin.x = vertices[i].position.x;
+        }
+
+        if (i == 0 || vertices[i].position.y < m_header.positionOrigin.y) {
+            m_header.positionOrigin.y = vertices[i].position.y;
+        }
+
+        if (i == 0 || vertices[i].position.z < m_header.positionOrigin.z) {
+            m_header.positionOrigin.z = vertices[i].position.z;
+        }
+    }
+
+    return writeSection(VertexSection, &m_header.vertices);
+}
+
+bool Quantized::readVertices(void *vertices)
+{
+    return readSection(VertexSection, m_header.vertices, vertices);
+}
+
+bool Quantized::writeHeader()
+{
+    std::memcpy(&m_header.source, m_format.header(), sizeof(Version3::Header));
+
+    if (!Interface::setCurrentOffset(0)) {
+        return false;
+    }
+
+    if (!Interface::write(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace CompiledStaticMesh
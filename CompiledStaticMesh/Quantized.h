@@ -0,0 +1,128 @@
+#ifndef COMPILEDSTATICMESH_QUANTIZED_H
+#define COMPILEDSTATICMESH_QUANTIZED_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Interface.h"
+#include "Version3.h"
+
+namespace CompiledStaticMesh {
+
+/*
+    Archival form of Version3: positions and texture coordinates are snapped to
+    fixed grids, normals are octahedron encoded, and every field is stored as
+    deltas packed at nibble or byte aligned widths in independent blocks of rows
+*/
+class Quantized: public Interface
+{
+
+public:
+    static constexpr const uint32_t Version = 49;
+    static constexpr const uint32_t Signature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'Q';
+    static constexpr const uint32_t BlockRows = 64;
+    static constexpr const uint32_t VertexColumns = 6;
+    static constexpr const uint32_t FaceColumns = 19;
+    static constexpr const uint32_t SectionPadding = 8;
+    static constexpr const float PositionStep = 1.0f / 64.0f;
+    static constexpr const float TextureCoordStep = 1.0f / 4096.0f;
+    static constexpr const float LightmapCoordStep = 1.0f / 65536.0f;
+    static constexpr const float NormalScale = 32767.0f;
+
+    enum SectionType {
+        FaceSection,
+        VertexSection
+    };
+
+    struct Section {
+        uint32_t dataOffset;
+        uint32_t count;
+        uint32_t blockCount;
+        uint32_t size;
+    };
+
+    struct Header {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t headerSize;
+        float positionStep;
+        float textureCoordStep;
+        float lightmapCoordStep;
+        Version3::Vector3 positionOrigin;
+        uint32_t materialDataOffset;
+        uint32_t materialDataEnd;
+        Section faces;
+        Section vertices;
+        Version3::Header source;
+    };
+
+private:
+    Header m_header;
+    Version3 m_format;
+    std::vector<uint8_t> m_pending;
+
+    static uint32_t zigzag(int32_t value);
+    static int32_t unzigzag(uint32_t value);
+    static void encodeNormal(const Version3::Vector3 &normal, int32_t *encoded);
+    static void decodeNormal(int32_t u, int32_t v, Version3::Vector3 *normal);
+    static bool quantize(float value, float step, int32_t *quantized);
+    static void encodeBlock(const int32_t *columns, uint32_t columnCount, uint32_t rowCount,
+        std::vector<uint8_t> *data);
+    static bool decodeBlock(const uint8_t *data, size_t size, uint32_t columnCount, uint32_t rowCount,
+        int32_t *columns);
+    bool encodeRows(SectionType type, const uint8_t *rows, uint32_t rowCount, int32_t *columns) const;
+    void decodeRows(SectionType type, const int32_t *columns, uint32_t rowCount, uint8_t *rows) const;
+    bool writeSection(SectionType type, Section *section);
+    bool readSection(SectionType type, const Section &section, void *data);
+
+public:
+    Quantized();
+    ~Quantized() override;
+    bool open(const std::string &filename, Interface::Mode mode) override;
+    void close() override;
+    uint32_t version() const override;
+    void setVersion(uint32_t version) override;
+    uint32_t flags() const override;
+    void setFlags(uint32_t flags) override;
+    uint32_t headerSize() const override;
+    const void *header() const override;
+    void setHeader(const void *header) override;
+    uint32_t faceCount() const override;
+    uint32_t faceSize() const override;
+    uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const override;
+    int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const override;
+    void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const override;
+    uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const override;
+    void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const override;
+    uint32_t vertexCount() const override;
+    void setVertexCount(uint32_t vertexCount) override;
+    uint32_t vertexSize() const override;
+    void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const override;
+    void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const override;
+    void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const override;
+    void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const override;
+    bool beginWriteMaterials() override;
+    bool writeMaterial(const std::string &name) override;
+    bool endWriteMaterials() override;
+    bool readMaterials(std::vector<std::string> *materials) override;
+    bool beginWriteFaces() override;
+    bool writeFace(void *face) override;
+    bool endWriteFaces() override;
+    bool readFaces(void *faces) override;
+    bool beginWriteVertices() override;
+    bool writeVertex(void *vertex) override;
+    bool endWriteVertices() override;
+    bool readVertices(void *vertices) override;
+    bool writeHeader() override;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_QUANTIZED_H
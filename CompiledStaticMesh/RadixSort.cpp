@@ -0,0 +1,128 @@
+#include <cstring>
+#include "Parallel.h"
+#include "RadixSort.h"
+
+namespace CompiledStaticMesh {
+
+RadixSort::RadixSort() :
+    m_buffer(0)
+{
+
+}
+
+void RadixSort::sort(const uint32_t *keys, uint32_t count)
+{
+    m_buffer = 0;
+
+    for (uint32_t i = 0; i < 2; i++) {
+        m_keys[i].resize(count);
+        m_indices[i].resize(count);
+    }
+
+    std::memcpy(m_keys[0].data(), keys, sizeof(uint32_t) * count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        m_indices[0][i] = i;
+    }
+
+    if (count < 2) {
+        return;
+    }
+
+    /*
+        Ranges are fixed per pass so the scatter writes each thread's keys into
+        the slots its histogram reserved, keeping the sort stable
+    */
+    uint32_t threadCount = Parallel::threadCount(count);
+    m_histograms.resize(static_cast<size_t>(threadCount) * DigitCount);
+
+    for (uint32_t pass = 0; pass < PassCount; pass++) {
+        uint32_t shift = pass * DigitBits;
+        const uint32_t *sourceKeys = m_keys[m_buffer].data();
+        const uint32_t *sourceIndices = m_indices[m_buffer].data();
+        uint32_t *targetKeys = m_keys[m_buffer ^ 1].data();
+        uint32_t *targetIndices = m_indices[m_buffer ^ 1].data();
+
+        Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+            uint32_t *histogram = m_histograms.data() + static_cast<size_t>(thread) * DigitCount;
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(count) * thread / threadCount);
+            uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(count) * (thread + 1) / threadCount);
+
+            std::memset(histogram, 0, sizeof(uint32_t) * DigitCount);
+
+            for (uint32_t i = begin; i < end; i++) {
+                histogram[(sourceKeys[i] >> shift) & (DigitCount - 1)]++;
+            }
+        });
+
+        /*
+            Skip passes where every key shares the same digit
+        */
+        bool uniform = false;
+
+        for (uint32_t digit = 0; digit < DigitCount; digit++) {
+            uint32_t total = 0;
+
+            for (uint32_t thread = 0; thread < threadCount; thread++) {
+                total += m_histograms[static_cast<size_t>(thread) * DigitCount + digit];
+            }
+
+            if (total == count) {
+                uniform = true;
+                break;
+            }
+
+            if (total != 0) {
+                break;
+            }
+        }
+
+        if (uniform) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+
+        for (uint32_t digit = 0; digit < DigitCount; digit++) {
+            for (uint32_t thread = 0; thread < threadCount; thread++) {
+                uint32_t &bucket = m_histograms[static_cast<size_t>(thread) * DigitCount + digit];
+                uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+        }
+
+        Parallel::forEachThread(threadCount, [&](uint32_t thread) {
+            uint32_t *histogram = m_histograms.data() + static_cast<size_t>(thread) * DigitCount;
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(count) * thread / threadCount);
+            uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(count) * (thread + 1) / threadCount);
+
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t target = histogram[(sourceKeys[i] >> shift) & (DigitCount - 1)]++;
+                targetKeys[target] = sourceKeys[i];
+                targetIndices[target] = sourceIndices[i];
+            }
+        });
+
+        m_buffer ^= 1;
+    }
+}
+
+const std::vector<uint32_t> &RadixSort::indices() const
+{
+    return m_indices[m_buffer];
+}
+
+uint32_t RadixSort::floatKey(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    if (bits & 0x80000000) {
+        return ~bits;
+    }
+
+    return bits | 0x80000000;
+}
+
+} // namespace CompiledStaticMesh
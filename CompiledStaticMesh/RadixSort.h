@@ -0,0 +1,33 @@
+#ifndef COMPILEDSTATICMESH_RADIXSORT_H
+#define COMPILEDSTATICMESH_RADIXSORT_H
+
+#include <cstdint>
+#include <vector>
+
+namespace CompiledStaticMesh {
+
+class RadixSort
+{
+
+public:
+    static constexpr const uint32_t DigitBits = 8;
+    static constexpr const uint32_t DigitCount = 1 << DigitBits;
+    static constexpr const uint32_t PassCount = 32 / DigitBits;
+
+private:
+    std::vector<uint32_t> m_keys[2];
+    std::vector<uint32_t> m_indices[2];
+    std::vector<uint32_t> m_histograms;
+    uint32_t m_buffer;
+
+public:
+    RadixSort();
+    void sort(const uint32_t *keys, uint32_t count);
+    const std::vector<uint32_t> &indices() const;
+    static uint32_t floatKey(float value);
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_RADIXSORT_H
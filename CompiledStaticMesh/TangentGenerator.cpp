@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Parallel.h"
+#include "TangentGenerator.h"
+
+namespace CompiledStaticMesh {
+
+static const float *attribute(const void *vertexData, const TangentGenerator::Layout &layout,
+    uint32_t vertexIndex, uint32_t offset)
+{
+    return reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(vertexData) +
+        static_cast<size_t>(vertexIndex) * layout.stride + offset);
+}
+
+static float normalize(float *vector)
+{
+    float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+
+    if (length > 0.0f) {
+        vector[0] /= length;
+        vector[1] /= length;
+        vector[2] /= length;
+    }
+
+    return length;
+}
+
+static void orthogonalize(float *vector, const float *normal)
+{
+    float dot = vector[0] * normal[0] + vector[1] * normal[1] + vector[2] * normal[2];
+    vector[0] -= normal[0] * dot;
+    vector[1] -= normal[1] * dot;
+    vector[2] -= normal[2] * dot;
+}
+
+static bool sameVertex(const void *vertexData, const TangentGenerator::Layout &layout,
+    uint32_t a, uint32_t b)
+{
+    return std::memcmp(attribute(vertexData, layout, a, layout.positionOffset),
+            attribute(vertexData, layout, b, layout.positionOffset), sizeof(float) * 3) == 0 &&
+        std::memcmp(attribute(vertexData, layout, a, layout.normalOffset),
+            attribute(vertexData, layout, b, layout.normalOffset), sizeof(float) * 3) == 0 &&
+        std::memcmp(attribute(vertexData, layout, a, layout.textureCoordOffset),
+            attribute(vertexData, layout, b, layout.textureCoordOffset), sizeof(float) * 2) == 0;
+}
+
+bool TangentGenerator::generate(const void *vertexData, const Layout &layout,
+    const std::vector<Range> &ranges, uint32_t vertexCount)
+{
+    m_tangents.assign(static_cast<size_t>(vertexCount) * 6, 0.0f);
+
+    if (vertexData == nullptr) {
+        return false;
+    }
+
+    std::vector<uint32_t> triangles;
+
+    for (const Range &range : ranges) {
+        if (range.offset + range.count > vertexCount) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i + 2 < range.count; i += 3) {
+            triangles.push_back(range.offset + i);
+        }
+    }
+
+    uint32_t triangleCount = static_cast<uint32_t>(triangles.size());
+    uint32_t threadCount = Parallel::threadCount(triangleCount);
+    uint32_t partitionCount = threadCount;
+
+    /*
+        Per corner tangent contribution, weighted by the corner angle, and the
+        orientation of the triangle in texture space
+    */
+    std::vector<float> contributions(static_cast<size_t>(vertexCount) * 3, 0.0f);
+    std::vector<uint8_t> orientations(vertexCount, 0);
+    std::vector<std::vector<std::vector<Corner>>> threadCorners(threadCount,
+        std::vector<std::vector<Corner>>(partitionCount));
+
+    Parallel::forEach(triangleCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t vertex = triangles[i];
+            const float *position[3];
+            const float *textureCoord[3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                position[j] = attribute(vertexData, layout, vertex + j, layout.positionOffset);
+                textureCoord[j] = attribute(vertexData, layout, vertex + j, layout.textureCoordOffset);
+            }
+
+            float edge[2][3];
+            float textureEdge[2][2];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                edge[0][j] = position[1][j] - position[0][j];
+                edge[1][j] = position[2][j] - position[0][j];
+            }
+
+            for (uint32_t j = 0; j < 2; j++) {
+                textureEdge[0][j] = textureCoord[1][j] - textureCoord[0][j];
+                textureEdge[1][j] = textureCoord[2][j] - textureCoord[0][j];
+            }
+
+            float area = textureEdge[0][0] * textureEdge[1][1] - textureEdge[1][0] * textureEdge[0][1];
+            float direction[3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                direction[j] = edge[0][j] * textureEdge[1][1] - edge[1][j] * textureEdge[0][1];
+
+                if (area < 0.0f) {
+                    direction[j] = -direction[j];
+                }
+            }
+
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t corner = vertex + j;
+                const float *normal = attribute(vertexData, layout, corner, layout.normalOffset);
+
+                float first[3];
+                float second[3];
+
+                for (uint32_t k = 0; k < 3; k++) {
+                    first[k] = position[(j + 1) % 3][k] - position[j][k];
+                    second[k] = position[(j + 2) % 3][k] - position[j][k];
+                }
+
+                orthogonalize(first, normal);
+                orthogonalize(second, normal);
+
+                float angle = 0.0f;
+
+                if (normalize(first) > 0.0f && normalize(second) > 0.0f) {
+                    float cos = first[0] * second[0] + first[1] * second[1] + first[2] * second[2];
+                    angle = std::acos(std::fmax(-1.0f, std::fmin(1.0f, cos)));
+                }
+
+                float tangent[3] = { direction[0], direction[1], direction[2] };
+                orthogonalize(tangent, normal);
+
+                if (area != 0.0f && normalize(tangent) > 0.0f) {
+                    float *contribution = &contributions[static_cast<size_t>(corner) * 3];
+                    contribution[0] = tangent[0] * angle;
+                    contribution[1] = tangent[1] * angle;
+                    contribution[2] = tangent[2] * angle;
+                }
+
+                orientations[corner] = area >= 0.0f ? 1 : 0;
+
+                /*
+                    Corners with equal position, normal, texture coordinate and
+                    orientation share one tangent frame
+                */
+                uint64_t hash = 0xcbf29ce484222325ULL ^ orientations[corner];
+                const uint8_t *bytes[3] = {
+                    reinterpret_cast<const uint8_t *>(position[j]),
+                    reinterpret_cast<const uint8_t *>(normal),
+                    reinterpret_cast<const uint8_t *>(textureCoord[j])
+                };
+                const size_t sizes[3] = { sizeof(float) * 3, sizeof(float) * 3, sizeof(float) * 2 };
+
+                for (uint32_t k = 0; k < 3; k++) {
+                    for (size_t l = 0; l < sizes[k]; l++) {
+                        hash = (hash ^ bytes[k][l]) * 0x100000001b3ULL;
+                    }
+                }
+
+                Corner item;
+                item.hash = hash;
+                item.vertex = corner;
+                threadCorners[thread][static_cast<uint32_t>(hash % partitionCount)].push_back(item);
+            }
+        }
+    });
+
+    Parallel::forEachThread(partitionCount, [&](uint32_t partition) {
+        std::vector<Corner> corners;
+
+        for (uint32_t i = 0; i < threadCount; i++) {
+            std::vector<Corner> &threadPartition = threadCorners[i][partition];
+            corners.insert(corners.end(), threadPartition.begin(), threadPartition.end());
+            threadPartition = std::vector<Corner>();
+        }
+
+        std::sort(corners.begin(), corners.end(), [](const Corner &a, const Corner &b) {
+            return a.hash < b.hash || (a.hash == b.hash && a.vertex < b.vertex);
+        });
+
+        std::vector<uint32_t> group;
+
+        for (size_t i = 0; i < corners.size();) {
+            size_t j = i + 1;
+
+            while (j < corners.size() && corners[j].hash == corners[i].hash) {
+                j++;
+            }
+
+            /*
+                Equal hashes are nearly always equal vertices, still split real collisions
+            */
+            for (size_t k = i; k < j; k++) {
+                uint32_t vertex = corners[k].vertex;
+                if (vertex == UINT32_MAX) {
+                    continue;
+                }
+
+                group.clear();
+
+                for (size_t l = k; l < j; l++) {
+                    uint32_t other = corners[l].vertex;
+
+                    if (other != UINT32_MAX && orientations[other] == orientations[vertex] &&
+                        sameVertex(vertexData, layout, vertex, other)) {
+                        group.push_back(other);
+                        corners[l].vertex = UINT32_MAX;
+                    }
+                }
+
+                const float *normal = attribute(vertexData, layout, vertex, layout.normalOffset);
+                float tangent[3] = { 0.0f, 0.0f, 0.0f };
+
+                for (uint32_t other : group) {
+                    tangent[0] += contributions[static_cast<size_t>(other) * 3 + 0];
+                    tangent[1] += contributions[static_cast<size_t>(other) * 3 + 1];
+                    tangent[2] += contributions[static_cast<size_t>(other) * 3 + 2];
+                }
+
+                orthogonalize(tangent, normal);
+
+                if (!(normalize(tangent) > 0.0f)) {
+                    float axis[3] = { 1.0f, 0.0f, 0.0f };
+
+                    if (std::fabs(normal[0]) > 0.9f) {
+                        axis[0] = 0.0f;
+                        axis[1] = 1.0f;
+                    }
+
+                    tangent[0] = axis[0];
+                    tangent[1] = axis[1];
+                    tangent[2] = axis[2];
+                    orthogonalize(tangent, normal);
+                    normalize(tangent);
+                }
+
+                float sign = orientations[vertex] != 0 ? 1.0f : -1.0f;
+                float binormal[3] = {
+                    (normal[1] * tangent[2] - normal[2] * tangent[1]) * sign,
+                    (normal[2] * tangent[0] - normal[0] * tangent[2]) * sign,
+                    (normal[0] * tangent[1] - normal[1] * tangent[0]) * sign
+                };
+
+                for (uint32_t other : group) {
+                    float *frame = &m_tangents[static_cast<size_t>(other) * 6];
+                    std::memcpy(frame, tangent, sizeof(float) * 3);
+                    std::memcpy(frame + 3, binormal, sizeof(float) * 3);
+                }
+            }
+
+            i = j;
+        }
+    });
+
+    return true;
+}
+
+const float *TangentGenerator::tangent(uint32_t vertexIndex) const
+{
+    return &m_tangents[static_cast<size_t>(vertexIndex) * 6];
+}
+
+const float *TangentGenerator::binormal(uint32_t vertexIndex) const
+{
+    return &m_tangents[static_cast<size_t>(vertexIndex) * 6 + 3];
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,43 @@
+#ifndef COMPILEDSTATICMESH_TANGENTGENERATOR_H
+#define COMPILEDSTATICMESH_TANGENTGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+namespace CompiledStaticMesh {
+
+class TangentGenerator
+{
+
+public:
+    struct Layout {
+        uint32_t stride;
+        uint32_t positionOffset;
+        uint32_t textureCoordOffset;
+        uint32_t normalOffset;
+    };
+
+    struct Range {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+private:
+    struct Corner {
+        uint64_t hash;
+        uint32_t vertex;
+    };
+
+    std::vector<float> m_tangents;
+
+public:
+    bool generate(const void *vertexData, const Layout &layout, const std::vector<Range> &ranges,
+        uint32_t vertexCount);
+    const float *tangent(uint32_t vertexIndex) const;
+    const float *binormal(uint32_t vertexIndex) const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_TANGENTGENERATOR_H
@@ -0,0 +1,744 @@
+#include <algorithm>
+#include <cstring>
+#include "Tiled.h"
+#include "Version2.h"
+#include "Version3.h"
+
+namespace CompiledStaticMesh {
+
+Tiled::Tiled() :
+    Interface(),
+    m_format(nullptr),
+    m_faceCount(0),
+    m_vertexCount(0)
+{
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+Tiled::~Tiled()
+{
+    Tiled::close();
+}
+
+bool Tiled::createFormat(uint32_t version)
+{
+    if (m_format != nullptr) {
+        delete m_format;
+        m_format = nullptr;
+    }
+
+    switch (version) {
+    case Version2::Version:
+        m_format = new Version2;
+        break;
+
+    case Version3::Version:
+        m_format = new Version3;
+        break;
+
+    default:
+        return false;
+    }
+
+    if (m_format->headerSize() > MaxSourceHeaderSize) {
+        return false;
+    }
+
+    m_header.sourceVersion = version;
+    m_header.sourceHeaderSize = m_format->headerSize();
+
+    return true;
+}
+
+void Tiled::splitTiles(const std::vector<float> &centers, std::vector<uint32_t> *faceOrder,
+    std::vector<uint32_t> *tileEnds) const
+{
+    /*
+        Median split along the longest axis of the face centers, depth first so
+        neighbouring tiles stay close in the file
+    */
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    ranges.push_back(std::make_pair(0u, static_cast<uint32_t>(faceOrder->size())));
+
+    while (!ranges.empty()) {
+        uint32_t begin = ranges.back().first;
+        uint32_t end = ranges.back().second;
+        ranges.pop_back();
+
+        if (end - begin <= TileFaceCount) {
+            tileEnds->push_back(end);
+            continue;
+        }
+
+        float boundsMin[3];
+        float boundsMax[3];
+
+        for (uint32_t i = begin; i < end; i++) {
+            const float *center = &centers[(*faceOrder)[i] * 3];
+
+            for (uint32_t j = 0; j < 3; j++) {
+                if (i == begin || center[j] < boundsMin[j]) {
+                    boundsMin[j] = center[j];
+                }
+
+                if (i == begin || center[j] > boundsMax[j]) {
+                    boundsMax[j] = center[j];
+                }
+            }
+        }
+
+        uint32_t axis = 0;
+
+        for (uint32_t j = 1; j < 3; j++) {
+            if (boundsMax[j] - boundsMin[j] > boundsMax[axis] - boundsMin[axis]) {
+                axis = j;
+            }
+        }
+
+        uint32_t middle = begin + (end - begin) / 2;
+
+        std::nth_element(faceOrder->begin() + begin, faceOrder->begin() + middle, faceOrder->begin() + end,
+            [&](uint32_t a, uint32_t b) {
+                return centers[a * 3 + axis] < centers[b * 3 + axis];
+            });
+
+        ranges.push_back(std::make_pair(middle, end));
+        ranges.push_back(std::make_pair(begin, middle));
+    }
+}
+
+bool Tiled::writeTiles()
+{
+    uint32_t faceSize = m_header.faceSize;
+    uint32_t vertexSize = m_header.vertexSize;
+    uint32_t faceCount = static_cast<uint32_t>(m_pendingFaces.size() / faceSize);
+    uint32_t vertexCount = static_cast<uint32_t>(m_pendingVertices.size() / vertexSize);
+
+    /*
+        Face centers decide the tile, out of range indices are ignored
+    */
+    std::vector<float> centers(static_cast<size_t>(faceCount) * 3, 0.0f);
+
+    for (uint32_t i = 0; i < faceCount; i++) {
+        uint32_t validCount = 0;
+
+        for (uint32_t j = 0; j < 3; j++) {
+            uint32_t index = m_format->faceVertexIndex(m_pendingFaces.data(), i, j);
+            if (index >= vertexCount) {
+                continue;
+            }
+
+            float position[3];
+            m_format->vertexPosition(m_pendingVertices.data(), index, position);
+
+            for (uint32_t k = 0; k < 3; k++) {
+                centers[i * 3 + k] += position[k];
+            }
+
+            validCount++;
+        }
+
+        if (validCount > 0) {
+            for (uint32_t k = 0; k < 3; k++) {
+                centers[i * 3 + k] /= static_cast<float>(validCount);
+            }
+        }
+    }
+
+    std::vector<uint32_t> faceOrder(faceCount);
+
+    for (uint32_t i = 0; i < faceCount; i++) {
+        faceOrder[i] = i;
+    }
+
+    std::vector<uint32_t> tileEnds;
+
+    if (faceCount > 0) {
+        splitTiles(centers, &faceOrder, &tileEnds);
+    }
+
+    /*
+        Write every tile as its faces followed by the vertices they use,
+        with indices local to the tile
+    */
+    std::vector<uint32_t> vertexRemap(vertexCount, InvalidIndex);
+    std::vector<uint32_t> tileVertices;
+    std::vector<uint8_t> tileFaces;
+    std::vector<uint8_t> tileVertexData;
+
+    m_tiles.clear();
+    m_tiles.reserve(tileEnds.size());
+
+    uint32_t begin = 0;
+
+    for (uint32_t end : tileEnds) {
+        Tile tile;
+        tile.faceCount = end - begin;
+        tile.vertexCount = 0;
+
+        tileFaces.resize(static_cast<size_t>(tile.faceCount) * faceSize);
+        tileVertices.clear();
+
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t faceIndex = i - begin;
+            std::memcpy(tileFaces.data() + static_cast<size_t>(faceIndex) * faceSize,
+                m_pendingFaces.data() + static_cast<size_t>(faceOrder[i]) * faceSize, faceSize);
+
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t index = m_format->faceVertexIndex(tileFaces.data(), faceIndex, j);
+
+                if (index >= vertexCount) {
+                    m_format->setFaceVertexIndex(tileFaces.data(), faceIndex, j, InvalidIndex);
+                    continue;
+                }
+
+                if (vertexRemap[index] == InvalidIndex) {
+                    vertexRemap[index] = static_cast<uint32_t>(tileVertices.size());
+                    tileVertices.push_back(index);
+                }
+
+                m_format->setFaceVertexIndex(tileFaces.data(), faceIndex, j, vertexRemap[index]);
+            }
+        }
+
+        tile.vertexCount = static_cast<uint32_t>(tileVertices.size());
+        tileVertexData.resize(static_cast<size_t>(tile.vertexCount) * vertexSize);
+
+        for (uint32_t i = 0; i < 3; i++) {
+            tile.boundsMin[i] = 0.0f;
+            tile.boundsMax[i] = 0.0f;
+        }
+
+        for (uint32_t i = 0; i < tile.vertexCount; i++) {
+            uint32_t index = tileVertices[i];
+            std::memcpy(tileVertexData.data() + static_cast<size_t>(i) * vertexSize,
+                m_pendingVertices.data() + static_cast<size_t>(index) * vertexSize, vertexSize);
+            vertexRemap[index] = InvalidIndex;
+
+            float position[3];
+            m_format->vertexPosition(m_pendingVertices.data(), index, position);
+
+            for (uint32_t j = 0; j < 3; j++) {
+                if (i == 0 || position[j] < tile.boundsMin[j]) {
+                    tile.boundsMin[j] = position[j];
+                }
+
+                if (i == 0 || position[j] > tile.boundsMax[j]) {
+                    tile.boundsMax[j] = position[j];
+                }
+            }
+        }
+
+        if (!Interface::getCurrentOffset(&tile.dataOffset)) {
+            return false;
+        }
+
+        if (!Interface::write(tileFaces.data(), tileFaces.size()) ||
+            !Interface::write(tileVertexData.data(), tileVertexData.size())) {
+            return false;
+        }
+
+        m_tiles.push_back(tile);
+        begin = end;
+    }
+
+    /*
+        Chunk table
+    */
+    if (!Interface::getCurrentOffset(&m_header.tileTableOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(m_tiles.data(), sizeof(Tile) * m_tiles.size())) {
+        return false;
+    }
+
+    m_header.tileCount = static_cast<uint32_t>(m_tiles.size());
+
+    m_pendingFaces.clear();
+    m_pendingFaces.shrink_to_fit();
+    m_pendingVertices.clear();
+    m_pendingVertices.shrink_to_fit();
+
+    return selectRegion(nullptr, 0);
+}
+
+bool Tiled::tileInRegion(const Tile &tile, const float *planes, uint32_t planeCount)
+{
+    /*
+        Outside as soon as the box corner furthest along a plane normal is behind it
+    */
+    for (uint32_t i = 0; i < planeCount; i++) {
+        const float *plane = planes + i * 4;
+        float distance = plane[3];
+
+        for (uint32_t j = 0; j < 3; j++) {
+            distance += plane[j] * (plane[j] >= 0.0f ? tile.boundsMax[j] : tile.boundsMin[j]);
+        }
+
+        if (distance < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Tiled::open(const std::string &filename, Interface::Mode mode)
+{
+    Tiled::close();
+
+    if (!Interface::open(filename, mode)) {
+        return false;
+    }
+
+    if (mode == Interface::Write) {
+        m_header.signature = Signature;
+        m_header.version = Version;
+        m_header.headerSize = sizeof(Header);
+        return true;
+    }
+
+    if (!Interface::read(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    if (m_header.signature != Signature || m_header.version != Version ||
+        m_header.headerSize != sizeof(Header)) {
+        return false;
+    }
+
+    if (!createFormat(m_header.sourceVersion) || m_header.sourceHeaderSize != m_format->headerSize()) {
+        return false;
+    }
+
+    m_format->setHeader(m_header.sourceHeader);
+
+    if (m_header.faceSize != m_format->faceSize() || m_header.vertexSize != m_format->vertexSize()) {
+        return false;
+    }
+
+    /*
+        Read and validate the chunk table
+    */
+    uint32_t fileSize;
+
+    if (!Interface::getSize(&fileSize)) {
+        return false;
+    }
+
+    if (m_header.tileTableOffset > fileSize ||
+        static_cast<uint64_t>(m_header.tileCount) * sizeof(Tile) > fileSize - m_header.tileTableOffset) {
+        return false;
+    }
+
+    m_tiles.resize(m_header.tileCount);
+
+    if (!Interface::setCurrentOffset(m_header.tileTableOffset) ||
+        !Interface::read(m_tiles.data(), sizeof(Tile) * m_tiles.size())) {
+        return false;
+    }
+
+    for (const Tile &tile : m_tiles) {
+        uint64_t tileSize = static_cast<uint64_t>(tile.faceCount) * m_header.faceSize +
+            static_cast<uint64_t>(tile.vertexCount) * m_header.vertexSize;
+
+        if (tile.dataOffset > fileSize || tileSize > fileSize - tile.dataOffset) {
+            return false;
+        }
+    }
+
+    return selectRegion(nullptr, 0);
+}
+
+void Tiled::close()
+{
+    Interface::close();
+
+    if (m_format != nullptr) {
+        delete m_format;
+        m_format = nullptr;
+    }
+
+    m_tiles.clear();
+    m_selectedTiles.clear();
+    m_faceCount = 0;
+    m_vertexCount = 0;
+    m_pendingFaces.clear();
+    m_pendingVertices.clear();
+    std::memset(&m_header, 0, sizeof(Header));
+}
+
+uint32_t Tiled::version() const
+{
+    if (!Interface::isOpen()) {
+        return false;
+    }
+
+    return m_header.version;
+}
+
+void Tiled::setVersion(uint32_t version)
+{
+    m_header.version = version;
+}
+
+uint32_t Tiled::flags() const
+{
+    if (m_format == nullptr) {
+        return 0;
+    }
+
+    return m_format->flags();
+}
+
+void Tiled::setFlags(uint32_t flags)
+{
+    if (m_format != nullptr) {
+        m_format->setFlags(flags);
+    }
+}
+
+uint32_t Tiled::headerSize() const
+{
+    return m_header.sourceHeaderSize;
+}
+
+const void *Tiled::header() const
+{
+    /*
+        Expose the wrapped header so the mesh can be written back untiled
+    */
+    if (m_format == nullptr) {
+        return nullptr;
+    }
+
+    return m_format->header();
+}
+
+void Tiled::setHeader(const void *header)
+{
+    uint32_t version = reinterpret_cast<const uint32_t *>(header)[1];
+
+    if (!createFormat(version)) {
+        return;
+    }
+
+    m_format->setHeader(header);
+
+    m_header.faceSize = m_format->faceSize();
+    m_header.vertexSize = m_format->vertexSize();
+    m_header.materialDataOffset = 0;
+    m_header.materialDataEnd = 0;
+    m_header.tileTableOffset = 0;
+    m_header.tileCount = 0;
+}
+
+uint32_t Tiled::faceCount() const
+{
+    return m_faceCount;
+}
+
+uint32_t Tiled::faceSize() const
+{
+    return m_format->faceSize();
+}
+
+uint16_t Tiled::faceMaterialIndex(const void *faceData, uint32_t faceIndex) const
+{
+    return m_format->faceMaterialIndex(faceData, faceIndex);
+}
+
+int32_t Tiled::faceLightmapGroup(const void *faceData, uint32_t faceIndex) const
+{
+    return m_format->faceLightmapGroup(faceData, faceIndex);
+}
+
+void Tiled::faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    float *lightmapCoord) const
+{
+    m_format->faceLightmapCoord(faceData, faceIndex, vertexIndex, lightmapCoord);
+}
+
+uint32_t Tiled::faceVertexIndex(const void *faceData, uint32_t faceIndex,
+    uint32_t vertexIndex) const
+{
+    return m_format->faceVertexIndex(faceData, faceIndex, vertexIndex);
+}
+
+void Tiled::setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    uint32_t index) const
+{
+    m_format->setFaceVertexIndex(faceData, faceIndex, vertexIndex, index);
+}
+
+uint32_t Tiled::vertexCount() const
+{
+    return m_vertexCount;
+}
+
+void Tiled::setVertexCount(uint32_t vertexCount)
+{
+    m_vertexCount = vertexCount;
+}
+
+uint32_t Tiled::vertexSize() const
+{
+    return m_format->vertexSize();
+}
+
+void Tiled::vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const
+{
+    m_format->vertex(faceData, faceIndex, vertexData, vertexIndex, position, textureCoord, normal);
+}
+
+void Tiled::vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, uint8_t *color) const
+{
+    m_format->vertexColor(faceData, faceIndex, vertexData, vertexIndex, color);
+}
+
+void Tiled::vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const
+{
+    m_format->vertexPosition(vertexData, vertexIndex, position);
+}
+
+void Tiled::vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const
+{
+    m_format->vertexNormal(vertexData, vertexIndex, normal);
+}
+
+bool Tiled::beginWriteMaterials()
+{
+    if (!Interface::getCurrentOffset(&m_header.materialDataOffset)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Tiled::writeMaterial(const std::string &name)
+{
+    if (!Interface::write(name.c_str(), name.size())) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Tiled::endWriteMaterials()
+{
+    if (!Interface::write("\0", 1)) {
+        return false;
+    }
+
+    uint32_t currentOffset;
+
+    if (!Interface::getCurrentOffset(&currentOffset)) {
+        return false;
+    }
+
+    if (m_header.materialDataOffset > currentOffset) {
+        return false;
+    }
+
+    m_header.materialDataEnd = currentOffset;
+
+    return true;
+}
+
+bool Tiled::readMaterials(std::vector<std::string> *materials)
+{
+    materials->clear();
+
+    if (!Interface::setCurrentOffset(m_header.materialDataOffset)) {
+        return false;
+    }
+
+    std::string material;
+
+    while (true) {
+        char c;
+        if (!Interface::read(&c, sizeof(char))) {
+            return false;
+        }
+
+        if (c == ' ') {
+            if (!material.empty()) {
+                materials->push_back(material);
+                material.clear();
+            }
+
+            continue;
+        }
+
+        if (c == '\0') {
+            break;
+        }
+
+        material.push_back(c);
+    }
+
+    return true;
+}
+
+bool Tiled::beginWriteFaces()
+{
+    if (m_format == nullptr) {
+        return false;
+    }
+
+    m_pendingFaces.clear();
+
+    return true;
+}
+
+bool Tiled::writeFace(void *face)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(face);
+    m_pendingFaces.insert(m_pendingFaces.end(), data, data + m_header.faceSize);
+
+    return true;
+}
+
+bool Tiled::endWriteFaces()
+{
+    /*
+        Tiles need the vertices as well, faces are written with them
+    */
+    return true;
+}
+
+bool Tiled::readFaces(void *faces)
+{
+    uint8_t *target = reinterpret_cast<uint8_t *>(faces);
+    uint32_t vertexBase = 0;
+
+    for (uint32_t tileIndex : m_selectedTiles) {
+        const Tile &tile = m_tiles[tileIndex];
+
+        if (!Interface::setCurrentOffset(tile.dataOffset) ||
+            !Interface::read(target, static_cast<size_t>(tile.faceCount) * m_header.faceSize)) {
+            return false;
+        }
+
+        /*
+            Tile indices are local, rebase them onto the concatenated vertices
+        */
+        for (uint32_t i = 0; i < tile.faceCount; i++) {
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t index = m_format->faceVertexIndex(target, i, j);
+                m_format->setFaceVertexIndex(target, i, j,
+                    index < tile.vertexCount ? vertexBase + index : InvalidIndex);
+            }
+        }
+
+        target += static_cast<size_t>(tile.faceCount) * m_header.faceSize;
+        vertexBase += tile.vertexCount;
+    }
+
+    return true;
+}
+
+bool Tiled::beginWriteVertices()
+{
+    if (m_format == nullptr) {
+        return false;
+    }
+
+    m_pendingVertices.clear();
+
+    return true;
+}
+
+bool Tiled::writeVertex(void *vertex)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(vertex);
+    m_pendingVertices.insert(m_pendingVertices.end(), data, data + m_header.vertexSize);
+
+    return true;
+}
+
+bool Tiled::endWriteVertices()
+{
+    return writeTiles();
+}
+
+bool Tiled::readVertices(void *vertices)
+{
+    uint8_t *target = reinterpret_cast<uint8_t *>(vertices);
+
+    for (uint32_t tileIndex : m_selectedTiles) {
+        const Tile &tile = m_tiles[tileIndex];
+        uint32_t verticesOffset = tile.dataOffset + tile.faceCount * m_header.faceSize;
+        size_t size = static_cast<size_t>(tile.vertexCount) * m_header.vertexSize;
+
+        if (!Interface::setCurrentOffset(verticesOffset) || !Interface::read(target, size)) {
+            return false;
+        }
+
+        target += size;
+    }
+
+    return true;
+}
+
+bool Tiled::writeHeader()
+{
+    if (m_format == nullptr) {
+        return false;
+    }
+
+    std::memcpy(m_header.sourceHeader, m_format->header(), m_header.sourceHeaderSize);
+
+    if (!Interface::setCurrentOffset(0)) {
+        return false;
+    }
+
+    if (!Interface::write(&m_header, sizeof(Header))) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Tiled::selectRegion(const float *planes, uint32_t planeCount)
+{
+    /*
+        Planes are (a, b, c, d) in file space with a * x + b * y + c * z + d >= 0
+        inside, no planes selects every tile
+    */
+    m_selectedTiles.clear();
+    m_faceCount = 0;
+    m_vertexCount = 0;
+
+    for (uint32_t i = 0; i < m_tiles.size(); i++) {
+        if (!tileInRegion(m_tiles[i], planes, planeCount)) {
+            continue;
+        }
+
+        m_selectedTiles.push_back(i);
+        m_faceCount += m_tiles[i].faceCount;
+        m_vertexCount += m_tiles[i].vertexCount;
+    }
+
+    return true;
+}
+
+uint32_t Tiled::sourceVersion() const
+{
+    return m_header.sourceVersion;
+}
+
+uint32_t Tiled::tileCount() const
+{
+    return static_cast<uint32_t>(m_tiles.size());
+}
+
+uint32_t Tiled::selectedTileCount() const
+{
+    return static_cast<uint32_t>(m_selectedTiles.size());
+}
+
+} // namespace CompiledStaticMesh
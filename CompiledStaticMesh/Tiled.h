@@ -0,0 +1,119 @@
+#ifndef COMPILEDSTATICMESH_TILED_H
+#define COMPILEDSTATICMESH_TILED_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Interface.h"
+
+namespace CompiledStaticMesh {
+
+/*
+    Container for Version2/Version3 meshes with faces grouped into spatial
+    tiles. Every tile owns its vertices and is listed in a chunk table with
+    its bounding box and byte range, so a region can be read on its own.
+*/
+class Tiled: public Interface
+{
+
+public:
+    static constexpr const uint32_t Version = 64;
+    static constexpr const uint32_t Signature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'T';
+    static constexpr const uint32_t TileFaceCount = 4096;
+    static constexpr const uint32_t InvalidIndex = 0xffffffff;
+    static constexpr const uint32_t MaxSourceHeaderSize = 2048;
+
+    struct Tile {
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t dataOffset;
+        uint32_t faceCount;
+        uint32_t vertexCount;
+    };
+
+    struct Header {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t sourceVersion;
+        uint32_t sourceHeaderSize;
+        uint32_t faceSize;
+        uint32_t vertexSize;
+        uint32_t materialDataOffset;
+        uint32_t materialDataEnd;
+        uint32_t tileTableOffset;
+        uint32_t tileCount;
+        uint8_t sourceHeader[MaxSourceHeaderSize];
+    };
+
+private:
+    Header m_header;
+    Interface *m_format;
+    std::vector<Tile> m_tiles;
+    std::vector<uint32_t> m_selectedTiles;
+    uint32_t m_faceCount;
+    uint32_t m_vertexCount;
+    std::vector<uint8_t> m_pendingFaces;
+    std::vector<uint8_t> m_pendingVertices;
+
+    bool createFormat(uint32_t version);
+    void splitTiles(const std::vector<float> &centers, std::vector<uint32_t> *faceOrder,
+        std::vector<uint32_t> *tileEnds) const;
+    bool writeTiles();
+    static bool tileInRegion(const Tile &tile, const float *planes, uint32_t planeCount);
+
+public:
+    Tiled();
+    ~Tiled() override;
+    bool open(const std::string &filename, Interface::Mode mode) override;
+    void close() override;
+    uint32_t version() const override;
+    void setVersion(uint32_t version) override;
+    uint32_t flags() const override;
+    void setFlags(uint32_t flags) override;
+    uint32_t headerSize() const override;
+    const void *header() const override;
+    void setHeader(const void *header) override;
+    uint32_t faceCount() const override;
+    uint32_t faceSize() const override;
+    uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const override;
+    int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const override;
+    void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const override;
+    uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const override;
+    void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const override;
+    uint32_t vertexCount() const override;
+    void setVertexCount(uint32_t vertexCount) override;
+    uint32_t vertexSize() const override;
+    void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const override;
+    void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const override;
+    void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const override;
+    void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const override;
+    bool beginWriteMaterials() override;
+    bool writeMaterial(const std::string &name) override;
+    bool endWriteMaterials() override;
+    bool readMaterials(std::vector<std::string> *materials) override;
+    bool beginWriteFaces() override;
+    bool writeFace(void *face) override;
+    bool endWriteFaces() override;
+    bool readFaces(void *faces) override;
+    bool beginWriteVertices() override;
+    bool writeVertex(void *vertex) override;
+    bool endWriteVertices() override;
+    bool readVertices(void *vertices) override;
+    bool writeHeader() override;
+    bool selectRegion(const float *planes, uint32_t planeCount) override;
+    uint32_t sourceVersion() const;
+    uint32_t tileCount() const;
+    uint32_t selectedTileCount() const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_TILED_H
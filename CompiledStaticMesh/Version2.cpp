@@ -60,6 +60,31 @@ void Version2::setFlags(uint32_t flags)
     m_header.flags = flags;
 }
 
+uint32_t Version2::headerSize() const
+{
+    return sizeof(Header);
+}
+
+const void *Version2::header() const
+{
+    return &m_header;
+}
+
+void Version2::setHeader(const void *header)
+{
+    std::memcpy(&m_header, header, sizeof(Header));
+
+    /*
+        Section layout belongs to the file being written
+    */
+    m_header.materialDataOffset = 0;
+    m_header.materialDataEnd = 0;
+    m_header.facesDataOffset = 0;
+    m_header.facesCount = 0;
+    m_header.vertexDataOffset = 0;
+    m_header.vertexCount = 0;
+}
+
 uint32_t Version2::faceCount() const
 {
     return m_header.facesCount;
@@ -75,11 +100,45 @@ uint16_t Version2::faceMaterialIndex(const void *faceData, uint32_t faceIndex) c
     return reinterpret_cast<const Face *>(faceData)[faceIndex].material;
 }
 
+int32_t Version2::faceLightmapGroup(const void *faceData, uint32_t faceIndex) const
+{
+    if ((m_header.flags & ModelHasLightmapGroups) == 0) {
+        return -1;
+    }
+
+    return reinterpret_cast<const Face *>(faceData)[faceIndex].lightmapGroup;
+}
+
+void Version2::faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    float *lightmapCoord) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    lightmapCoord[0] = face->lightmapCoord[vertexIndex].x;
+    lightmapCoord[1] = face->lightmapCoord[vertexIndex].y;
+}
+
+uint32_t Version2::faceVertexIndex(const void *faceData, uint32_t faceIndex,
+    uint32_t vertexIndex) const
+{
+    return reinterpret_cast<const Face *>(faceData)[faceIndex].index[vertexIndex];
+}
+
+void Version2::setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    uint32_t index) const
+{
+    reinterpret_cast<Face *>(faceData)[faceIndex].index[vertexIndex] = index;
+}
+
 uint32_t Version2::vertexCount() const
 {
     return m_header.vertexCount;
 }
 
+void Version2::setVertexCount(uint32_t vertexCount)
+{
+    m_header.vertexCount = vertexCount;
+}
+
 uint32_t Version2::vertexSize() const
 {
     return sizeof(Vertex);
@@ -101,6 +160,32 @@ void Version2::vertex(const void *faceData, uint32_t faceIndex, const void *vert
     normal[2] = vertex->normal.y;
 }
 
+void Version2::vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, uint8_t *color) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    const Vertex *vertex = &reinterpret_cast<const Vertex *>(vertexData)[face->index[vertexIndex]];
+    color[0] = vertex->color.r;
+    color[1] = vertex->color.g;
+    color[2] = vertex->color.b;
+    color[3] = vertex->color.a;
+}
+
+void Version2::vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const
+{
+    const Vertex *vertex = &reinterpret_cast<const Vertex *>(vertexData)[vertexIndex];
+    position[0] = vertex->position.x;
+    position[1] = vertex->position.y;
+    position[2] = vertex->position.z;
+}
+
+void Version2::vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const
+{
+    const Vertex *vertex = &reinterpret_cast<const Vertex *>(vertexData)[vertexIndex];
+    normal[0] = vertex->normal.x;
+    normal[1] = vertex->normal.y;
+    normal[2] = vertex->normal.z;
+}
 
 bool Version2::beginWriteMaterials()
 {
@@ -178,6 +263,8 @@ bool Version2::readMaterials(std::vector<std::string> *materials)
 
 bool Version2::beginWriteFaces()
 {
+    m_header.facesCount = 0;
+
     if (!Interface::getCurrentOffset(&m_header.facesDataOffset)) {
         return false;
     }
@@ -230,6 +317,8 @@ bool Version2::readFaces(void *faces)
 
 bool Version2::beginWriteVertices()
 {
+    m_header.vertexCount = 0;
+
     if (!Interface::getCurrentOffset(&m_header.vertexDataOffset)) {
         return false;
     }
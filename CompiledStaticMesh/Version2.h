@@ -105,13 +105,28 @@ public:
     void setVersion(uint32_t version) override;
     uint32_t flags() const override;
     void setFlags(uint32_t flags) override;
+    uint32_t headerSize() const override;
+    const void *header() const override;
+    void setHeader(const void *header) override;
     uint32_t faceCount() const override;
     uint32_t faceSize() const override;
     uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const override;
+    int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const override;
+    void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const override;
+    uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const override;
+    void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const override;
     uint32_t vertexCount() const override;
+    void setVertexCount(uint32_t vertexCount) override;
     uint32_t vertexSize() const override;
     void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
         uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const override;
+    void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const override;
+    void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const override;
+    void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const override;
     bool beginWriteMaterials() override;
     bool writeMaterial(const std::string &name) override;
     bool endWriteMaterials() override;
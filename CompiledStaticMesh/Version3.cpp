@@ -1,11 +1,17 @@
+#include "Crc32c.h"
 #include "Version3.h"
 
 namespace CompiledStaticMesh {
 
 Version3::Version3() :
-    Interface()
+    Interface(),
+    m_mappedData(nullptr),
+    m_mappedSize(0),
+    m_checksumsOffset(0),
+    m_hasChecksums(false)
 {
     std::memset(&m_header, 0, sizeof(Header));
+    std::memset(&m_checksums, 0, sizeof(Checksums));
 }
 
 Version3::~Version3()
@@ -21,19 +27,84 @@ bool Version3::open(const std::string &filename, Interface::Mode mode)
         return false;
     }
 
+    m_filename = filename;
+
     if (mode == Interface::Read) {
         if (!Interface::read(&m_header, sizeof(Header))) {
             return false;
         }
+
+        if (!readChecksums()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Version3::readChecksums()
+{
+    uint32_t size;
+
+    if (!Interface::getSize(&size)) {
+        return false;
+    }
+
+    /*
+        Truncated files fail here instead of loading partial sections
+    */
+    if (m_header.materialDataOffset > m_header.materialDataEnd || m_header.materialDataEnd > size ||
+        static_cast<uint64_t>(m_header.facesDataOffset) + static_cast<uint64_t>(sizeof(Face)) *
+        m_header.facesCount > size ||
+        static_cast<uint64_t>(m_header.vertexDataOffset) + static_cast<uint64_t>(sizeof(Vertex)) *
+        m_header.vertexCount > size) {
+        return false;
+    }
+
+    if (size < sizeof(Header) + sizeof(Checksums)) {
+        return true;
     }
 
+    if (!Interface::setCurrentOffset(static_cast<uint32_t>(size - sizeof(Checksums))) ||
+        !Interface::read(&m_checksums, sizeof(Checksums))) {
+        return false;
+    }
+
+    if (m_checksums.signature != ChecksumsSignature || m_checksums.size != sizeof(Checksums)) {
+        std::memset(&m_checksums, 0, sizeof(Checksums));
+        return true;
+    }
+
+    if (Crc32c::compute(&m_header, sizeof(Header)) != m_checksums.header) {
+        return false;
+    }
+
+    m_hasChecksums = true;
+
     return true;
 }
 
 void Version3::close()
 {
     Interface::close();
+    m_mappedFile.close();
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+    m_filename.clear();
     std::memset(&m_header, 0, sizeof(Header));
+    std::memset(&m_checksums, 0, sizeof(Checksums));
+    m_checksumsOffset = 0;
+    m_hasChecksums = false;
+}
+
+bool Version3::validSection(uint32_t offset, uint32_t size, uint32_t count) const
+{
+    if (count == 0) {
+        return true;
+    }
+
+    return offset >= sizeof(Header) && offset <= m_mappedSize &&
+        static_cast<uint64_t>(size) * count <= m_mappedSize - offset;
 }
 
 uint32_t Version3::version() const
@@ -60,6 +131,35 @@ void Version3::setFlags(uint32_t flags)
     m_header.flags = flags;
 }
 
+uint32_t Version3::headerSize() const
+{
+    return sizeof(Header);
+}
+
+const void *Version3::header() const
+{
+    return &m_header;
+}
+
+void Version3::setHeader(const void *header)
+{
+    std::memcpy(&m_header, header, sizeof(Header));
+
+    /*
+        Section layout belongs to the file being written
+    */
+    m_header.materialDataOffset = 0;
+    m_header.materialDataEnd = 0;
+    m_header.facesDataOffset = 0;
+    m_header.facesCount = 0;
+    m_header.vertexDataOffset = 0;
+    m_header.vertexCount = 0;
+    m_header.sidesDataOffset = 0;
+    m_header.sidesCount = 0;
+    m_header.pointsDataOffset = 0;
+    m_header.pointsCount = 0;
+}
+
 uint32_t Version3::faceCount() const
 {
     return m_header.facesCount;
@@ -75,11 +175,45 @@ uint16_t Version3::faceMaterialIndex(const void *faceData, uint32_t faceIndex) c
     return reinterpret_cast<const Face *>(faceData)[faceIndex].material;
 }
 
+int32_t Version3::faceLightmapGroup(const void *faceData, uint32_t faceIndex) const
+{
+    if ((m_header.flags & ModelHasLightmapGroups) == 0) {
+        return -1;
+    }
+
+    return reinterpret_cast<const Face *>(faceData)[faceIndex].lightmapGroup;
+}
+
+void Version3::faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    float *lightmapCoord) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    lightmapCoord[0] = face->lightmapCoord[vertexIndex].x;
+    lightmapCoord[1] = face->lightmapCoord[vertexIndex].y;
+}
+
+uint32_t Version3::faceVertexIndex(const void *faceData, uint32_t faceIndex,
+    uint32_t vertexIndex) const
+{
+    return reinterpret_cast<const Face *>(faceData)[faceIndex].index[vertexIndex];
+}
+
+void Version3::setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+    uint32_t index) const
+{
+    reinterpret_cast<Face *>(faceData)[faceIndex].index[vertexIndex] = index;
+}
+
 uint32_t Version3::vertexCount() const
 {
     return m_header.vertexCount;
 }
 
+void Version3::setVertexCount(uint32_t vertexCount)
+{
+    m_header.vertexCount = vertexCount;
+}
+
 uint32_t Version3::vertexSize() const
 {
     return sizeof(Vertex);
@@ -101,9 +235,37 @@ void Version3::vertex(const void *faceData, uint32_t faceIndex, const void *vert
     normal[2] = vertex->normal.y;
 }
 
+void Version3::vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+    uint32_t vertexIndex, uint8_t *color) const
+{
+    const Face *face = &reinterpret_cast<const Face *>(faceData)[faceIndex];
+    const Vertex *vertex = &reinterpret_cast<const Vertex *>(vertexData)[face->index[vertexIndex]];
+    color[0] = vertex->color.r;
+    color[1] = vertex->color.g;
+    color[2] = vertex->color.b;
+    color[3] = vertex->color.a;
+}
+
+void Version3::vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const
+{
+    const Vertex *vertex = &reinterpret_cast<const Vertex *>(vertexData)[vertexIndex];
+    position[0] = vertex->position.x;
+    position[1] = vertex->position.y;
+    position[2] = vertex->position.z;
+}
+
+void Version3::vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const
+{
+    const Vertex *vertex = &reinterpret_cast<const Vertex *>(vertexData)[vertexIndex];
+    normal[0] = vertex->normal.x;
+    normal[1] = vertex->normal.y;
+    normal[2] = vertex->normal.z;
+}
 
 bool Version3::beginWriteMaterials()
 {
+    m_checksums.materials = 0;
+
     if (!Interface::getCurrentOffset(&m_header.materialDataOffset)) {
         return false;
     }
@@ -117,6 +279,8 @@ bool Version3::writeMaterial(const std::string &name)
         return false;
     }
 
+    m_checksums.materials = Crc32c::update(m_checksums.materials, name.c_str(), name.size());
+
     return true;
 }
 
@@ -126,6 +290,8 @@ bool Version3::endWriteMaterials()
         return false;
     }
 
+    m_checksums.materials = Crc32c::update(m_checksums.materials, "\0", 1);
+
     uint32_t currentOffset;
 
     if (!Interface::getCurrentOffset(&currentOffset)) {
@@ -150,6 +316,7 @@ bool Version3::readMaterials(std::vector<std::string> *materials)
     }
 
     std::string material;
+    uint32_t checksum = 0;
 
     while (true) {
         char c;
@@ -157,6 +324,10 @@ bool Version3::readMaterials(std::vector<std::string> *materials)
             return false;
         }
 
+        if (m_hasChecksums) {
+            checksum = Crc32c::update(checksum, &c, sizeof(char));
+        }
+
         if (c == ' ') {
             if (!material.empty()) {
                 materials->push_back(material);
@@ -173,11 +344,18 @@ bool Version3::readMaterials(std::vector<std::string> *materials)
         material.push_back(c);
     }
 
+    if (m_hasChecksums && checksum != m_checksums.materials) {
+        return false;
+    }
+
     return true;
 }
 
 bool Version3::beginWriteFaces()
 {
+    m_header.facesCount = 0;
+    m_checksums.faces = 0;
+
     if (!Interface::getCurrentOffset(&m_header.facesDataOffset)) {
         return false;
     }
@@ -197,6 +375,8 @@ bool Version3::writeFace(void *face)
         return false;
     }
 
+    m_checksums.faces = Crc32c::update(m_checksums.faces, face, sizeof(Face));
+
     return true;
 }
 
@@ -225,11 +405,18 @@ bool Version3::readFaces(void *faces)
         return false;
     }
 
+    if (m_hasChecksums && Crc32c::compute(faces, sizeof(Face) * m_header.facesCount) != m_checksums.faces) {
+        return false;
+    }
+
     return true;
 }
 
 bool Version3::beginWriteVertices()
 {
+    m_header.vertexCount = 0;
+    m_checksums.vertices = 0;
+
     if (!Interface::getCurrentOffset(&m_header.vertexDataOffset)) {
         return false;
     }
@@ -245,6 +432,8 @@ bool Version3::writeVertex(void *vertex)
         return false;
     }
 
+    m_checksums.vertices = Crc32c::update(m_checksums.vertices, vertex, sizeof(Vertex));
+
     return true;
 }
 
@@ -260,6 +449,8 @@ bool Version3::endWriteVertices()
         return false;
     }
 
+    m_checksumsOffset = currentOffset;
+
     return true;
 }
 
@@ -273,6 +464,11 @@ bool Version3::readVertices(void *vertices)
         return false;
     }
 
+    if (m_hasChecksums &&
+        Crc32c::compute(vertices, sizeof(Vertex) * m_header.vertexCount) != m_checksums.vertices) {
+        return false;
+    }
+
     return true;
 }
 
@@ -286,7 +482,100 @@ bool Version3::writeHeader()
         return false;
     }
 
+    /*
+        The trailer follows the vertices once every section has been written
+    */
+    if (m_checksumsOffset == 0) {
+        return true;
+    }
+
+    m_checksums.signature = ChecksumsSignature;
+    m_checksums.size = sizeof(Checksums);
+    m_checksums.header = Crc32c::compute(&m_header, sizeof(Header));
+
+    if (!Interface::setCurrentOffset(m_checksumsOffset)) {
+        return false;
+    }
+
+    if (!Interface::write(&m_checksums, sizeof(Checksums))) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Version3::hasChecksums() const
+{
+    return m_hasChecksums;
+}
+
+bool Version3::hasSides() const
+{
+    return m_header.sidesCount > 0 && m_header.sidesDataOffset > 0;
+}
+
+bool Version3::mapSides()
+{
+    if (m_mappedData != nullptr) {
+        return true;
+    }
+
+    if (!Interface::isOpen() || !hasSides()) {
+        return false;
+    }
+
+    if (m_header.sideSize < sizeof(Side) ||
+        (m_header.pointsCount > 0 && m_header.pointSize < sizeof(Point))) {
+        return false;
+    }
+
+    /*
+        Sides are only needed for debugging, so map them on first use instead of reading at open.
+        Meshes opened from memory already have everything mapped.
+    */
+    if (Interface::memory() != nullptr) {
+        m_mappedData = Interface::memory();
+        m_mappedSize = Interface::memorySize();
+    } else {
+        if (!m_mappedFile.open(m_filename)) {
+            return false;
+        }
+
+        m_mappedData = m_mappedFile.data();
+        m_mappedSize = m_mappedFile.size();
+    }
+
+    if (!validSection(m_header.sidesDataOffset, m_header.sideSize, m_header.sidesCount) ||
+        !validSection(m_header.pointsDataOffset, m_header.pointSize, m_header.pointsCount)) {
+        m_mappedFile.close();
+        m_mappedData = nullptr;
+        m_mappedSize = 0;
+        return false;
+    }
+
     return true;
 }
 
+uint32_t Version3::sideCount() const
+{
+    return m_header.sidesCount;
+}
+
+const Version3::Side *Version3::side(uint32_t index) const
+{
+    return reinterpret_cast<const Side *>(m_mappedData + m_header.sidesDataOffset +
+        static_cast<size_t>(m_header.sideSize) * index);
+}
+
+uint32_t Version3::pointCount() const
+{
+    return m_header.pointsCount;
+}
+
+const Version3::Point *Version3::point(uint32_t index) const
+{
+    return reinterpret_cast<const Point *>(m_mappedData + m_header.pointsDataOffset +
+        static_cast<size_t>(m_header.pointSize) * index);
+}
+
 } // namespace CompiledStaticMesh
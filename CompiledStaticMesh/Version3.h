@@ -7,6 +7,7 @@
 #include <vector>
 #include <memory>
 #include "Interface.h"
+#include "MappedFile.h"
 
 namespace CompiledStaticMesh {
 
@@ -16,6 +17,7 @@ class Version3: public Interface
 public:
     static constexpr const uint32_t Version = 3;
     static constexpr const uint32_t Signature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'I';
+    static constexpr const uint32_t ChecksumsSignature = ('M' << 24) + ('S' << 16) + ('C' << 8) + 'K';
     static constexpr const uint32_t MaxMaterialNameLength = 260;
     static constexpr const uint32_t ChannelTexture = 0;
     static constexpr const uint32_t ChannelLightmap = 1;
@@ -71,6 +73,33 @@ public:
         Vector2 lightmapCoord[3];
     };
 
+    /*
+        Leading fields of brush side and point records, sideSize and pointSize
+        in the header give the actual record strides
+    */
+    struct Side {
+        uint32_t firstFace;
+        uint32_t faceCount;
+        uint32_t firstPoint;
+        uint32_t pointCount;
+    };
+
+    struct Point {
+        Vector3 position;
+    };
+
+    /*
+        Optional trailer after the last section, CRC32C of every section
+    */
+    struct Checksums {
+        uint32_t signature;
+        uint32_t size;
+        uint32_t header;
+        uint32_t materials;
+        uint32_t faces;
+        uint32_t vertices;
+    };
+
     struct Header {
         uint32_t signature;
         uint32_t version;
@@ -103,6 +132,16 @@ public:
 
 private:
     Header m_header;
+    std::string m_filename;
+    MappedFile m_mappedFile;
+    const uint8_t *m_mappedData;
+    size_t m_mappedSize;
+    Checksums m_checksums;
+    uint32_t m_checksumsOffset;
+    bool m_hasChecksums;
+
+    bool validSection(uint32_t offset, uint32_t size, uint32_t count) const;
+    bool readChecksums();
 
 public:
     Version3();
@@ -113,13 +152,28 @@ public:
     void setVersion(uint32_t version) override;
     uint32_t flags() const override;
     void setFlags(uint32_t flags) override;
+    uint32_t headerSize() const override;
+    const void *header() const override;
+    void setHeader(const void *header) override;
     uint32_t faceCount() const override;
     uint32_t faceSize() const override;
     uint16_t faceMaterialIndex(const void *faceData, uint32_t faceIndex) const override;
+    int32_t faceLightmapGroup(const void *faceData, uint32_t faceIndex) const override;
+    void faceLightmapCoord(const void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        float *lightmapCoord) const override;
+    uint32_t faceVertexIndex(const void *faceData, uint32_t faceIndex,
+        uint32_t vertexIndex) const override;
+    void setFaceVertexIndex(void *faceData, uint32_t faceIndex, uint32_t vertexIndex,
+        uint32_t index) const override;
     uint32_t vertexCount() const override;
+    void setVertexCount(uint32_t vertexCount) override;
     uint32_t vertexSize() const override;
     void vertex(const void *faceData, uint32_t faceIndex, const void *vertexData,
         uint32_t vertexIndex, float *position, float *textureCoord, float *normal) const override;
+    void vertexColor(const void *faceData, uint32_t faceIndex, const void *vertexData,
+        uint32_t vertexIndex, uint8_t *color) const override;
+    void vertexPosition(const void *vertexData, uint32_t vertexIndex, float *position) const override;
+    void vertexNormal(const void *vertexData, uint32_t vertexIndex, float *normal) const override;
     bool beginWriteMaterials() override;
     bool writeMaterial(const std::string &name) override;
     bool endWriteMaterials() override;
@@ -133,6 +187,13 @@ public:
     bool endWriteVertices() override;
     bool readVertices(void *vertices) override;
     bool writeHeader() override;
+    bool hasChecksums() const;
+    bool hasSides() const;
+    bool mapSides();
+    uint32_t sideCount() const;
+    const Side *side(uint32_t index) const;
+    uint32_t pointCount() const;
+    const Point *point(uint32_t index) const;
 
 };
 
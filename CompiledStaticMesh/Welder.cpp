@@ -0,0 +1,270 @@
+#include <cmath>
+#include <cstring>
+#include "Parallel.h"
+#include "Welder.h"
+
+namespace CompiledStaticMesh {
+
+static int32_t cellCoord(float value)
+{
+    float cell = std::floor(value);
+
+    if (!(cell > -2147483520.0f)) {
+        return INT32_MIN;
+    }
+
+    if (cell > 2147483520.0f) {
+        return INT32_MAX;
+    }
+
+    return static_cast<int32_t>(cell);
+}
+
+static uint32_t cellHash(int32_t x, int32_t y, int32_t z)
+{
+    uint64_t hash = static_cast<uint32_t>(x) * 0x8da6b343ULL ^
+        static_cast<uint32_t>(y) * 0xd8163841ULL ^ static_cast<uint32_t>(z) * 0xcb1ab31fULL;
+
+    return static_cast<uint32_t>(hash ^ (hash >> 29));
+}
+
+static void normalize(float *vector)
+{
+    float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+
+    if (length > 0.0f) {
+        vector[0] /= length;
+        vector[1] /= length;
+        vector[2] /= length;
+    }
+}
+
+Welder::Welder() :
+    m_distance(DefaultDistance),
+    m_normalAngle(DefaultNormalAngle),
+    m_vertexCount(0)
+{
+
+}
+
+float Welder::distance() const
+{
+    return m_distance;
+}
+
+void Welder::setDistance(float distance)
+{
+    m_distance = distance;
+}
+
+float Welder::normalAngle() const
+{
+    return m_normalAngle;
+}
+
+void Welder::setNormalAngle(float normalAngle)
+{
+    m_normalAngle = normalAngle;
+}
+
+bool Welder::weld(const Interface *mesh, const void *vertexData)
+{
+    m_remap.clear();
+    m_vertexCount = 0;
+
+    if (mesh == nullptr || vertexData == nullptr) {
+        return false;
+    }
+
+    uint32_t vertexCount = mesh->vertexCount();
+
+    std::vector<float> positions(static_cast<size_t>(vertexCount) * 3);
+    std::vector<float> normals(static_cast<size_t>(vertexCount) * 3);
+
+    Parallel::forEach(vertexCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        (void)thread;
+
+        for (uint32_t i = begin; i < end; i++) {
+            mesh->vertexPosition(vertexData, i, &positions[static_cast<size_t>(i) * 3]);
+            mesh->vertexNormal(vertexData, i, &normals[static_cast<size_t>(i) * 3]);
+            normalize(&normals[static_cast<size_t>(i) * 3]);
+        }
+    });
+
+    /*
+        Cells are twice the weld distance wide, so every candidate within the
+        distance lies in the 2x2x2 block of cells nearest to the vertex
+    */
+    bool isExact = !(m_distance > 0.0f);
+    float cellScale = isExact ? 0.0f : 1.0f / (m_distance * 2.0f);
+    float distanceSquared = isExact ? 0.0f : m_distance * m_distance;
+    float normalCos = std::cos(m_normalAngle * 3.14159265358979f / 180.0f);
+
+    uint32_t capacity = 16;
+    while (capacity < vertexCount * 2) {
+        capacity *= 2;
+    }
+
+    std::vector<Cell> cells(capacity);
+    std::vector<uint8_t> cellUsed(capacity, 0);
+    std::vector<uint32_t> next(vertexCount, InvalidIndex);
+    m_remap.assign(vertexCount, InvalidIndex);
+
+    auto findCell = [&](int32_t x, int32_t y, int32_t z, bool insert) -> Cell * {
+        uint32_t slot = cellHash(x, y, z) & (capacity - 1);
+
+        while (cellUsed[slot] != 0) {
+            Cell *cell = &cells[slot];
+            if (cell->x == x && cell->y == y && cell->z == z) {
+                return cell;
+            }
+
+            slot = (slot + 1) & (capacity - 1);
+        }
+
+        if (!insert) {
+            return nullptr;
+        }
+
+        cellUsed[slot] = 1;
+        cells[slot].x = x;
+        cells[slot].y = y;
+        cells[slot].z = z;
+        cells[slot].head = InvalidIndex;
+
+        return &cells[slot];
+    };
+
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float *position = &positions[static_cast<size_t>(i) * 3];
+        const float *normal = &normals[static_cast<size_t>(i) * 3];
+        int32_t base[3];
+        int32_t side[3];
+
+        for (uint32_t j = 0; j < 3; j++) {
+            if (isExact) {
+                std::memcpy(&base[j], &position[j], sizeof(int32_t));
+                side[j] = 0;
+            } else {
+                float scaled = position[j] * cellScale;
+                base[j] = cellCoord(scaled);
+                side[j] = scaled - std::floor(scaled) < 0.5f ? -1 : 1;
+            }
+        }
+
+        uint32_t target = InvalidIndex;
+        uint32_t cellCount = isExact ? 1 : 8;
+
+        for (uint32_t j = 0; j < cellCount && target == InvalidIndex; j++) {
+            const Cell *cell = findCell(base[0] + ((j & 1) ? side[0] : 0),
+                base[1] + ((j & 2) ? side[1] : 0), base[2] + ((j & 4) ? side[2] : 0), false);
+
+            if (cell == nullptr) {
+                continue;
+            }
+
+            for (uint32_t k = cell->head; k != InvalidIndex; k = next[k]) {
+                const float *otherPosition = &positions[static_cast<size_t>(k) * 3];
+                const float *otherNormal = &normals[static_cast<size_t>(k) * 3];
+
+                float dx = position[0] - otherPosition[0];
+                float dy = position[1] - otherPosition[1];
+                float dz = position[2] - otherPosition[2];
+
+                if (dx * dx + dy * dy + dz * dz > distanceSquared) {
+                    continue;
+                }
+
+                if (normal[0] * otherNormal[0] + normal[1] * otherNormal[1] +
+                    normal[2] * otherNormal[2] < normalCos) {
+                    continue;
+                }
+
+                if (target == InvalidIndex || k < target) {
+                    target = k;
+                }
+            }
+        }
+
+        if (target != InvalidIndex) {
+            m_remap[i] = m_remap[target];
+            continue;
+        }
+
+        /*
+            New representative vertex
+        */
+        m_remap[i] = m_vertexCount++;
+
+        Cell *cell = findCell(base[0], base[1], base[2], true);
+        next[i] = cell->head;
+        cell->head = i;
+    }
+
+    return true;
+}
+
+bool Welder::apply(Interface *mesh, void *faceData, void *vertexData) const
+{
+    if (mesh == nullptr || faceData == nullptr || vertexData == nullptr) {
+        return false;
+    }
+
+    uint32_t vertexCount = mesh->vertexCount();
+
+    if (m_remap.size() != vertexCount) {
+        return false;
+    }
+
+    Parallel::forEach(mesh->faceCount(), [&](uint32_t thread, uint32_t begin, uint32_t end) {
+        (void)thread;
+
+        for (uint32_t i = begin; i < end; i++) {
+            for (uint32_t j = 0; j < 3; j++) {
+                uint32_t index = mesh->faceVertexIndex(faceData, i, j);
+
+                if (index < vertexCount) {
+                    mesh->setFaceVertexIndex(faceData, i, j, m_remap[index]);
+                } else {
+                    mesh->setFaceVertexIndex(faceData, i, j, InvalidIndex);
+                }
+            }
+        }
+    });
+
+    /*
+        Representatives keep their relative order, so compaction can run in place
+    */
+    uint8_t *vertices = reinterpret_cast<uint8_t *>(vertexData);
+    uint32_t vertexSize = mesh->vertexSize();
+    uint32_t target = 0;
+
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        if (m_remap[i] != target) {
+            continue;
+        }
+
+        if (target != i) {
+            std::memcpy(vertices + static_cast<size_t>(target) * vertexSize,
+                vertices + static_cast<size_t>(i) * vertexSize, vertexSize);
+        }
+
+        target++;
+    }
+
+    mesh->setVertexCount(m_vertexCount);
+
+    return true;
+}
+
+uint32_t Welder::vertexCount() const
+{
+    return m_vertexCount;
+}
+
+const std::vector<uint32_t> &Welder::remap() const
+{
+    return m_remap;
+}
+
+} // namespace CompiledStaticMesh
@@ -0,0 +1,46 @@
+#ifndef COMPILEDSTATICMESH_WELDER_H
+#define COMPILEDSTATICMESH_WELDER_H
+
+#include <cstdint>
+#include <vector>
+#include "Interface.h"
+
+namespace CompiledStaticMesh {
+
+class Welder
+{
+
+public:
+    static constexpr const float DefaultDistance = 0.001f;
+    static constexpr const float DefaultNormalAngle = 5.0f;
+    static constexpr const uint32_t InvalidIndex = 0xffffffff;
+
+private:
+    struct Cell {
+        int32_t x;
+        int32_t y;
+        int32_t z;
+        uint32_t head;
+    };
+
+    float m_distance;
+    float m_normalAngle;
+    uint32_t m_vertexCount;
+    std::vector<uint32_t> m_remap;
+
+public:
+    Welder();
+    float distance() const;
+    void setDistance(float distance);
+    float normalAngle() const;
+    void setNormalAngle(float normalAngle);
+    bool weld(const Interface *mesh, const void *vertexData);
+    bool apply(Interface *mesh, void *faceData, void *vertexData) const;
+    uint32_t vertexCount() const;
+    const std::vector<uint32_t> &remap() const;
+
+};
+
+} // namespace CompiledStaticMesh
+
+#endif // COMPILEDSTATICMESH_WELDER_H
@@ -1,26 +1,82 @@
-QT += quick qml quick3d
+QT += quick qml quick3d concurrent
 
 SOURCES += \
     CompiledStaticMesh.cpp \
+    CompiledStaticMesh/AlphaScanner.cpp \
+    CompiledStaticMesh/Analyzer.cpp \
+    CompiledStaticMesh/Compressed.cpp \
+    CompiledStaticMesh/Crc32c.cpp \
+    CompiledStaticMesh/Geometry.cpp \
+    CompiledStaticMesh/Hash.cpp \
     CompiledStaticMesh/Interface.cpp \
+    CompiledStaticMesh/Lz.cpp \
+    CompiledStaticMesh/MappedFile.cpp \
+    CompiledStaticMesh/MipGenerator.cpp \
+    CompiledStaticMesh/NormalGenerator.cpp \
+    CompiledStaticMesh/Pack.cpp \
+    CompiledStaticMesh/Parallel.cpp \
+    CompiledStaticMesh/PixelConverter.cpp \
+    CompiledStaticMesh/Quantized.cpp \
+    CompiledStaticMesh/RadixSort.cpp \
+    CompiledStaticMesh/TangentGenerator.cpp \
+    CompiledStaticMesh/Tiled.cpp \
     CompiledStaticMesh/Version2.cpp \
     CompiledStaticMesh/Version3.cpp \
+    CompiledStaticMesh/Welder.cpp \
+    DdsImage.cpp \
+    DdsImageDecoder.cpp \
+    GeometryCache.cpp \
+    IlImageDecoder.cpp \
+    ImageDecoder.cpp \
     ImageProvider.cpp \
     Model.cpp \
     Main.cpp \
+    QtImageDecoder.cpp \
     Texture.cpp \
+    TextureBudget.cpp \
+    TextureCache.cpp \
+    TextureResolver.cpp \
+    TgaImageDecoder.cpp \
     WindowsHelper.cpp
 
 RESOURCES += Assets.qrc
 
 HEADERS += \
     CompiledStaticMesh.h \
+    CompiledStaticMesh/AlphaScanner.h \
+    CompiledStaticMesh/Analyzer.h \
+    CompiledStaticMesh/Compressed.h \
+    CompiledStaticMesh/Crc32c.h \
+    CompiledStaticMesh/Geometry.h \
+    CompiledStaticMesh/Hash.h \
     CompiledStaticMesh/Interface.h \
+    CompiledStaticMesh/Lz.h \
+    CompiledStaticMesh/MappedFile.h \
+    CompiledStaticMesh/MipGenerator.h \
+    CompiledStaticMesh/NormalGenerator.h \
+    CompiledStaticMesh/Pack.h \
+    CompiledStaticMesh/Parallel.h \
+    CompiledStaticMesh/PixelConverter.h \
+    CompiledStaticMesh/Quantized.h \
+    CompiledStaticMesh/RadixSort.h \
+    CompiledStaticMesh/TangentGenerator.h \
+    CompiledStaticMesh/Tiled.h \
     CompiledStaticMesh/Version2.h \
     CompiledStaticMesh/Version3.h \
+    CompiledStaticMesh/Welder.h \
+    DdsImage.h \
+    DdsImageDecoder.h \
+    GeometryCache.h \
+    IlImageDecoder.h \
+    ImageDecoder.h \
     ImageProvider.h \
     Model.h \
+    QtImageDecoder.h \
     Texture.h \
+    TextureBudget.h \
+    TextureCache.h \
+    TextureResolver.h \
+    TgaImageDecoder.h \
     WindowsHelper.h
 
 LIBS += -L"$$_PRO_FILE_PWD_/DevIL/lib/x64/" -lDevIL -ldwmapi -lUser32
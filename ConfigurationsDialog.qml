@@ -25,6 +25,12 @@ Window {
         property alias textureMapSuffixesDiffuse: _textureMapSuffixesDiffuseEdit.text
         property alias textureMapSuffixesSpecular: _textureMapSuffixesSpecularEdit.text
         property alias textureMapSuffixesNormal: _textureMapSuffixesNormalEdit.text
+        property alias weldDistance: _weldDistanceEdit.text
+        property alias weldNormalAngle: _weldNormalAngleEdit.text
+        property alias creaseAngle: _creaseAngleEdit.text
+        property alias geometryCacheSize: _geometryCacheSizeEdit.text
+        property alias textureCacheSize: _textureCacheSizeEdit.text
+        property alias textureBudget: _textureBudgetEdit.text
     }
 
     onVisibleChanged: {
@@ -189,6 +195,102 @@ Window {
                 Layout.fillWidth: true
                 placeholder: "_normal; _norm; _n;"
             }
+
+            Item {
+               Layout.fillWidth: true
+            }
+
+            Components.Label {
+                Layout.fillWidth: true
+                text: "Vertex weld distance (empty to disable)"
+                font.bold: true
+            }
+
+            Components.LineEdit {
+                id: _weldDistanceEdit
+                Layout.fillWidth: true
+                placeholder: "0.001"
+            }
+
+            Item {
+               Layout.fillWidth: true
+            }
+
+            Components.Label {
+                Layout.fillWidth: true
+                text: "Vertex weld normal angle"
+                font.bold: true
+            }
+
+            Components.LineEdit {
+                id: _weldNormalAngleEdit
+                Layout.fillWidth: true
+                placeholder: "5"
+            }
+
+            Item {
+               Layout.fillWidth: true
+            }
+
+            Components.Label {
+                Layout.fillWidth: true
+                text: "Recomputed normals crease angle (empty to keep stored)"
+                font.bold: true
+            }
+
+            Components.LineEdit {
+                id: _creaseAngleEdit
+                Layout.fillWidth: true
+                placeholder: "60"
+            }
+
+            Item {
+               Layout.fillWidth: true
+            }
+
+            Components.Label {
+                Layout.fillWidth: true
+                text: "Geometry cache size in MB (0 to disable)"
+                font.bold: true
+            }
+
+            Components.LineEdit {
+                id: _geometryCacheSizeEdit
+                Layout.fillWidth: true
+                placeholder: "1024"
+            }
+
+            Item {
+               Layout.fillWidth: true
+            }
+
+            Components.Label {
+                Layout.fillWidth: true
+                text: "Texture cache size in MB (0 to disable)"
+                font.bold: true
+            }
+
+            Components.LineEdit {
+                id: _textureCacheSizeEdit
+                Layout.fillWidth: true
+                placeholder: "512"
+            }
+
+            Item {
+               Layout.fillWidth: true
+            }
+
+            Components.Label {
+                Layout.fillWidth: true
+                text: "Texture memory budget in MB (0 to disable)"
+                font.bold: true
+            }
+
+            Components.LineEdit {
+                id: _textureBudgetEdit
+                Layout.fillWidth: true
+                placeholder: "2048"
+            }
         }
     }
 
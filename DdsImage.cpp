@@ -0,0 +1,368 @@
+#include <cstring>
+#include "DdsImage.h"
+
+DdsImage::DdsImage() :
+    m_format(QQuick3DTextureData::Format::None),
+    m_blockSize(0),
+    m_isAlpha(false)
+{
+
+}
+
+uint32_t DdsImage::blockSize(QQuick3DTextureData::Format format)
+{
+    return (format == QQuick3DTextureData::Format::BC1 || format == QQuick3DTextureData::Format::BC4) ? 8 : 16;
+}
+
+QSize DdsImage::levelSize(const QSize &size, int level)
+{
+    return QSize(qMax(1, size.width() >> level), qMax(1, size.height() >> level));
+}
+
+qsizetype DdsImage::dataSize(QQuick3DTextureData::Format format, const QSize &size)
+{
+    return static_cast<qsizetype>((size.width() + 3) / 4) * ((size.height() + 3) / 4) * blockSize(format);
+}
+
+uint32_t DdsImage::fourCC(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) +
+        (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) +
+        (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) +
+        (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+bool DdsImage::read(const QByteArray &fileData)
+{
+    m_format = QQuick3DTextureData::Format::None;
+    m_levelOffsets.clear();
+    m_isAlpha = false;
+
+    if (fileData.size() < static_cast<qsizetype>(sizeof(Header))) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, fileData.constData(), sizeof(Header));
+
+    if (header.magic != Magic || header.size != sizeof(Header) - sizeof(uint32_t) ||
+        header.width == 0 || header.height == 0 || (header.caps2 & (CubeMapFlag | VolumeFlag)) != 0 ||
+        (header.pixelFormat.flags & FourCCFlag) == 0) {
+        return false;
+    }
+
+    qsizetype dataOffset = sizeof(Header);
+    uint32_t fourCCValue = header.pixelFormat.fourCC;
+
+    /*
+        Legacy four character codes and DX10 formats that map to an upload format
+    */
+    if (fourCCValue == fourCC('D', 'X', 'T', '1')) {
+        m_format = QQuick3DTextureData::Format::BC1;
+    } else if (fourCCValue == fourCC('D', 'X', 'T', '2') || fourCCValue == fourCC('D', 'X', 'T', '3')) {
+        m_format = QQuick3DTextureData::Format::BC2;
+    } else if (fourCCValue == fourCC('D', 'X', 'T', '4') || fourCCValue == fourCC('D', 'X', 'T', '5')) {
+        m_format = QQuick3DTextureData::Format::BC3;
+    } else if (fourCCValue == fourCC('A', 'T', 'I', '1') || fourCCValue == fourCC('B', 'C', '4', 'U')) {
+        m_format = QQuick3DTextureData::Format::BC4;
+    } else if (fourCCValue == fourCC('A', 'T', 'I', '2') || fourCCValue == fourCC('B', 'C', '5', 'U')) {
+        m_format = QQuick3DTextureData::Format::BC5;
+    } else if (fourCCValue == fourCC('D', 'X', '1', '0')) {
+        if (fileData.size() < static_cast<qsizetype>(sizeof(Header) + sizeof(HeaderDX10))) {
+            return false;
+        }
+
+        HeaderDX10 headerDX10;
+        std::memcpy(&headerDX10, fileData.constData() + sizeof(Header), sizeof(HeaderDX10));
+        dataOffset += sizeof(HeaderDX10);
+
+        if (headerDX10.arraySize > 1) {
+            return false;
+        }
+
+        switch (headerDX10.dxgiFormat) {
+        case 70:
+        case 71:
+        case 72:
+            m_format = QQuick3DTextureData::Format::BC1;
+            break;
+
+        case 73:
+        case 74:
+        case 75:
+            m_format = QQuick3DTextureData::Format::BC2;
+            break;
+
+        case 76:
+        case 77:
+        case 78:
+            m_format = QQuick3DTextureData::Format::BC3;
+            break;
+
+        case 79:
+        case 80:
+            m_format = QQuick3DTextureData::Format::BC4;
+            break;
+
+        case 82:
+        case 83:
+            m_format = QQuick3DTextureData::Format::BC5;
+            break;
+
+        case 94:
+        case 95:
+            m_format = QQuick3DTextureData::Format::BC6H;
+            break;
+
+        case 97:
+        case 98:
+        case 99:
+            m_format = QQuick3DTextureData::Format::BC7;
+            m_isAlpha = (headerDX10.miscFlags2 & AlphaModeMask) == AlphaModeStraight ||
+                (headerDX10.miscFlags2 & AlphaModeMask) == AlphaModePremultiplied;
+            break;
+
+        default:
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    m_blockSize = blockSize(m_format);
+    m_size = QSize(static_cast<int>(header.width), static_cast<int>(header.height));
+    m_fileData = fileData;
+
+    /*
+        Mip levels follow each other, levels cut off by the end of the file are dropped
+    */
+    uint32_t levelCount = (header.flags & MipMapCountFlag) != 0 && header.mipMapCount > 0 ? header.mipMapCount : 1;
+
+    for (uint32_t i = 0; i < levelCount && i < 32; i++) {
+        m_levelOffsets.append(dataOffset);
+
+        if (levelSize(static_cast<int>(i)).isEmpty() ||
+            dataOffset + levelDataSize(static_cast<int>(i)) > fileData.size()) {
+            m_levelOffsets.removeLast();
+            break;
+        }
+
+        dataOffset += levelDataSize(static_cast<int>(i));
+    }
+
+    if (m_levelOffsets.isEmpty()) {
+        m_format = QQuick3DTextureData::Format::None;
+        m_fileData.clear();
+        return false;
+    }
+
+    return true;
+}
+
+QQuick3DTextureData::Format DdsImage::format() const
+{
+    return m_format;
+}
+
+QSize DdsImage::size() const
+{
+    return m_size;
+}
+
+bool DdsImage::isAlpha() const
+{
+    return m_isAlpha;
+}
+
+int DdsImage::levelCount() const
+{
+    return static_cast<int>(m_levelOffsets.size());
+}
+
+QSize DdsImage::levelSize(int level) const
+{
+    return levelSize(m_size, level);
+}
+
+qsizetype DdsImage::levelDataSize(int level) const
+{
+    return dataSize(m_format, levelSize(level));
+}
+
+QByteArray DdsImage::levelData(int level) const
+{
+    return QByteArray(m_fileData.constData() + m_levelOffsets[level], levelDataSize(level));
+}
+
+QByteArray DdsImage::levelsData() const
+{
+    int lastLevel = levelCount() - 1;
+
+    return QByteArray(m_fileData.constData() + m_levelOffsets[0],
+        m_levelOffsets[lastLevel] + levelDataSize(lastLevel) - m_levelOffsets[0]);
+}
+
+bool DdsImage::canDecompress() const
+{
+    switch (m_format) {
+    case QQuick3DTextureData::Format::BC1:
+    case QQuick3DTextureData::Format::BC2:
+    case QQuick3DTextureData::Format::BC3:
+    case QQuick3DTextureData::Format::BC4:
+    case QQuick3DTextureData::Format::BC5:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void DdsImage::decodeColorBlock(const uint8_t *block, bool punchThrough, uint8_t *pixels)
+{
+    uint16_t colors[2];
+    uint32_t indices;
+    std::memcpy(colors, block, sizeof(colors));
+    std::memcpy(&indices, block + 4, sizeof(indices));
+
+    uint8_t palette[4][4];
+
+    for (uint32_t i = 0; i < 2; i++) {
+        uint32_t r = (colors[i] >> 11) & 31;
+        uint32_t g = (colors[i] >> 5) & 63;
+        uint32_t b = colors[i] & 31;
+
+        palette[i][0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        palette[i][1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        palette[i][2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        palette[i][3] = 255;
+    }
+
+    /*
+        BC1 blocks with the smaller color first have three colors and transparent black
+    */
+    if (!punchThrough || colors[0] > colors[1]) {
+        for (uint32_t c = 0; c < 3; c++) {
+            palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+        }
+
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    } else {
+        for (uint32_t c = 0; c < 3; c++) {
+            palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+
+    for (uint32_t i = 0; i < 16; i++) {
+        std::memcpy(pixels + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+    }
+}
+
+void DdsImage::decodeExplicitAlphaBlock(const uint8_t *block, uint8_t *pixels)
+{
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t alpha = (block[i / 2] >> ((i % 2) * 4)) & 15;
+        pixels[i * 4 + 3] = static_cast<uint8_t>(alpha * 17);
+    }
+}
+
+void DdsImage::decodeInterpolatedBlock(const uint8_t *block, uint32_t channel, uint8_t *pixels)
+{
+    uint32_t values[8];
+    values[0] = block[0];
+    values[1] = block[1];
+
+    if (values[0] > values[1]) {
+        for (uint32_t i = 1; i < 7; i++) {
+            values[i + 1] = ((7 - i) * values[0] + i * values[1]) / 7;
+        }
+    } else {
+        for (uint32_t i = 1; i < 5; i++) {
+            values[i + 1] = ((5 - i) * values[0] + i * values[1]) / 5;
+        }
+
+        values[6] = 0;
+        values[7] = 255;
+    }
+
+    uint64_t indices = 0;
+
+    for (uint32_t i = 0; i < 6; i++) {
+        indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+    }
+
+    for (uint32_t i = 0; i < 16; i++) {
+        pixels[i * 4 + channel] = static_cast<uint8_t>(values[(indices >> (i * 3)) & 7]);
+    }
+}
+
+QImage DdsImage::decompress(int level) const
+{
+    if (!canDecompress() || level < 0 || level >= levelCount()) {
+        return QImage();
+    }
+
+    QSize size = levelSize(level);
+    QImage image(size, QImage::Format_RGBA8888);
+    const uint8_t *blocks = reinterpret_cast<const uint8_t *>(m_fileData.constData() + m_levelOffsets[level]);
+    int blockColumns = (size.width() + 3) / 4;
+    int blockRows = (size.height() + 3) / 4;
+
+    for (int blockY = 0; blockY < blockRows; blockY++) {
+        for (int blockX = 0; blockX < blockColumns; blockX++) {
+            const uint8_t *block = blocks + (static_cast<qsizetype>(blockY) * blockColumns + blockX) * m_blockSize;
+            uint8_t pixels[16 * 4];
+
+            switch (m_format) {
+            case QQuick3DTextureData::Format::BC1:
+                decodeColorBlock(block, true, pixels);
+                break;
+
+            case QQuick3DTextureData::Format::BC2:
+                decodeColorBlock(block + 8, false, pixels);
+                decodeExplicitAlphaBlock(block, pixels);
+                break;
+
+            case QQuick3DTextureData::Format::BC3:
+                decodeColorBlock(block + 8, false, pixels);
+                decodeInterpolatedBlock(block, 3, pixels);
+                break;
+
+            case QQuick3DTextureData::Format::BC4:
+                decodeInterpolatedBlock(block, 0, pixels);
+
+                for (uint32_t i = 0; i < 16; i++) {
+                    pixels[i * 4 + 1] = pixels[i * 4];
+                    pixels[i * 4 + 2] = pixels[i * 4];
+                    pixels[i * 4 + 3] = 255;
+                }
+                break;
+
+            default:
+                decodeInterpolatedBlock(block, 0, pixels);
+                decodeInterpolatedBlock(block + 8, 1, pixels);
+
+                for (uint32_t i = 0; i < 16; i++) {
+                    pixels[i * 4 + 2] = 0;
+                    pixels[i * 4 + 3] = 255;
+                }
+                break;
+            }
+
+            int width = qMin(4, size.width() - blockX * 4);
+            int height = qMin(4, size.height() - blockY * 4);
+
+            for (int y = 0; y < height; y++) {
+                std::memcpy(image.scanLine(blockY * 4 + y) + blockX * 4 * 4, pixels + y * 4 * 4,
+                    static_cast<size_t>(width) * 4);
+            }
+        }
+    }
+
+    return image;
+}
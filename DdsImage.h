@@ -0,0 +1,99 @@
+#ifndef DDSIMAGE_H
+#define DDSIMAGE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QQuick3DTextureData>
+#include <QSize>
+
+/*
+    Block compressed DDS files, read without decompressing so the blocks
+    can be uploaded as they are. Uncompressed and cube/volume files are
+    left to the generic decoders.
+*/
+class DdsImage
+{
+
+public:
+    static constexpr const uint32_t Magic = ('D' << 0) + ('D' << 8) + ('S' << 16) + (' ' << 24);
+    static constexpr const uint32_t MipMapCountFlag = 0x20000;
+    static constexpr const uint32_t FourCCFlag = 0x4;
+    static constexpr const uint32_t RgbFlag = 0x40;
+    static constexpr const uint32_t AlphaPixelsFlag = 0x1;
+    static constexpr const uint32_t CubeMapFlag = 0x200;
+    static constexpr const uint32_t VolumeFlag = 0x200000;
+    static constexpr const uint32_t AlphaModeMask = 0x7;
+    static constexpr const uint32_t AlphaModeStraight = 1;
+    static constexpr const uint32_t AlphaModePremultiplied = 2;
+
+    struct PixelFormat {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t rgbBitCount;
+        uint32_t rBitMask;
+        uint32_t gBitMask;
+        uint32_t bBitMask;
+        uint32_t aBitMask;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t size;
+        uint32_t flags;
+        uint32_t height;
+        uint32_t width;
+        uint32_t pitchOrLinearSize;
+        uint32_t depth;
+        uint32_t mipMapCount;
+        uint32_t reserved1[11];
+        PixelFormat pixelFormat;
+        uint32_t caps;
+        uint32_t caps2;
+        uint32_t caps3;
+        uint32_t caps4;
+        uint32_t reserved2;
+    };
+
+    struct HeaderDX10 {
+        uint32_t dxgiFormat;
+        uint32_t resourceDimension;
+        uint32_t miscFlag;
+        uint32_t arraySize;
+        uint32_t miscFlags2;
+    };
+
+private:
+    QByteArray m_fileData;
+    QQuick3DTextureData::Format m_format;
+    QSize m_size;
+    uint32_t m_blockSize;
+    QList<qsizetype> m_levelOffsets;
+    bool m_isAlpha;
+
+    static uint32_t fourCC(char a, char b, char c, char d);
+    static void decodeColorBlock(const uint8_t *block, bool punchThrough, uint8_t *pixels);
+    static void decodeExplicitAlphaBlock(const uint8_t *block, uint8_t *pixels);
+    static void decodeInterpolatedBlock(const uint8_t *block, uint32_t channel, uint8_t *pixels);
+
+public:
+    DdsImage();
+    static uint32_t blockSize(QQuick3DTextureData::Format format);
+    static QSize levelSize(const QSize &size, int level);
+    static qsizetype dataSize(QQuick3DTextureData::Format format, const QSize &size);
+    bool read(const QByteArray &fileData);
+    QQuick3DTextureData::Format format() const;
+    QSize size() const;
+    bool isAlpha() const;
+    int levelCount() const;
+    QSize levelSize(int level) const;
+    qsizetype levelDataSize(int level) const;
+    QByteArray levelData(int level) const;
+    QByteArray levelsData() const;
+    bool canDecompress() const;
+    QImage decompress(int level) const;
+
+};
+
+#endif // DDSIMAGE_H
@@ -0,0 +1,165 @@
+#include <cstring>
+#include "CompiledStaticMesh.h"
+#include "DdsImageDecoder.h"
+#include "ImageProvider.h"
+
+int DdsImageDecoder::maskShift(uint32_t mask)
+{
+    for (int shift = 0; shift < 32; shift += 8) {
+        if (mask == 0xffu << shift) {
+            return shift;
+        }
+    }
+
+    return -1;
+}
+
+bool DdsImageDecoder::decodeCompressed(const QByteArray &fileData, Texture::DecodedImage *image)
+{
+    DdsImage ddsImage;
+
+    if (!ddsImage.read(fileData)) {
+        return false;
+    }
+
+    /*
+        Blocks are uploaded as stored, the whole mip chain is kept so levels can be
+        dropped for the budget and only the thumbnail source is decompressed from
+        the first mip level that fits it
+    */
+    image->data = ddsImage.levelsData();
+    image->format = ddsImage.format();
+    image->size = ddsImage.size();
+    image->levelCount = ddsImage.levelCount();
+    image->isAlpha = ddsImage.isAlpha();
+
+    int previewLevel = 0;
+
+    while (previewLevel + 1 < ddsImage.levelCount() &&
+        qMax(ddsImage.levelSize(previewLevel).width(), ddsImage.levelSize(previewLevel).height()) > ImageProvider::DefaultSize) {
+        previewLevel++;
+    }
+
+    image->source = ddsImage.decompress(previewLevel);
+
+    return true;
+}
+
+bool DdsImageDecoder::decodeUncompressed(const QByteArray &fileData, Texture::DecodedImage *image)
+{
+    if (fileData.size() < static_cast<qsizetype>(sizeof(DdsImage::Header))) {
+        return false;
+    }
+
+    DdsImage::Header header;
+    std::memcpy(&header, fileData.constData(), sizeof(DdsImage::Header));
+
+    const DdsImage::PixelFormat &pixelFormat = header.pixelFormat;
+    bool hasAlpha = (pixelFormat.flags & DdsImage::AlphaPixelsFlag) != 0 && pixelFormat.aBitMask != 0;
+    uint32_t bytesPerPixel = pixelFormat.rgbBitCount / 8;
+
+    if (header.magic != DdsImage::Magic || header.size != sizeof(DdsImage::Header) - sizeof(uint32_t) ||
+        header.width == 0 || header.height == 0 ||
+        (header.caps2 & (DdsImage::CubeMapFlag | DdsImage::VolumeFlag)) != 0 ||
+        (pixelFormat.flags & DdsImage::RgbFlag) == 0 || (bytesPerPixel != 3 && bytesPerPixel != 4)) {
+        return false;
+    }
+
+    int redShift = maskShift(pixelFormat.rBitMask);
+    int greenShift = maskShift(pixelFormat.gBitMask);
+    int blueShift = maskShift(pixelFormat.bBitMask);
+    int alphaShift = hasAlpha ? maskShift(pixelFormat.aBitMask) : 0;
+    size_t pixelCount = static_cast<size_t>(header.width) * header.height;
+
+    if (redShift < 0 || greenShift < 0 || blueShift < 0 || alphaShift < 0 ||
+        static_cast<size_t>(fileData.size()) - sizeof(DdsImage::Header) < pixelCount * bytesPerPixel) {
+        return false;
+    }
+
+    const uchar *pixels = reinterpret_cast<const uchar *>(fileData.constData()) + sizeof(DdsImage::Header);
+    image->data = QByteArray(static_cast<qsizetype>(pixelCount) * 4, Qt::Uninitialized);
+    uchar *target = reinterpret_cast<uchar *>(image->data.data());
+
+    /*
+        The usual byte orders are copied as rows, anything else goes through the masks
+    */
+    if (bytesPerPixel == 4 && greenShift == 8 && (!hasAlpha || alphaShift == 24) &&
+        ((redShift == 0 && blueShift == 16) || (redShift == 16 && blueShift == 0))) {
+        std::memcpy(target, pixels, pixelCount * 4);
+
+        if (redShift == 16) {
+            CompiledStaticMesh::PixelConverter::swapRedBlue(target, pixelCount);
+        }
+
+        if (!hasAlpha) {
+            CompiledStaticMesh::PixelConverter::setOpaque(target, pixelCount);
+        }
+    } else if (bytesPerPixel == 3 && redShift == 16 && greenShift == 8 && blueShift == 0) {
+        CompiledStaticMesh::PixelConverter::expandBgr(pixels, target, pixelCount);
+    } else {
+        for (size_t i = 0; i < pixelCount; i++) {
+            uint32_t value = 0;
+            std::memcpy(&value, pixels + i * bytesPerPixel, bytesPerPixel);
+
+            target[i * 4] = static_cast<uchar>(value >> redShift);
+            target[i * 4 + 1] = static_cast<uchar>(value >> greenShift);
+            target[i * 4 + 2] = static_cast<uchar>(value >> blueShift);
+            target[i * 4 + 3] = hasAlpha ? static_cast<uchar>(value >> alphaShift) : 255;
+        }
+    }
+
+    image->format = QQuick3DTextureData::Format::RGBA8;
+    image->size = QSize(static_cast<int>(header.width), static_cast<int>(header.height));
+    image->levelCount = 1;
+
+    return true;
+}
+
+bool DdsImageDecoder::canDecode(const QString &suffix, const QByteArray &fileData) const
+{
+    Q_UNUSED(suffix)
+
+    return fileData.startsWith("DDS ");
+}
+
+bool DdsImageDecoder::decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const
+{
+    Q_UNUSED(suffix)
+
+    return decodeCompressed(fileData, image) || decodeUncompressed(fileData, image);
+}
+
+bool DdsImageDecoder::decodePreview(const QString &suffix, const QByteArray &fileData, int maxSize,
+    Texture::DecodedImage *image) const
+{
+    Q_UNUSED(suffix)
+
+    DdsImage ddsImage;
+
+    if (!ddsImage.read(fileData) || qMax(ddsImage.size().width(), ddsImage.size().height()) <= maxSize) {
+        return false;
+    }
+
+    /*
+        The first embedded mip level that fits is uploaded as it is
+    */
+    int level = 0;
+
+    while (level < ddsImage.levelCount() &&
+        qMax(ddsImage.levelSize(level).width(), ddsImage.levelSize(level).height()) > maxSize) {
+        level++;
+    }
+
+    if (level == ddsImage.levelCount()) {
+        return false;
+    }
+
+    image->data = ddsImage.levelData(level);
+    image->format = ddsImage.format();
+    image->size = ddsImage.levelSize(level);
+    image->levelCount = 1;
+    image->isAlpha = ddsImage.isAlpha();
+    image->source = ddsImage.decompress(level);
+
+    return true;
+}
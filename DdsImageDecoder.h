@@ -0,0 +1,27 @@
+#ifndef DDSIMAGEDECODER_H
+#define DDSIMAGEDECODER_H
+
+#include "DdsImage.h"
+#include "ImageDecoder.h"
+
+/*
+    Block compressed DDS files keep their blocks and mip chain, uncompressed
+    24 and 32 bit files with byte aligned channel masks are expanded to RGBA8.
+*/
+class DdsImageDecoder: public ImageDecoder
+{
+
+private:
+    static int maskShift(uint32_t mask);
+    static bool decodeCompressed(const QByteArray &fileData, Texture::DecodedImage *image);
+    static bool decodeUncompressed(const QByteArray &fileData, Texture::DecodedImage *image);
+
+public:
+    bool canDecode(const QString &suffix, const QByteArray &fileData) const override;
+    bool decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const override;
+    bool decodePreview(const QString &suffix, const QByteArray &fileData, int maxSize,
+        Texture::DecodedImage *image) const override;
+
+};
+
+#endif // DDSIMAGEDECODER_H
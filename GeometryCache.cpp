@@ -0,0 +1,95 @@
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QStandardPaths>
+#include "GeometryCache.h"
+
+QString GeometryCache::directory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/geometry";
+}
+
+bool GeometryCache::entry(const QString &sourceFilename, const QString &options, Entry *entry)
+{
+    QFileInfo fileInfo(sourceFilename);
+    if (!fileInfo.exists()) {
+        return false;
+    }
+
+    /*
+        One cache file per source path and load options, validated by its stamp
+    */
+    QByteArray key = QCryptographicHash::hash((fileInfo.absoluteFilePath() + "|" + options).toUtf8(),
+        QCryptographicHash::Sha1).toHex();
+
+    QDir cacheDirectory(directory());
+    if (!cacheDirectory.mkpath(".")) {
+        return false;
+    }
+
+    CompiledStaticMesh::MappedFile mappedFile;
+    if (!mappedFile.open(sourceFilename.toStdString())) {
+        return false;
+    }
+
+    entry->filename = cacheDirectory.filePath(QString(key) + ".csmg");
+    entry->sourceStamp.size = mappedFile.size();
+    entry->sourceStamp.time = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry->sourceStamp.hash = CompiledStaticMesh::Hash::compute(mappedFile.data(), mappedFile.size());
+
+    return true;
+}
+
+bool GeometryCache::valid(const CompiledStaticMesh::Geometry *geometry, const Entry &entry)
+{
+    const CompiledStaticMesh::Geometry::SourceStamp &sourceStamp = geometry->sourceStamp();
+
+    if (sourceStamp.size != entry.sourceStamp.size ||
+        sourceStamp.time != entry.sourceStamp.time ||
+        sourceStamp.hash != entry.sourceStamp.hash) {
+        return false;
+    }
+
+    return true;
+}
+
+void GeometryCache::touch(const Entry &entry)
+{
+    QFile file(entry.filename);
+
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFile::FileModificationTime);
+    }
+}
+
+bool GeometryCache::commit(const QString &temporaryFilename, const Entry &entry)
+{
+    QFile::remove(entry.filename);
+
+    if (!QFile::rename(temporaryFilename, entry.filename)) {
+        QFile::remove(temporaryFilename);
+        return false;
+    }
+
+    return true;
+}
+
+void GeometryCache::trim(int limit, const Entry &keep)
+{
+    /*
+        Least recently used files go first, hits refresh the modification time
+    */
+    QList<QFileInfo> files = QDir(directory()).entryInfoList(QStringList({"*.csmg"}),
+        QDir::Files, QDir::Time);
+
+    QString keepFilename = QFileInfo(keep.filename).absoluteFilePath();
+    qint64 size = 0;
+
+    for (const QFileInfo &fileInfo : files) {
+        size += fileInfo.size();
+
+        if (size > limit * Megabyte && fileInfo.absoluteFilePath() != keepFilename) {
+            QFile::remove(fileInfo.absoluteFilePath());
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef GEOMETRYCACHE_H
+#define GEOMETRYCACHE_H
+
+#include <QDir>
+#include <QFileInfo>
+#include <QString>
+#include "CompiledStaticMesh.h"
+
+class GeometryCache
+{
+
+public:
+    static constexpr const int DefaultLimit = 1024;
+    static constexpr const qint64 Megabyte = 1024 * 1024;
+
+    struct Entry {
+        QString filename;
+        CompiledStaticMesh::Geometry::SourceStamp sourceStamp;
+    };
+
+    static QString directory();
+    static bool entry(const QString &sourceFilename, const QString &options, Entry *entry);
+    static bool valid(const CompiledStaticMesh::Geometry *geometry, const Entry &entry);
+    static void touch(const Entry &entry);
+    static bool commit(const QString &temporaryFilename, const Entry &entry);
+    static void trim(int limit, const Entry &keep);
+
+};
+
+#endif // GEOMETRYCACHE_H
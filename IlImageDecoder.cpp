@@ -0,0 +1,65 @@
+#include <QMutexLocker>
+#include "IlImageDecoder.h"
+
+QMutex IlImageDecoder::m_mutex;
+bool IlImageDecoder::m_isInit = false;
+
+bool IlImageDecoder::canDecode(const QString &suffix, const QByteArray &fileData) const
+{
+    Q_UNUSED(suffix)
+    Q_UNUSED(fileData)
+
+    return true;
+}
+
+bool IlImageDecoder::decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_isInit) {
+        ilInit();
+        m_isInit = true;
+    }
+
+    ILenum type = ilTypeFromExt(("." + suffix).toStdString().c_str());
+
+    if (type == IL_TYPE_UNKNOWN) {
+        type = ilDetermineTypeL(fileData.constData(), static_cast<ILuint>(fileData.size()));
+    }
+
+    ILuint id;
+    ilGenImages(1, &id);
+    ilBindImage(id);
+
+    if (ilLoadL(type, fileData.constData(), static_cast<ILuint>(fileData.size())) != IL_TRUE) {
+        ilDeleteImages(1, &id);
+        return false;
+    }
+
+    int width = ilGetInteger(IL_IMAGE_WIDTH);
+    int height = ilGetInteger(IL_IMAGE_HEIGHT);
+    int channels = ilGetInteger(IL_IMAGE_CHANNELS);
+
+    if (width < 1 || height < 1 || (channels != 3 && channels != 4)) {
+        ilDeleteImages(1, &id);
+        return false;
+    }
+
+    /*
+        Pixels are converted while copied into the texture buffer, the bound image is left as loaded
+    */
+    image->data = QByteArray(static_cast<qsizetype>(width) * height * 4, Qt::Uninitialized);
+
+    if (ilCopyPixels(0, 0, 0, static_cast<ILuint>(width), static_cast<ILuint>(height), 1, IL_RGBA, IL_UNSIGNED_BYTE,
+        image->data.data()) == 0) {
+        image->data.clear();
+    }
+
+    ilDeleteImages(1, &id);
+
+    image->format = QQuick3DTextureData::Format::RGBA8;
+    image->size = QSize(width, height);
+    image->levelCount = 1;
+
+    return !image->data.isEmpty();
+}
@@ -0,0 +1,27 @@
+#ifndef ILIMAGEDECODER_H
+#define ILIMAGEDECODER_H
+
+#include <QMutex>
+#include "ImageDecoder.h"
+
+#undef _UNICODE
+#include "DevIL/include/IL/il.h"
+
+/*
+    Fallback for files the in-tree decoders turn down. DevIL binds one
+    image at a time, so calls are serialized.
+*/
+class IlImageDecoder: public ImageDecoder
+{
+
+private:
+    static QMutex m_mutex;
+    static bool m_isInit;
+
+public:
+    bool canDecode(const QString &suffix, const QByteArray &fileData) const override;
+    bool decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const override;
+
+};
+
+#endif // ILIMAGEDECODER_H
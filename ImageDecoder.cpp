@@ -0,0 +1,106 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include "DdsImageDecoder.h"
+#include "IlImageDecoder.h"
+#include "ImageDecoder.h"
+#include "QtImageDecoder.h"
+#include "TgaImageDecoder.h"
+
+QMutex ImageDecoder::m_mutex;
+QList<ImageDecoder *> ImageDecoder::m_decoders;
+bool ImageDecoder::m_isInit = false;
+
+ImageDecoder::~ImageDecoder()
+{
+
+}
+
+QList<ImageDecoder *> ImageDecoder::decoders()
+{
+    QMutexLocker locker(&m_mutex);
+
+    /*
+        DevIL comes last and only sees files the in-tree decoders turned down
+    */
+    if (!m_isInit) {
+        m_decoders.append(new DdsImageDecoder());
+        m_decoders.append(new TgaImageDecoder());
+        m_decoders.append(new QtImageDecoder());
+        m_decoders.append(new IlImageDecoder());
+        m_isInit = true;
+    }
+
+    return m_decoders;
+}
+
+void ImageDecoder::registerDecoder(ImageDecoder *decoder)
+{
+    decoders();
+
+    QMutexLocker locker(&m_mutex);
+    m_decoders.prepend(decoder);
+}
+
+bool ImageDecoder::decodePreview(const QString &suffix, const QByteArray &fileData, int maxSize,
+    Texture::DecodedImage *image) const
+{
+    Q_UNUSED(suffix)
+    Q_UNUSED(fileData)
+    Q_UNUSED(maxSize)
+    Q_UNUSED(image)
+
+    return false;
+}
+
+bool ImageDecoder::readFile(const QString &filename, QByteArray *fileData)
+{
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    *fileData = file.readAll();
+    file.close();
+
+    return !fileData->isEmpty();
+}
+
+bool ImageDecoder::decodeFile(const QString &filename, Texture::DecodedImage *image)
+{
+    QByteArray fileData;
+
+    if (!readFile(filename, &fileData)) {
+        return false;
+    }
+
+    QString suffix = QFileInfo(filename).suffix().toLower();
+
+    for (const ImageDecoder *decoder : decoders()) {
+        if (decoder->canDecode(suffix, fileData) && decoder->decode(suffix, fileData, image)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ImageDecoder::decodeFilePreview(const QString &filename, int maxSize, Texture::DecodedImage *image)
+{
+    QByteArray fileData;
+
+    if (!readFile(filename, &fileData)) {
+        return false;
+    }
+
+    QString suffix = QFileInfo(filename).suffix().toLower();
+
+    for (const ImageDecoder *decoder : decoders()) {
+        if (decoder->canDecode(suffix, fileData)) {
+            return decoder->decodePreview(suffix, fileData, maxSize, image);
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,40 @@
+#ifndef IMAGEDECODER_H
+#define IMAGEDECODER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include "Texture.h"
+
+/*
+    Decoders turn file contents into texture images. They keep no state
+    between calls so any number of them may run at once, and write pixels
+    straight into the data buffer of the image they are given. Registered
+    decoders are asked before the built-in ones. Previews are optional and
+    only offered where they cost a fraction of the full decode.
+*/
+class ImageDecoder
+{
+
+private:
+    static QMutex m_mutex;
+    static QList<ImageDecoder *> m_decoders;
+    static bool m_isInit;
+
+    static QList<ImageDecoder *> decoders();
+    static bool readFile(const QString &filename, QByteArray *fileData);
+
+public:
+    virtual ~ImageDecoder();
+    virtual bool canDecode(const QString &suffix, const QByteArray &fileData) const = 0;
+    virtual bool decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const = 0;
+    virtual bool decodePreview(const QString &suffix, const QByteArray &fileData, int maxSize,
+        Texture::DecodedImage *image) const;
+    static void registerDecoder(ImageDecoder *decoder);
+    static bool decodeFile(const QString &filename, Texture::DecodedImage *image);
+    static bool decodeFilePreview(const QString &filename, int maxSize, Texture::DecodedImage *image);
+
+};
+
+#endif // IMAGEDECODER_H
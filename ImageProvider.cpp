@@ -1,60 +1,190 @@
+#include <QMutexLocker>
+#include <QThreadPool>
+#include "CompiledStaticMesh.h"
 #include "ImageProvider.h"
 
-QMap<QString, QPixmap *> ImageProvider::m_images;
+QMutex ImageProvider::m_mutex;
+QHash<QString, QImage> ImageProvider::m_sources;
+QHash<QString, ImageProvider::Thumbnail> ImageProvider::m_thumbnails;
+qint64 ImageProvider::m_cacheSize = 0;
+quint64 ImageProvider::m_useCounter = 0;
 
 ImageProvider::ImageProvider() :
-    QQuickImageProvider(QQuickImageProvider::Pixmap)
+    QQuickAsyncImageProvider()
 {
 
 }
 
-QPixmap ImageProvider::requestPixmap(const QString &name, QSize *size, const QSize &requestedSize)
+QQuickImageResponse *ImageProvider::requestImageResponse(const QString &name, const QSize &requestedSize)
 {
-    Q_UNUSED(requestedSize)
+    ImageProviderResponse *response = new ImageProviderResponse(name, requestedSize);
+    QThreadPool::globalInstance()->start(response);
 
-    if (size != nullptr) {
-        size->setWidth(0);
-        size->setHeight(0);
+    return response;
+}
+
+QString ImageProvider::thumbnailKey(const QString &name, const QSize &size)
+{
+    return name + "|" + QString::number(size.width()) + "x" + QString::number(size.height());
+}
+
+void ImageProvider::removeThumbnails(const QString &name)
+{
+    QString prefix = name + "|";
+
+    for (QHash<QString, Thumbnail>::iterator i = m_thumbnails.begin(); i != m_thumbnails.end();) {
+        if (i.key().startsWith(prefix)) {
+            m_cacheSize -= i->image.sizeInBytes();
+            i = m_thumbnails.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void ImageProvider::trim()
+{
+    while (m_cacheSize > MaxCacheSize && !m_thumbnails.isEmpty()) {
+        QHash<QString, Thumbnail>::iterator oldest = m_thumbnails.begin();
+
+        for (QHash<QString, Thumbnail>::iterator i = m_thumbnails.begin(); i != m_thumbnails.end(); ++i) {
+            if (i->lastUse < oldest->lastUse) {
+                oldest = i;
+            }
+        }
+
+        m_cacheSize -= oldest->image.sizeInBytes();
+        m_thumbnails.erase(oldest);
     }
+}
+
+QImage ImageProvider::thumbnail(const QString &name, const QSize &requestedSize)
+{
+    QImage source;
+
+    {
+        QMutexLocker locker(&m_mutex);
 
-    const QPixmap *image = nullptr;
+        source = m_sources.value(name);
 
-    if (m_images.contains(name) ) {
-        image = m_images[name];
+        if (source.isNull()) {
+            return QImage();
+        }
     }
 
-    if (image == nullptr) {
-        return QPixmap();
+    /*
+        Fit the requested size, or the default size when none is given, without enlarging
+    */
+    QSize size = source.size();
+    QSize boundingSize = requestedSize.isValid() && !requestedSize.isEmpty() ? requestedSize :
+        QSize(DefaultSize, DefaultSize);
+
+    if (size.width() > boundingSize.width() || size.height() > boundingSize.height()) {
+        size = size.scaled(boundingSize, Qt::KeepAspectRatio);
     }
 
-    if (image->isNull()) {
-        return QPixmap();
+    size = size.expandedTo(QSize(1, 1));
+
+    QString key = thumbnailKey(name, size);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        QHash<QString, Thumbnail>::iterator cached = m_thumbnails.find(key);
+
+        if (cached != m_thumbnails.end()) {
+            cached->lastUse = ++m_useCounter;
+            return cached->image;
+        }
     }
 
-    if (size != nullptr) {
-        size->setWidth(image->width());
-        size->setHeight(image->height());
+    /*
+        Mip levels get close to the size in linear light, the last step is a smooth scale
+    */
+    QImage image = source;
+    uint32_t width = static_cast<uint32_t>(source.width());
+    uint32_t height = static_cast<uint32_t>(source.height());
+    uint32_t levelCount = CompiledStaticMesh::MipGenerator::levelCount(width, height);
+    uint32_t level = 0;
+
+    while (level + 1 < levelCount &&
+        CompiledStaticMesh::MipGenerator::levelSize(width, level + 1) >= static_cast<uint32_t>(size.width()) &&
+        CompiledStaticMesh::MipGenerator::levelSize(height, level + 1) >= static_cast<uint32_t>(size.height())) {
+        level++;
     }
 
-    return *image;
+    if (level > 0) {
+        std::vector<std::vector<uint8_t>> levels;
+        CompiledStaticMesh::MipGenerator::generate(source.constBits(), width, height, level + 1, &levels, false);
+
+        image = QImage(levels.back().data(), static_cast<int>(CompiledStaticMesh::MipGenerator::levelSize(width, level)),
+            static_cast<int>(CompiledStaticMesh::MipGenerator::levelSize(height, level)),
+            QImage::Format::Format_RGBA8888).copy();
+    }
+
+    if (image.size() != size) {
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    } else if (level == 0) {
+        image = image.copy();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    /*
+        The source may have been replaced while the thumbnail was made
+    */
+    if (m_sources.value(name).constBits() != source.constBits()) {
+        return image;
+    }
+
+    Thumbnail thumbnail;
+    thumbnail.image = image;
+    thumbnail.lastUse = ++m_useCounter;
+
+    QHash<QString, Thumbnail>::iterator previous = m_thumbnails.find(key);
+
+    if (previous != m_thumbnails.end()) {
+        m_cacheSize -= previous->image.sizeInBytes();
+    }
+
+    m_thumbnails.insert(key, thumbnail);
+    m_cacheSize += image.sizeInBytes();
+    trim();
+
+    return image;
 }
 
-void ImageProvider::appendImage(const QString &name, QPixmap *image)
+void ImageProvider::appendImage(const QString &name, const QImage &source)
 {
-    if (m_images.contains(name)) {
-        delete m_images[name];
-    }
+    QMutexLocker locker(&m_mutex);
 
-    m_images[name] = image;
+    removeThumbnails(name);
+    m_sources.insert(name, source.format() == QImage::Format_RGBA8888 ? source :
+        source.convertToFormat(QImage::Format_RGBA8888));
 }
 
 void ImageProvider::clear()
 {
-    QStringList keys = m_images.keys();
+    QMutexLocker locker(&m_mutex);
 
-    for (qsizetype i = 0; i < keys.size(); i++) {
-        delete m_images[keys[i]];
-    }
+    m_sources.clear();
+    m_thumbnails.clear();
+    m_cacheSize = 0;
+}
+
+ImageProviderResponse::ImageProviderResponse(const QString &name, const QSize &requestedSize) :
+    m_name(name),
+    m_requestedSize(requestedSize)
+{
+    setAutoDelete(false);
+}
 
-    m_images.clear();
+QQuickTextureFactory *ImageProviderResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+void ImageProviderResponse::run()
+{
+    m_image = ImageProvider::thumbnail(m_name, m_requestedSize);
+    emit finished();
 }
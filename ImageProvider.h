@@ -1,22 +1,63 @@
 #ifndef IMAGEPROVIDER_H
 #define IMAGEPROVIDER_H
 
+#include <QHash>
 #include <QImage>
+#include <QMutex>
 #include <QQuickImageProvider>
+#include <QRunnable>
 #include <QString>
 
-class ImageProvider: public QQuickImageProvider
+/*
+    Thumbnails of texture maps, made on the thread pool when first requested
+    from the decoded image registered under the map name and kept in a
+    bounded cache per requested size.
+*/
+class ImageProvider: public QQuickAsyncImageProvider
 {
 
+public:
+    static constexpr const int DefaultSize = 256;
+    static constexpr const qint64 MaxCacheSize = 64 * 1024 * 1024;
+
 private:
-    static QMap<QString, QPixmap *> m_images;
+    struct Thumbnail {
+        QImage image;
+        quint64 lastUse;
+    };
+
+    static QMutex m_mutex;
+    static QHash<QString, QImage> m_sources;
+    static QHash<QString, Thumbnail> m_thumbnails;
+    static qint64 m_cacheSize;
+    static quint64 m_useCounter;
+
+    static QString thumbnailKey(const QString &name, const QSize &size);
+    static void removeThumbnails(const QString &name);
+    static void trim();
 
 public:
     ImageProvider();
-    QPixmap requestPixmap(const QString &name, QSize *size, const QSize &requestedSize) override;
-    static void appendImage(const QString &name, QPixmap *image);
+    QQuickImageResponse *requestImageResponse(const QString &name, const QSize &requestedSize) override;
+    static QImage thumbnail(const QString &name, const QSize &requestedSize);
+    static void appendImage(const QString &name, const QImage &source);
     static void clear();
 
 };
 
+class ImageProviderResponse: public QQuickImageResponse, public QRunnable
+{
+
+private:
+    QString m_name;
+    QSize m_requestedSize;
+    QImage m_image;
+
+public:
+    ImageProviderResponse(const QString &name, const QSize &requestedSize);
+    QQuickTextureFactory *textureFactory() const override;
+    void run() override;
+
+};
+
 #endif // IMAGEPROVIDER_H
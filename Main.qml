@@ -10,6 +10,7 @@ import QtQuick3D.Helpers
 import Qt.labs.folderlistmodel
 import Qt.labs.qmlmodels
 import QtQuick.Controls.Basic as Basic
+import Components.Model as ModelTypes
 import "." as Components
 
 Window {
@@ -59,6 +60,23 @@ Window {
         _cameraNode.eulerRotation = Qt.vector3d(0, 90, 0);
     }
 
+    function updateTransparentMaterials() {
+        var transparent = [];
+
+        for (var i = 0; i < _model.sourceMaterials.length; i++) {
+            if (_model.sourceMaterials[i].alphaMode === PrincipledMaterial.Blend) {
+                transparent.push(i);
+            }
+        }
+
+        _modelFile.setTransparentMaterials(transparent);
+        sortTransparent();
+    }
+
+    function sortTransparent() {
+        _modelFile.sortTransparent(_modelNode.mapPositionFromScene(_camera.scenePosition));
+    }
+
     function validCameraZoom() {
         if (_camera.z < _cameraController.minZoom) {
             _camera.z = _cameraController.minZoom;
@@ -77,16 +95,79 @@ Window {
         validCameraZoom();
     }
 
-    function openFile(filename) {
+    function openFile(filename, region) {
         console.log(filename)
+
+        /*
+            Regions are taken from the current view before it is reset
+        */
+        var cameraPosition = _modelNode.mapPositionFromScene(_camera.scenePosition);
+        var cameraForward = _modelNode.mapDirectionFromScene(_camera.forward);
+        var cameraUp = _modelNode.mapDirectionFromScene(_camera.up);
+        var viewCenter = _modelNode.mapPositionFromScene(_cameraNode.scenePosition);
+        var viewExtent = Qt.vector3d(_camera.z, _camera.z, _camera.z);
+
         _model.materials = [];
+        _model.sourceMaterials = [];
         _materialList.updateList();
 
-        if (!_modelFile.loadCompiledStaticMesh(filename)) {
+        var weldDistance = parseFloat(_settings.value("weldDistance"));
+        var weldNormalAngle = parseFloat(_settings.value("weldNormalAngle"));
+        _modelFile.weldVertices = !isNaN(weldDistance);
+
+        if (!isNaN(weldDistance)) {
+            _modelFile.weldDistance = weldDistance;
+        }
+
+        if (!isNaN(weldNormalAngle)) {
+            _modelFile.weldNormalAngle = weldNormalAngle;
+        }
+
+        var creaseAngle = parseFloat(_settings.value("creaseAngle"));
+        _modelFile.recomputeNormals = !isNaN(creaseAngle);
+
+        if (!isNaN(creaseAngle)) {
+            _modelFile.creaseAngle = creaseAngle;
+        }
+
+        var geometryCacheSize = parseInt(_settings.value("geometryCacheSize"));
+
+        if (!isNaN(geometryCacheSize)) {
+            _modelFile.geometryCacheLimit = geometryCacheSize;
+        }
+
+        var textureCacheSize = parseInt(_settings.value("textureCacheSize"));
+
+        if (!isNaN(textureCacheSize)) {
+            _modelFile.textureCacheLimit = textureCacheSize;
+        }
+
+        var textureBudget = parseInt(_settings.value("textureBudget"));
+
+        if (!isNaN(textureBudget)) {
+            _modelFile.textureBudget = textureBudget;
+        }
+
+        var loaded;
+
+        if (region === "view") {
+            loaded = _modelFile.loadCompiledStaticMeshFrustum(filename, cameraPosition, cameraForward, cameraUp,
+                _camera.fieldOfView, _scene.width / _scene.height, _camera.clipNear, _camera.clipFar);
+        } else if (region === "box") {
+            loaded = _modelFile.loadCompiledStaticMeshBox(filename, viewCenter.minus(viewExtent),
+                viewCenter.plus(viewExtent));
+        } else {
+            loaded = _modelFile.loadCompiledStaticMesh(filename);
+        }
+
+        if (!loaded) {
             Components.WindowsHelper.errorMessageBox("Could not open file: " + filename);
             return;
         }
 
+        _model.currentFile = filename;
+        resetView();
+
         var materialDirectories = [];
 
         var directory = _settings.value("directoryMaterials");
@@ -100,15 +181,70 @@ Window {
         }
 
         var component = Qt.createComponent("Material.qml");
+        _materialsLoadedTimer.normalMapped = [];
+
+        var coverage = _modelFile.materialCoverage(_modelNode.mapPositionFromScene(_camera.scenePosition),
+            _modelNode.mapDirectionFromScene(_camera.forward), _modelNode.mapDirectionFromScene(_camera.up),
+            _camera.fieldOfView, _scene.width / _scene.height);
 
+        /*
+            Textures pop in at preview size first, full resolution follows by screen coverage
+            from the reset view, list and tangent updates are batched
+        */
         for (const materialName of _modelFile.materials) {
-            var material = component.createObject(_model);
-            material.find(materialName, materialDirectories);
-            _model.materials.push(material);
+            const material = component.createObject(_model);
+            const materialIndex = _model.sourceMaterials.length;
+            material.vertexColorsEnabled = Qt.binding(() => _model.vertexColorsVisible);
+
+            material.diffuseLoaded.connect(() => _materialsLoadedTimer.materialLoaded(material, -1));
+            material.specularLoaded.connect(() => _materialsLoadedTimer.materialLoaded(material, -1));
+            material.normalLoaded.connect(() => _materialsLoadedTimer.materialLoaded(material, materialIndex));
+
+            _model.sourceMaterials.push(material);
+            material.find(materialName, materialDirectories, coverage[materialIndex]);
         }
 
+        /*
+            Subsets are split by lightmap group, so several can share one material
+        */
+        _model.materials = _modelFile.subsetMaterials.map(index => _model.sourceMaterials[index]);
+
+        updateTransparentMaterials();
+
         _materialList.updateList();
-        resetView();
+    }
+
+    Timer {
+        id: _materialsLoadedTimer
+        interval: 100
+
+        property var normalMapped: []
+
+        function materialLoaded(material, normalMappedIndex) {
+            if (_model.sourceMaterials.indexOf(material) < 0) {
+                return;
+            }
+
+            if (normalMappedIndex >= 0) {
+                normalMapped.push(normalMappedIndex);
+            }
+
+            if (!running) {
+                start();
+            }
+        }
+
+        onTriggered: {
+            if (normalMapped.length > 0) {
+                _modelFile.generateTangents(normalMapped);
+                normalMapped = [];
+            }
+
+            updateTransparentMaterials();
+            _materialList.updateList();
+            _infoLayout.textureCacheStatistics = _modelFile.textureCacheStatistics();
+            _infoLayout.textureBudgetStatistics = _modelFile.textureBudgetStatistics();
+        }
     }
 
     Settings {
@@ -132,7 +268,12 @@ Window {
         fileMode: FileDialog.OpenFile
 
         nameFilters: [
-            "Compiled static mesh (*.csm)"
+            "Compiled static mesh (*.csm *.csmz *.csmq *.csmt *.csmg *.csmp)",
+            "Compressed compiled static mesh (*.csmz)",
+            "Quantized compiled static mesh (*.csmq)",
+            "Tiled compiled static mesh (*.csmt)",
+            "Compiled static mesh geometry (*.csmg)",
+            "Compiled static mesh pack (*.csmp)"
         ]
 
         onAccepted: {
@@ -140,6 +281,66 @@ Window {
         }
     }
 
+    FileDialog {
+        id: _fileSaveDialog
+        fileMode: FileDialog.SaveFile
+        defaultSuffix: "csm"
+
+        nameFilters: [
+            "Compiled static mesh (*.csm)",
+            "Compressed compiled static mesh (*.csmz)",
+            "Quantized compiled static mesh (*.csmq)",
+            "Tiled compiled static mesh (*.csmt)",
+            "Compiled static mesh geometry (*.csmg)"
+        ]
+
+        onAccepted: {
+            var saved;
+
+            if (selectedFile.toString().toLowerCase().endsWith(".csmg")) {
+                saved = _modelFile.saveGeometry(selectedFile);
+            } else {
+                saved = _modelFile.saveCompiledStaticMesh(selectedFile);
+            }
+
+            if (!saved) {
+                Components.WindowsHelper.errorMessageBox("Could not save file: " + selectedFile);
+            }
+        }
+    }
+
+    FileDialog {
+        id: _packMembersDialog
+        fileMode: FileDialog.OpenFiles
+        title: "Select meshes to pack"
+
+        nameFilters: [
+            "Compiled static mesh (*.csm *.csmz *.csmq *.csmt *.csmg)"
+        ]
+
+        onAccepted: {
+            _packSaveDialog.members = selectedFiles;
+            _packSaveDialog.open();
+        }
+    }
+
+    FileDialog {
+        id: _packSaveDialog
+        fileMode: FileDialog.SaveFile
+        defaultSuffix: "csmp"
+        property var members: []
+
+        nameFilters: [
+            "Compiled static mesh pack (*.csmp)"
+        ]
+
+        onAccepted: {
+            if (!_modelFile.savePack(selectedFile, members)) {
+                Components.WindowsHelper.errorMessageBox("Could not save file: " + selectedFile);
+            }
+        }
+    }
+
     SplitView {
         anchors.fill: parent
         orientation: Qt.Vertical
@@ -247,6 +448,8 @@ Window {
                         clipNear: 0.1
                         clipFar: _cameraController.maxZoom * 2
 
+                        onScenePositionChanged: sortTransparent()
+
                         PointLight {
                             visible: false
                             brightness: 1
@@ -302,6 +505,11 @@ Window {
                     Model {
                         id: _model
                         geometry: _modelFile.modelGeometry
+
+                        property var sourceMaterials: []
+                        property url currentFile: ""
+                        property bool vertexColorsVisible: false
+                        property bool packMembersVisible: true
                     }
 
                     Model {
@@ -333,6 +541,38 @@ Window {
                             }
                         ]
                     }
+
+                    Model {
+                        id: _sidesModel
+                        geometry: _modelFile.sideGeometry
+                        visible: _modelFile.sidesVisible
+                        castsShadows: false
+                        receivesShadows: false
+
+                        materials: [
+                            DefaultMaterial {
+                                lighting: DefaultMaterial.NoLighting
+                                diffuseColor: Qt.rgba(0 / 255, 166 / 255, 255 / 255, 1)
+                            }
+                        ]
+                    }
+
+                    Model {
+                        id: _qualityModel
+                        geometry: _modelFile.qualityGeometry
+                        visible: _modelFile.qualityIssue !== ModelTypes.Model.NoQualityIssue
+                        castsShadows: false
+                        receivesShadows: false
+
+                        materials: [
+                            DefaultMaterial {
+                                lighting: DefaultMaterial.NoLighting
+                                cullMode: Material.NoCulling
+                                pointSize: 4
+                                diffuseColor: Qt.rgba(255 / 255, 166 / 255, 0 / 255, 1)
+                            }
+                        ]
+                    }
                 }
 
                 Item {
@@ -528,6 +768,10 @@ Window {
                 anchors.top: parent.top
                 anchors.margins: Components.Style.margins
                 columns: 2
+                id: _infoLayout
+
+                property var textureCacheStatistics: _modelFile.textureCacheStatistics()
+                property var textureBudgetStatistics: _modelFile.textureBudgetStatistics()
                 columnSpacing: anchors.margins / 2
                 rowSpacing: columnSpacing
 
@@ -632,6 +876,47 @@ Window {
                     text: _modelFile.materialCount
                     antialiasing: false
                 }
+
+                Components.Label {
+                    font.family: Components.RobotoMonoFont.name()
+                    shadow: true
+                    Layout.alignment: Qt.AlignRight
+                    color: "#ffffff"
+                    text: "Texture cache"
+                    antialiasing: false
+                }
+
+                Components.Label {
+                    font.family: Components.RobotoMonoFont.name()
+                    shadow: true
+                    color: "#00ff6a"
+                    text: _fileBrowserModel.formatBytes(_infoLayout.textureCacheStatistics.usage) + ", " +
+                        _infoLayout.textureCacheStatistics.hits + " hits, " +
+                        _infoLayout.textureCacheStatistics.misses + " misses"
+                    antialiasing: false
+                }
+
+                Components.Label {
+                    font.family: Components.RobotoMonoFont.name()
+                    shadow: true
+                    Layout.alignment: Qt.AlignRight
+                    color: "#ffffff"
+                    text: "Texture memory"
+                    antialiasing: false
+                }
+
+                Components.Label {
+                    font.family: Components.RobotoMonoFont.name()
+                    shadow: true
+                    color: _infoLayout.textureBudgetStatistics.limit > 0 &&
+                        _infoLayout.textureBudgetStatistics.usage > _infoLayout.textureBudgetStatistics.limit ?
+                        "#ff5050" : "#00ff6a"
+                    text: _fileBrowserModel.formatBytes(_infoLayout.textureBudgetStatistics.usage) +
+                        (_infoLayout.textureBudgetStatistics.limit > 0 ?
+                        " of " + _fileBrowserModel.formatBytes(_infoLayout.textureBudgetStatistics.limit) : "") + ", " +
+                        _infoLayout.textureBudgetStatistics.reducedCount + " reduced"
+                    antialiasing: false
+                }
             }
 
             /*
@@ -690,6 +975,33 @@ Window {
                         }
                     }
 
+                    Components.Button {
+                        Layout.fillHeight: true
+                        font.family: Components.MaterialIconsFont.name()
+                        implicitWidth: height
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        text: "\ue161"
+                        textAntialiasing: false
+                        enabled: _modelFile.version !== 0
+
+                        onClicked: {
+                            _fileSaveDialog.open();
+                        }
+                    }
+
+                    Components.Button {
+                        Layout.fillHeight: true
+                        font.family: Components.MaterialIconsFont.name()
+                        implicitWidth: height
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        text: "\ue149"
+                        textAntialiasing: false
+
+                        onClicked: {
+                            _packMembersDialog.open();
+                        }
+                    }
+
                     Components.Button {
                         Layout.fillHeight: true
                         font.family: Components.MaterialIconsFont.name()
@@ -851,6 +1163,179 @@ Window {
                         }
                     }
 
+                    Components.Button {
+                        Layout.fillHeight: true
+                        implicitWidth: height
+                        selected: _modelFile.sidesVisible
+                        enabled: _modelFile.hasSides
+                        text: "\ue3c1"
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        font.family: Components.MaterialIconsFont.name()
+                        textAntialiasing: false
+
+                        onClicked: {
+                            _modelFile.sidesVisible = !_modelFile.sidesVisible;
+                        }
+                    }
+
+                    Components.Button {
+                        Layout.fillHeight: true
+                        implicitWidth: height
+                        selected: _modelFile.regionLoaded
+                        enabled: _modelFile.hasTiles
+                        text: "\ue8f0"
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        font.family: Components.MaterialIconsFont.name()
+                        textAntialiasing: false
+
+                        Components.ContextMenu {
+                            itemWidth: 220
+                            id: _toolButtonsTilesContextMenu
+
+                            Action {
+                                text: "Whole mesh"
+
+                                onTriggered: {
+                                    openFile(_model.currentFile);
+                                }
+                            }
+
+                            Action {
+                                text: "Tiles in view"
+
+                                onTriggered: {
+                                    openFile(_model.currentFile, "view");
+                                }
+                            }
+
+                            Action {
+                                text: "Tiles around view center"
+
+                                onTriggered: {
+                                    openFile(_model.currentFile, "box");
+                                }
+                            }
+                        }
+
+                        onClicked: {
+                            _toolButtonsTilesContextMenu.x = -_toolButtonsTilesContextMenu.width + width;
+                            _toolButtonsTilesContextMenu.y = height + Components.Style.margins / 2;
+                            _toolButtonsTilesContextMenu.open();
+                        }
+                    }
+
+                    Components.Button {
+                        Layout.fillHeight: true
+                        implicitWidth: height
+                        selected: _model.packMembersVisible && _modelFile.packMembers.length > 0
+                        enabled: _modelFile.packMembers.length > 0
+                        text: "\ueb2c"
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        font.family: Components.MaterialIconsFont.name()
+                        textAntialiasing: false
+
+                        onClicked: {
+                            _model.packMembersVisible = !_model.packMembersVisible;
+                        }
+                    }
+
+                    Components.Button {
+                        Layout.fillHeight: true
+                        implicitWidth: height
+                        selected: _model.vertexColorsVisible
+                        enabled: _modelFile.hasVertexColors
+                        text: "\ue40a"
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        font.family: Components.MaterialIconsFont.name()
+                        textAntialiasing: false
+
+                        onClicked: {
+                            _model.vertexColorsVisible = !_model.vertexColorsVisible;
+                        }
+                    }
+
+                    Components.Button {
+                        Layout.fillHeight: true
+                        implicitWidth: height
+                        selected: _qualityModel.visible
+                        enabled: _modelFile.hasSourceData
+                        text: "\ue868"
+                        radius: _toolButtonsLayoutFrame.innerRadius
+                        font.family: Components.MaterialIconsFont.name()
+                        textAntialiasing: false
+
+                        Components.ContextMenu {
+                            itemWidth: 220
+                            id: _toolButtonsQualityContextMenu
+
+                            Action {
+                                text: "Hide issues"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.NoQualityIssue;
+                                }
+                            }
+
+                            Action {
+                                text: "Degenerate faces (" + _modelFile.degenerateFaceCount + ")"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.DegenerateFaces;
+                                }
+                            }
+
+                            Action {
+                                text: "Zero area faces (" + _modelFile.zeroAreaFaceCount + ")"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.ZeroAreaFaces;
+                                }
+                            }
+
+                            Action {
+                                text: "Duplicate faces (" + _modelFile.duplicateFaceCount + ")"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.DuplicateFaces;
+                                }
+                            }
+
+                            Action {
+                                text: "Non-manifold edges (" + _modelFile.nonManifoldEdgeCount + ")"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.NonManifoldEdges;
+                                }
+                            }
+
+                            Action {
+                                text: "Open edges (" + _modelFile.openEdgeCount + ")"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.OpenEdges;
+                                }
+                            }
+
+                            Action {
+                                text: "Unreferenced vertices (" + _modelFile.unreferencedVertexCount + ")"
+
+                                onTriggered: {
+                                    _modelFile.qualityIssue = ModelTypes.Model.UnreferencedVertices;
+                                }
+                            }
+                        }
+
+                        onClicked: {
+                            if (!_modelFile.qualityAnalyzed) {
+                                _modelFile.analyzeQuality();
+                            }
+
+                            _toolButtonsQualityContextMenu.x = -_toolButtonsQualityContextMenu.width + width;
+                            _toolButtonsQualityContextMenu.y = height + Components.Style.margins / 2;
+                            _toolButtonsQualityContextMenu.open();
+                        }
+                    }
+
                     Components.Button {
                         Layout.fillHeight: true
                         implicitWidth: height
@@ -1067,6 +1552,44 @@ Window {
                 }
             }
 
+            /*
+                Pack members
+            */
+            Components.Frame {
+                anchors.left: parent.left
+                anchors.top: _toolButtonsLayoutFrame.bottom
+                anchors.margins: Components.Style.margins
+                width: 240
+                height: Math.min(_packMembersList.contentHeight + border.width * 2, parent.height / 2)
+                radius: Components.Style.radius
+                visible: _model.packMembersVisible && _modelFile.packMembers.length > 0
+                id: _packMembersFrame
+
+                ListView {
+                    id: _packMembersList
+                    x: _packMembersFrame.border.width
+                    y: _packMembersFrame.border.width
+                    width: parent.width - _packMembersFrame.border.width * 2
+                    height: parent.height - _packMembersFrame.border.width * 2
+                    clip: true
+                    boundsBehavior: Flickable.StopAtBounds
+                    model: _modelFile.packMembers
+                    ScrollBar.vertical: Components.ScrollBar {}
+
+                    delegate: Components.Button {
+                        width: _packMembersList.width
+                        height: Math.round(Components.Style.margins * 2)
+                        radius: _packMembersFrame.innerRadius
+                        selected: modelData === _modelFile.packMember
+                        text: modelData
+
+                        onClicked: {
+                            openFile("file:///" + _modelFile.packFilename + "#" + encodeURIComponent(modelData));
+                        }
+                    }
+                }
+            }
+
             /*
                 Content bar button
             */
@@ -1616,7 +2139,12 @@ Window {
                             nameFilters: {
                                 if (_fileBrowserFilterButton.selected) {
                                     return [
-                                        "*.csm"
+                                        "*.csm",
+                                        "*.csmz",
+                                        "*.csmq",
+                                        "*.csmt",
+                                        "*.csmg",
+                                        "*.csmp"
                                     ];
                                 }
 
@@ -1629,7 +2157,12 @@ Window {
                                         _fileBrowserModel.currentPath + "/" + name;
                                     _fileBrowserContextMenu.popup()
                                 } else {
-                                    if (name.toLowerCase().endsWith(".csm")) {
+                                    if (name.toLowerCase().endsWith(".csm") ||
+                                        name.toLowerCase().endsWith(".csmz") ||
+                                        name.toLowerCase().endsWith(".csmq") ||
+                                        name.toLowerCase().endsWith(".csmt") ||
+                                        name.toLowerCase().endsWith(".csmg") ||
+                                        name.toLowerCase().endsWith(".csmp")) {
                                         openFile("file:///" + _fileBrowserModel.currentPath + "/" + name);
                                     }
                                 }
@@ -1641,7 +2174,12 @@ Window {
                                     return;
                                 }
 
-                                if (name.toLowerCase().endsWith(".csm")) {
+                                if (name.toLowerCase().endsWith(".csm") ||
+                                    name.toLowerCase().endsWith(".csmz") ||
+                                    name.toLowerCase().endsWith(".csmq") ||
+                                    name.toLowerCase().endsWith(".csmt") ||
+                                    name.toLowerCase().endsWith(".csmg") ||
+                                    name.toLowerCase().endsWith(".csmp")) {
                                     return;
                                 }
 
@@ -1764,6 +2302,10 @@ Window {
 
                                 switch (fileSuffix) {
                                 case "csm":
+                                case "csmz":
+                                case "csmq":
+                                case "csmt":
+                                case "csmg":
                                     return "\ue9fe";
 
                                 case "dds":
@@ -1785,6 +2327,7 @@ Window {
                                 case "bz2":
                                 case "7z":
                                 case "pak":
+                                case "csmp":
                                     return "\ueb2c";
 
                                 default:
@@ -1801,7 +2344,8 @@ Window {
                                     return Components.Style.colorFileBrowserDirectory;
                                 }
 
-                                if (fileSuffix === "csm") {
+                                if (fileSuffix === "csm" || fileSuffix === "csmz" || fileSuffix === "csmq" ||
+                                    fileSuffix === "csmt" || fileSuffix === "csmg" || fileSuffix === "csmp") {
                                     if (highlighted) {
                                         return Qt.lighter(Components.Style.colorFileBrowserModel, 1.5);
                                     }
@@ -2063,8 +2607,8 @@ Window {
                         function updateList() {
                             var list = [];
 
-                            for (var i = 0; i < _model.materials.length; i++) {
-                                const material = _model.materials[i];
+                            for (var i = 0; i < _model.sourceMaterials.length; i++) {
+                                const material = _model.sourceMaterials[i];
 
                                 list.push({
                                     name: material.name,
@@ -2136,11 +2680,12 @@ Window {
                                     text: "Diffuse"
 
                                     onOpenImage: function(filename) {
-                                        var material = _model.materials[index];
+                                        var material = _model.sourceMaterials[index];
                                         if (material.diffuseMapTextureData.loadByFilename(filename, material.diffuseName)) {
                                             resetSource();
                                             filename = material.diffuseMapTextureData.filename();
                                             material.diffuseFilename = filename;
+                                            updateTransparentMaterials();
                                         }
                                     }
                                 }
@@ -2174,7 +2719,7 @@ Window {
                                     text: "Specular"
 
                                     onOpenImage: function(filename) {
-                                        var material = _model.materials[index];
+                                        var material = _model.sourceMaterials[index];
                                         if (material.specularMapTextureData.loadByFilename(filename, material.specularName)) {
                                             resetSource();
                                             filename = material.specularMapTextureData.filename();
@@ -2212,11 +2757,12 @@ Window {
                                     text: "Normal"
 
                                     onOpenImage: function(filename) {
-                                        var material = _model.materials[index];
+                                        var material = _model.sourceMaterials[index];
                                         if (material.normalMapTextureData.loadByFilename(filename, material.normalName)) {
                                             resetSource();
                                             filename = material.normalMapTextureData.filename();
                                             material.normalFilename = filename;
+                                            _modelFile.generateTangents([index]);
                                         }
                                     }
                                 }
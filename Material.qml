@@ -8,6 +8,7 @@ PrincipledMaterial {
     id: _material
 
     property var materialDirectories: []
+    property real coverage: 0
     property string name
     property string diffuseName
     property string diffuseFilename
@@ -22,6 +23,10 @@ PrincipledMaterial {
     property alias specularMapTextureData: _normalMapTextureData
     property alias normalMapTextureData: _specularMapTextureData
 
+    signal diffuseLoaded()
+    signal specularLoaded()
+    signal normalLoaded()
+
     Settings {
         id: _settings
     }
@@ -45,70 +50,92 @@ PrincipledMaterial {
         return list;
     }
 
-    function find(name, materialDirectories) {
+    function find(name, materialDirectories, coverage) {
         _material.name = name;
         _material.diffuseName = name + "_diffuse";
         _material.specularName = name + "_specular";
         _material.normalName = name + "_normal";
         _material.materialDirectories = materialDirectories;
+        _material.coverage = coverage;
+
+        /*
+            Maps decode on the thread pool, specular and normal maps follow the diffuse directory
+        */
+        _diffuseMapTextureData.loadAsync(materialDirectories,
+            textureMapMaskList(name, _settings.value("textureMapSuffixesDiffuse"), true), _material.diffuseName,
+            _material.coverage);
+    }
 
-        var targetDirectory;
-
-        for (var textureMapMask of textureMapMaskList(name, _settings.value("textureMapSuffixesDiffuse"), true)) {
-            for (var directory of materialDirectories) {
-                if (_diffuseMapTextureData.load(directory, textureMapMask, _material.diffuseName)) {
-                    targetDirectory = directory;
-                    _material.diffuseFilename = _diffuseMapTextureData.filename();
-                    break;
-                }
-            }
-        }
-
-        if (!targetDirectory) {
-            return;
-        }
-
-        for (textureMapMask of textureMapMaskList(name, _settings.value("textureMapSuffixesSpecular"))) {
-            if (_specularMapTextureData.load(targetDirectory, textureMapMask, _material.specularName)) {
-                _material.specularFilename = _specularMapTextureData.filename();
-                break;
-            }
+    alphaMode: {
+        if (!_diffuseMapTextureData.isAlpha) {
+            return PrincipledMaterial.Default;
         }
 
-        for (textureMapMask of textureMapMaskList(name, _settings.value("textureMapSuffixesNormal"))) {
-            if (_normalMapTextureData.load(targetDirectory, textureMapMask, _material.normalName)) {
-                _material.normalFilename = _normalMapTextureData.filename();
-                break;
-            }
-        }
+        return _diffuseMapTextureData.isAlphaMask ? PrincipledMaterial.Mask : PrincipledMaterial.Blend;
     }
 
-    alphaMode: _diffuseMapTextureData.isAlpha ? PrincipledMaterial.Blend : PrincipledMaterial.Default
-
     baseColorMap: Texture {
         id: _diffuseMapTexture
-        generateMipmaps: true
+        generateMipmaps: !_diffuseMapTextureData.isCompressed
 
         textureData: Components.Texture {
             id: _diffuseMapTextureData
+
+            onLoadFinished: function(loaded) {
+                if (!loaded) {
+                    return;
+                }
+
+                _material.diffuseFilename = filename();
+                _material.diffuseLoaded();
+
+                _specularMapTextureData.loadAsync([directory()],
+                    textureMapMaskList(_material.name, _settings.value("textureMapSuffixesSpecular")),
+                    _material.specularName, _material.coverage);
+                _normalMapTextureData.loadAsync([directory()],
+                    textureMapMaskList(_material.name, _settings.value("textureMapSuffixesNormal")),
+                    _material.normalName, _material.coverage);
+            }
+
+            onFullResolutionLoaded: {
+                _material.diffuseLoaded();
+            }
         }
     }
 
     normalMap: Texture {
         id: _normalMapTexture
-        generateMipmaps: true
+        generateMipmaps: !_normalMapTextureData.isCompressed
 
         textureData: Components.Texture {
             id: _normalMapTextureData
+
+            onLoadFinished: function(loaded) {
+                if (loaded) {
+                    _material.normalFilename = filename();
+                    _material.normalLoaded();
+                }
+            }
         }
     }
 
     specularMap: Texture {
         id: _specularMapTexture
-        generateMipmaps: true
+        generateMipmaps: !_specularMapTextureData.isCompressed
 
         textureData: Components.Texture {
             id: _specularMapTextureData
+
+            onLoadFinished: function(loaded) {
+                if (loaded) {
+                    _material.specularFilename = filename();
+                    _material.specularLoaded();
+                }
+            }
+
+            onFullResolutionLoaded: {
+                _material.specularLoaded();
+            }
         }
     }
 }
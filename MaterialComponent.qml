@@ -25,7 +25,7 @@ Components.Frame {
         fileMode: FileDialog.OpenFile
 
         nameFilters: [
-            "Image files (*.jpg; *.bmp; *.png; *.dds)"
+            "Image files (*.jpg; *.bmp; *.png; *.tga; *.dds)"
         ]
 
         onAccepted: {
@@ -90,8 +90,10 @@ Components.Frame {
         id: _mapImage
 
         cache: false
+        asynchronous: true
         anchors.fill: _mask
         fillMode: Image.PreserveAspectFit
+        sourceSize: Qt.size(Math.ceil(width), Math.ceil(height))
         layer.enabled: true
 
         layer.effect: OpacityMask {
@@ -2,7 +2,21 @@
 
 Model::Model(QObject *parent) :
     QObject(parent),
-    m_compiledStaticMesh(nullptr)
+    m_compiledStaticMesh(nullptr),
+    m_cachedGeometry(nullptr),
+    m_qualityAnalyzed(false),
+    m_qualityIssue(NoQualityIssue),
+    m_weldVertices(false),
+    m_weldDistance(CompiledStaticMesh::Welder::DefaultDistance),
+    m_weldNormalAngle(CompiledStaticMesh::Welder::DefaultNormalAngle),
+    m_recomputeNormals(false),
+    m_creaseAngle(CompiledStaticMesh::NormalGenerator::DefaultCreaseAngle),
+    m_normalsRecomputed(false),
+    m_geometryCacheLimit(GeometryCache::DefaultLimit),
+    m_geometryCached(false),
+    m_modelStride(0),
+    m_sortValid(false),
+    m_sidesVisible(false)
 {
     build();
 }
@@ -42,6 +56,17 @@ QStringList Model::materials() const
     return m_materials;
 }
 
+QList<int> Model::subsetMaterials() const
+{
+    QList<int> subsetMaterials;
+
+    for (const Subset &subset : m_subsets) {
+        subsetMaterials.append(static_cast<int>(subset.material));
+    }
+
+    return subsetMaterials;
+}
+
 uint32_t Model::version() const
 {
     if (m_compiledStaticMesh == nullptr) {
@@ -107,39 +132,353 @@ QVector3D Model::boundingBoxMax() const
     return m_boundingBox.max;
 }
 
-void Model::release()
+bool Model::weldVertices() const
 {
-    if (m_compiledStaticMesh != nullptr) {
-        delete m_compiledStaticMesh;
-        m_compiledStaticMesh = nullptr;
+    return m_weldVertices;
+}
+
+void Model::setWeldVertices(bool weldVertices)
+{
+    if (m_weldVertices == weldVertices) {
+        return;
+    }
+
+    m_weldVertices = weldVertices;
+    emit optionsChanged();
+}
+
+float Model::weldDistance() const
+{
+    return m_weldDistance;
+}
+
+void Model::setWeldDistance(float weldDistance)
+{
+    if (m_weldDistance == weldDistance) {
+        return;
+    }
+
+    m_weldDistance = weldDistance;
+    emit optionsChanged();
+}
+
+float Model::weldNormalAngle() const
+{
+    return m_weldNormalAngle;
+}
+
+void Model::setWeldNormalAngle(float weldNormalAngle)
+{
+    if (m_weldNormalAngle == weldNormalAngle) {
+        return;
+    }
+
+    m_weldNormalAngle = weldNormalAngle;
+    emit optionsChanged();
+}
+
+bool Model::recomputeNormals() const
+{
+    return m_recomputeNormals;
+}
+
+void Model::setRecomputeNormals(bool recomputeNormals)
+{
+    if (m_recomputeNormals == recomputeNormals) {
+        return;
+    }
+
+    m_recomputeNormals = recomputeNormals;
+    emit optionsChanged();
+}
+
+float Model::creaseAngle() const
+{
+    return m_creaseAngle;
+}
+
+void Model::setCreaseAngle(float creaseAngle)
+{
+    if (m_creaseAngle == creaseAngle) {
+        return;
+    }
+
+    m_creaseAngle = creaseAngle;
+    emit optionsChanged();
+}
+
+bool Model::normalsRecomputed() const
+{
+    return m_normalsRecomputed;
+}
+
+int Model::geometryCacheLimit() const
+{
+    return m_geometryCacheLimit;
+}
+
+void Model::setGeometryCacheLimit(int geometryCacheLimit)
+{
+    if (m_geometryCacheLimit == geometryCacheLimit) {
+        return;
+    }
+
+    m_geometryCacheLimit = geometryCacheLimit;
+    emit optionsChanged();
+}
+
+int Model::textureCacheLimit() const
+{
+    return TextureCache::limit();
+}
+
+void Model::setTextureCacheLimit(int textureCacheLimit)
+{
+    if (TextureCache::limit() == textureCacheLimit) {
+        return;
+    }
+
+    TextureCache::setLimit(textureCacheLimit);
+    emit optionsChanged();
+}
+
+QVariantMap Model::textureCacheStatistics() const
+{
+    TextureCache::Statistics statistics = TextureCache::statistics();
+    QVariantMap map;
+
+    map["usage"] = statistics.usage;
+    map["limit"] = statistics.limit;
+    map["hits"] = statistics.hits;
+    map["misses"] = statistics.misses;
+    map["entryCount"] = statistics.entryCount;
+
+    return map;
+}
+
+int Model::textureBudget() const
+{
+    return TextureBudget::limit();
+}
+
+void Model::setTextureBudget(int textureBudget)
+{
+    if (TextureBudget::limit() == textureBudget) {
+        return;
+    }
+
+    TextureBudget::setLimit(textureBudget);
+    emit optionsChanged();
+}
+
+QVariantMap Model::textureBudgetStatistics() const
+{
+    TextureBudget::Statistics statistics = TextureBudget::statistics();
+    QVariantMap map;
+
+    map["usage"] = statistics.usage;
+    map["limit"] = statistics.limit;
+    map["textureCount"] = statistics.textureCount;
+    map["reducedCount"] = statistics.reducedCount;
+
+    return map;
+}
+
+bool Model::geometryCached() const
+{
+    return m_geometryCached;
+}
+
+bool Model::hasSourceData() const
+{
+    if (m_compiledStaticMesh == nullptr) {
+        return false;
+    }
+
+    return m_compiledStaticMesh->version() != CompiledStaticMesh::Geometry::Version;
+}
+
+bool Model::hasSides() const
+{
+    return sideSource() != nullptr;
+}
+
+bool Model::sidesVisible() const
+{
+    return m_sidesVisible;
+}
+
+void Model::setSidesVisible(bool sidesVisible)
+{
+    if (m_sidesVisible == sidesVisible) {
+        return;
+    }
+
+    m_sidesVisible = sidesVisible;
+    buildSideGeometry();
+
+    emit sidesChanged();
+}
+
+const QQuick3DGeometry *Model::sideGeometry() const
+{
+    return &m_sideGeometry;
+}
+
+bool Model::hasTiles() const
+{
+    if (m_compiledStaticMesh == nullptr) {
+        return false;
+    }
+
+    return m_compiledStaticMesh->version() == CompiledStaticMesh::Tiled::Version;
+}
+
+bool Model::regionLoaded() const
+{
+    return !m_regionPlanes.isEmpty();
+}
+
+QString Model::packFilename() const
+{
+    return m_packFilename;
+}
+
+QStringList Model::packMembers() const
+{
+    return m_packMembers;
+}
+
+QString Model::packMember() const
+{
+    return m_packMember;
+}
+
+bool Model::hasVertexColors() const
+{
+    return modelAttributeOffset(CompiledStaticMesh::Geometry::ColorSemantic) >= 0;
+}
+
+const QQuick3DGeometry *Model::qualityGeometry() const
+{
+    return &m_qualityGeometry;
+}
+
+bool Model::qualityAnalyzed() const
+{
+    return m_qualityAnalyzed;
+}
+
+int Model::qualityIssue() const
+{
+    return m_qualityIssue;
+}
+
+void Model::setQualityIssue(int qualityIssue)
+{
+    if (qualityIssue < NoQualityIssue ||
+        qualityIssue >= CompiledStaticMesh::Analyzer::IssueCount) {
+        qualityIssue = NoQualityIssue;
+    }
+
+    if (m_qualityIssue == qualityIssue) {
+        return;
     }
 
+    m_qualityIssue = qualityIssue;
+    buildQualityGeometry();
+
+    emit qualityChanged();
+}
+
+uint32_t Model::degenerateFaceCount() const
+{
+    return m_analyzer.count(CompiledStaticMesh::Analyzer::DegenerateFaces);
+}
+
+uint32_t Model::zeroAreaFaceCount() const
+{
+    return m_analyzer.count(CompiledStaticMesh::Analyzer::ZeroAreaFaces);
+}
+
+uint32_t Model::duplicateFaceCount() const
+{
+    return m_analyzer.count(CompiledStaticMesh::Analyzer::DuplicateFaces);
+}
+
+uint32_t Model::nonManifoldEdgeCount() const
+{
+    return m_analyzer.count(CompiledStaticMesh::Analyzer::NonManifoldEdges);
+}
+
+uint32_t Model::openEdgeCount() const
+{
+    return m_analyzer.count(CompiledStaticMesh::Analyzer::OpenEdges);
+}
+
+uint32_t Model::unreferencedVertexCount() const
+{
+    return m_analyzer.count(CompiledStaticMesh::Analyzer::UnreferencedVertices);
+}
+
+void Model::release()
+{
     m_materials.clear();
+    m_materialNames.clear();
     m_boundingBox.min = QVector3D();
     m_boundingBox.max = QVector3D();
     m_materialDirectories.clear();
     m_filename.clear();
     m_path.clear();
     m_modelGeometry.clear();
+    m_modelVertices.clear();
+    m_modelIndices.clear();
+    m_modelAttributes.clear();
+    m_modelStride = 0;
+    m_subsets.clear();
+    m_sortValid = false;
     m_normalGeometry.clear();
+    m_normalVertices.clear();
     m_gridGeometry.clear();
+    m_gridVertices.clear();
+    m_faces.clear();
+    m_vertices.clear();
+    m_analyzer.clear();
+    m_qualityAnalyzed = false;
+    m_qualityIssue = NoQualityIssue;
+    m_qualityGeometry.clear();
+    m_faceSides.clear();
+    m_regionPlanes.clear();
+    m_packMember.clear();
+    m_sideGeometry.clear();
+    m_sideVertices.clear();
+    m_normalsRecomputed = false;
     ImageProvider::clear();
 
+    /*
+        Geometry files back the buffers above, so unmap last
+    */
+    if (m_cachedGeometry != nullptr) {
+        delete m_cachedGeometry;
+        m_cachedGeometry = nullptr;
+    }
+
+    if (m_compiledStaticMesh != nullptr) {
+        delete m_compiledStaticMesh;
+        m_compiledStaticMesh = nullptr;
+    }
+
+    m_geometryCached = false;
+
     emit boundingBoxChanged();
     emit geometryChanged();
+    emit qualityChanged();
+    emit sidesChanged();
 }
 
 void Model::build()
 {
-    m_modelGeometry.addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
-        sizeof(float) * 0, QQuick3DGeometry::Attribute::F32Type);
-    m_modelGeometry.addAttribute(QQuick3DGeometry::Attribute::TexCoordSemantic,
-        sizeof(float) * 3, QQuick3DGeometry::Attribute::F32Type);
-    m_modelGeometry.addAttribute(QQuick3DGeometry::Attribute::NormalSemantic,
-        sizeof(float) * 5, QQuick3DGeometry::Attribute::F32Type);
-    m_modelGeometry.setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
-    m_modelGeometry.setStride(sizeof(float) * 8);
-    m_modelGeometry.update();
+    buildModelGeometry();
 
     m_normalGeometry.addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
         sizeof(float) * 0, QQuick3DGeometry::Attribute::F32Type);
@@ -153,232 +492,1636 @@ void Model::build()
     m_gridGeometry.setStride(sizeof(float) * 3);
     m_gridGeometry.update();
 
+    buildSideGeometry();
+
     emit boundingBoxChanged();
     emit geometryChanged();
+    emit sidesChanged();
 }
 
-bool Model::loadCompiledStaticMesh(const QUrl &filename)
+void Model::buildModelGeometry()
 {
-    release();
+    m_modelGeometry.clear();
 
-    /*
-        Load file
-    */
-    m_filename = filename.toLocalFile();
-    m_path = QFileInfo(m_filename).dir().path() + QDir::separator();
-    m_materialDirectories.append(m_path);
+    for (const CompiledStaticMesh::Geometry::Attribute &attribute : m_modelAttributes) {
+        QQuick3DGeometry::Attribute::Semantic semantic;
+        QQuick3DGeometry::Attribute::ComponentType componentType;
 
-    switch (CompiledStaticMesh::fileVersion(m_filename.toStdString())) {
-    case 2:
-        m_compiledStaticMesh = new CompiledStaticMesh::Version2;
-        break;
+        switch (attribute.semantic) {
+        case CompiledStaticMesh::Geometry::PositionSemantic:
+            semantic = QQuick3DGeometry::Attribute::PositionSemantic;
+            break;
 
-    case 3:
-        m_compiledStaticMesh = new CompiledStaticMesh::Version3;
-        break;
+        case CompiledStaticMesh::Geometry::NormalSemantic:
+            semantic = QQuick3DGeometry::Attribute::NormalSemantic;
+            break;
 
-    default:
-        return false;
-    }
+        case CompiledStaticMesh::Geometry::TextureCoordSemantic:
+            semantic = QQuick3DGeometry::Attribute::TexCoordSemantic;
+            break;
 
-    if (!m_compiledStaticMesh->open(filename.toLocalFile().toStdString(),
-        CompiledStaticMesh::Interface::Read)) {
-        return false;
-    }
+        case CompiledStaticMesh::Geometry::TangentSemantic:
+            semantic = QQuick3DGeometry::Attribute::TangentSemantic;
+            break;
 
-    if (m_compiledStaticMesh->vertexCount() == 0 ||
-        m_compiledStaticMesh->faceCount() == 0) {
-        return false;
-    }
+        case CompiledStaticMesh::Geometry::BinormalSemantic:
+            semantic = QQuick3DGeometry::Attribute::BinormalSemantic;
+            break;
 
-    /*
-        Read materials
-    */
-    std::vector<std::string> materialNames;
-    if (!m_compiledStaticMesh->readMaterials(&materialNames)) {
-        return false;
-    }
+        case CompiledStaticMesh::Geometry::LightmapCoordSemantic:
+            semantic = QQuick3DGeometry::Attribute::TexCoord1Semantic;
+            break;
 
-    for (const std::string &materialName : materialNames) {
-        QString name = QString(materialName.c_str()).trimmed();
-        if (name.startsWith('"')) {
-            name = name.mid(1);
+        case CompiledStaticMesh::Geometry::ColorSemantic:
+            semantic = QQuick3DGeometry::Attribute::ColorSemantic;
+            break;
+
+        default:
+            continue;
         }
 
-        if (name.endsWith('"')) {
-            name = name.mid(0, name.length() - 1);
+        switch (attribute.componentType) {
+        case CompiledStaticMesh::Geometry::U32Type:
+            componentType = QQuick3DGeometry::Attribute::U32Type;
+            break;
+
+        case CompiledStaticMesh::Geometry::U16Type:
+            componentType = QQuick3DGeometry::Attribute::U16Type;
+            break;
+
+        default:
+            componentType = QQuick3DGeometry::Attribute::F32Type;
+            break;
         }
 
-        m_materials.append(name);
+        m_modelGeometry.addAttribute(semantic, attribute.offset, componentType);
     }
 
-    /*
-        Allocate vertex data
-    */
-    uint32_t geometryVertexCount = m_compiledStaticMesh->faceCount() * 3;
+    m_modelGeometry.addAttribute(QQuick3DGeometry::Attribute::IndexSemantic,
+        0, QQuick3DGeometry::Attribute::U32Type);
+    m_modelGeometry.setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
+    m_modelGeometry.setStride(m_modelStride);
+    m_modelGeometry.setVertexData(m_modelVertices);
+    m_modelGeometry.setIndexData(m_modelIndices);
 
-    QByteArray modelGeometryData;
-    modelGeometryData.resize(geometryVertexCount * sizeof(Vertex));
-    Vertex *modelGeometryVertices = reinterpret_cast<Vertex *>(modelGeometryData.data());
+    for (const Subset &subset : m_subsets) {
+        m_modelGeometry.addSubset(subset.offset, subset.count, subset.boundsMin, subset.boundsMax);
+    }
 
-    QByteArray normalGeometryData;
-    normalGeometryData.resize(geometryVertexCount * 2 * sizeof(Vector3));
-    Vector3 *normalGeometryVertices = reinterpret_cast<Vector3 *>(normalGeometryData.data());
+    m_modelGeometry.update();
+}
 
-    QByteArray gridGeometryData;
-    gridGeometryData.resize(geometryVertexCount  * 3 * sizeof(Vector3));
-    Vector3 *gridGeometryVertices = reinterpret_cast<Vector3 *>(gridGeometryData.data());
+void Model::appendModelAttribute(CompiledStaticMesh::Geometry::Semantic semantic, uint32_t size,
+    CompiledStaticMesh::Geometry::ComponentType componentType)
+{
+    CompiledStaticMesh::Geometry::Attribute attribute;
+    attribute.semantic = semantic;
+    attribute.offset = m_modelStride;
+    attribute.componentType = componentType;
 
-    /*
-        Read faces
-    */
-    QVector<uint8_t> faces;
-    faces.resize(m_compiledStaticMesh->faceCount() * m_compiledStaticMesh->faceSize());
+    m_modelAttributes.append(attribute);
+    m_modelStride += size;
+}
 
-    if (!m_compiledStaticMesh->readFaces(faces.data())) {
-        return false;
+int Model::modelAttributeOffset(CompiledStaticMesh::Geometry::Semantic semantic) const
+{
+    for (const CompiledStaticMesh::Geometry::Attribute &attribute : m_modelAttributes) {
+        if (attribute.semantic == static_cast<uint32_t>(semantic)) {
+            return static_cast<int>(attribute.offset);
+        }
     }
 
-    /*
-        Read vertices
-    */
-    QVector<uint8_t> vertices;
-    vertices.resize(m_compiledStaticMesh->vertexCount() * m_compiledStaticMesh->vertexSize());
+    return -1;
+}
 
-    if (!m_compiledStaticMesh->readVertices(vertices.data())) {
-        return false;
-    }
+bool Model::loadCompiledStaticMesh(const QUrl &filename)
+{
+    return loadCompiledStaticMeshRegion(filename, QVector<float>());
+}
 
+bool Model::loadCompiledStaticMeshBox(const QUrl &filename, const QVector3D &boundsMin,
+    const QVector3D &boundsMax)
+{
+    QVector<float> regionPlanes = {
+        1.0f, 0.0f, 0.0f, -boundsMin.x(),
+        -1.0f, 0.0f, 0.0f, boundsMax.x(),
+        0.0f, 1.0f, 0.0f, -boundsMin.y(),
+        0.0f, -1.0f, 0.0f, boundsMax.y(),
+        0.0f, 0.0f, 1.0f, -boundsMin.z(),
+        0.0f, 0.0f, -1.0f, boundsMax.z()
+    };
+
+    return loadCompiledStaticMeshRegion(filename, regionPlanes);
+}
+
+bool Model::loadCompiledStaticMeshFrustum(const QUrl &filename, const QVector3D &position,
+    const QVector3D &forward, const QVector3D &up, float fieldOfView, float aspectRatio,
+    float clipNear, float clipFar)
+{
     /*
-            Parse faces
+        Planes face into the frustum, fieldOfView is vertical and in degrees
     */
-    uint32_t meshCount = static_cast<uint32_t>(m_materials.size());
-    if (meshCount < 1) {
-        meshCount = 1;
+    QVector3D direction = forward.normalized();
+    QVector3D right = QVector3D::crossProduct(direction, up).normalized();
+    QVector3D cameraUp = QVector3D::crossProduct(right, direction);
+    float tanVertical = qTan(qDegreesToRadians(fieldOfView) / 2.0f);
+    float tanHorizontal = tanVertical * aspectRatio;
+
+    QVector3D normals[6] = {
+        direction,
+        -direction,
+        right + direction * tanHorizontal,
+        -right + direction * tanHorizontal,
+        cameraUp + direction * tanVertical,
+        -cameraUp + direction * tanVertical
+    };
+
+    QVector3D points[6] = {
+        position + direction * clipNear,
+        position + direction * clipFar,
+        position,
+        position,
+        position,
+        position
+    };
+
+    QVector<float> regionPlanes;
+
+    for (int i = 0; i < 6; i++) {
+        regionPlanes.append(normals[i].x());
+        regionPlanes.append(normals[i].y());
+        regionPlanes.append(normals[i].z());
+        regionPlanes.append(-QVector3D::dotProduct(normals[i], points[i]));
     }
 
-    m_boundingBox.min = QVector3D(std::numeric_limits<float>::max(),
-        std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-    m_boundingBox.max = QVector3D(std::numeric_limits<float>::min(),
-        std::numeric_limits<float>::min(), std::numeric_limits<float>::min());
+    return loadCompiledStaticMeshRegion(filename, regionPlanes);
+}
 
-    uint32_t meshOffset = 0;
-    uint32_t meshSize;
+bool Model::loadCompiledStaticMeshRegion(const QUrl &filename, const QVector<float> &regionPlanes)
+{
+    release();
 
-    for (uint32_t i = 0; i < meshCount; i++) {
-        meshSize = 0;
+    /*
+        Load file, pack members are named by the url fragment
+    */
+    QString localFilename = filename.toLocalFile();
+    int32_t packEntry = -1;
+    uint32_t version;
 
-        for (uint32_t j = 0; j < m_compiledStaticMesh->faceCount(); j++) {
-            uint16_t materialIndex = m_compiledStaticMesh->faceMaterialIndex(faces.data(), j);
-            if (materialIndex != i) {
-                continue;
-            }
+    if (localFilename.endsWith(".csmp", Qt::CaseInsensitive)) {
+        if (!openPack(localFilename) || m_pack.entryCount() == 0) {
+            return false;
+        }
+
+        QString member = filename.fragment(QUrl::FullyDecoded);
+        packEntry = member.isEmpty() ? 0 : m_pack.findEntry(member.toStdString());
+
+        if (packEntry < 0) {
+            return false;
+        }
+
+        m_packMember = QString::fromStdString(m_pack.entryName(packEntry));
+        version = m_pack.entry(packEntry).version;
+    } else {
+        closePack();
+        version = CompiledStaticMesh::fileVersion(localFilename.toStdString());
+    }
+
+    /*
+        Members have no file of their own, so they are never found in the geometry cache
+    */
+    m_filename = packEntry < 0 ? localFilename : localFilename + "#" + m_packMember;
+    m_path = QFileInfo(localFilename).dir().path() + QDir::separator();
+    m_materialDirectories.append(m_path);
+
+    switch (version) {
+    case 2:
+        m_compiledStaticMesh = new CompiledStaticMesh::Version2;
+        break;
+
+    case 3:
+        m_compiledStaticMesh = new CompiledStaticMesh::Version3;
+        break;
+
+    case CompiledStaticMesh::Geometry::Version:
+        m_compiledStaticMesh = new CompiledStaticMesh::Geometry;
+        break;
+
+    case CompiledStaticMesh::Compressed::Version:
+        m_compiledStaticMesh = new CompiledStaticMesh::Compressed;
+        break;
+
+    case CompiledStaticMesh::Quantized::Version:
+        m_compiledStaticMesh = new CompiledStaticMesh::Quantized;
+        break;
+
+    case CompiledStaticMesh::Tiled::Version:
+        m_compiledStaticMesh = new CompiledStaticMesh::Tiled;
+        break;
+
+    default:
+        return false;
+    }
+
+    bool opened = packEntry >= 0 ? m_pack.openEntry(packEntry, m_compiledStaticMesh) :
+        m_compiledStaticMesh->open(localFilename.toStdString(), CompiledStaticMesh::Interface::Read);
+
+    if (!opened) {
+        return false;
+    }
+
+    /*
+        Restrict faces and vertices to the tiles inside the region, planes are
+        given in render space while tiles are bounded in file space where the
+        y and z axes are swapped
+    */
+    if (!regionPlanes.isEmpty()) {
+        QVector<float> filePlanes = regionPlanes;
+
+        for (int i = 0; i + 3 < filePlanes.count(); i += 4) {
+            std::swap(filePlanes[i + 1], filePlanes[i + 2]);
+        }
+
+        if (!m_compiledStaticMesh->selectRegion(filePlanes.data(),
+            static_cast<uint32_t>(filePlanes.count() / 4))) {
+            return false;
+        }
+
+        m_regionPlanes = regionPlanes;
+    }
+
+    if (m_compiledStaticMesh->vertexCount() == 0 ||
+        m_compiledStaticMesh->faceCount() == 0) {
+        return false;
+    }
+
+    /*
+        Read materials
+    */
+    if (!m_compiledStaticMesh->readMaterials(&m_materialNames)) {
+        return false;
+    }
+
+    for (const std::string &materialName : m_materialNames) {
+        QString name = QString(materialName.c_str()).trimmed();
+        if (name.startsWith('"')) {
+            name = name.mid(1);
+        }
+
+        if (name.endsWith('"')) {
+            name = name.mid(0, name.length() - 1);
+        }
+
+        m_materials.append(name);
+    }
+
+    if (m_compiledStaticMesh->version() == CompiledStaticMesh::Geometry::Version) {
+        return loadGeometry(static_cast<CompiledStaticMesh::Geometry *>(m_compiledStaticMesh));
+    }
+
+    /*
+        Load cached geometry
+    */
+    GeometryCache::Entry cacheEntry;
+    bool cacheable = m_geometryCacheLimit > 0 &&
+        GeometryCache::entry(m_filename, geometryCacheOptions(), &cacheEntry);
+
+    if (cacheable && loadCachedGeometry(cacheEntry)) {
+        return true;
+    }
+
+    appendModelAttribute(CompiledStaticMesh::Geometry::PositionSemantic, sizeof(Vector3));
+    appendModelAttribute(CompiledStaticMesh::Geometry::TextureCoordSemantic, sizeof(Vector2));
+    appendModelAttribute(CompiledStaticMesh::Geometry::NormalSemantic, sizeof(Vector3));
+    appendModelAttribute(CompiledStaticMesh::Geometry::LightmapCoordSemantic, sizeof(Vector2));
+
+    /*
+        Quick3D has no normalized 8-bit vertex input, so colors are unpacked to floats
+    */
+    appendModelAttribute(CompiledStaticMesh::Geometry::ColorSemantic, sizeof(Color));
+
+    if (!readSourceData()) {
+        return false;
+    }
+
+    /*
+        Recompute normals, unless the file asks to keep its own
+    */
+    CompiledStaticMesh::NormalGenerator normalGenerator;
+    m_normalsRecomputed = m_recomputeNormals &&
+        (m_compiledStaticMesh->flags() & CompiledStaticMesh::Version3::ModelKeepNormals) == 0;
+
+    if (m_normalsRecomputed) {
+        CompiledStaticMesh::Welder welder;
+        welder.setDistance(0.0f);
+        welder.setNormalAngle(180.0f);
+        normalGenerator.setCreaseAngle(m_creaseAngle);
+
+        if (!welder.weld(m_compiledStaticMesh, m_vertices.data()) ||
+            !normalGenerator.generate(m_compiledStaticMesh, m_faces.data(), m_vertices.data(), &welder)) {
+            return false;
+        }
+    }
+
+    /*
+        Bucket faces by material and lightmap group in a single pass
+    */
+    uint32_t materialCount = static_cast<uint32_t>(m_materials.size());
+    if (materialCount < 1) {
+        materialCount = 1;
+    }
+
+    uint32_t faceCount = m_compiledStaticMesh->faceCount();
+    uint32_t vertexCount = m_compiledStaticMesh->vertexCount();
+    std::vector<uint32_t> faceBuckets(faceCount);
+    std::vector<uint32_t> bucketSizes;
+    std::map<std::pair<uint32_t, int32_t>, uint32_t> buckets;
+    std::pair<uint32_t, int32_t> bucketKey;
+    uint32_t bucket = Model::NoBucket;
+
+    for (uint32_t i = 0; i < faceCount; i++) {
+        std::pair<uint32_t, int32_t> key(m_compiledStaticMesh->faceMaterialIndex(m_faces.data(), i),
+            m_compiledStaticMesh->faceLightmapGroup(m_faces.data(), i));
+
+        /*
+            Faces with broken indices are left to the quality analysis
+        */
+        if (key.first >= materialCount ||
+            m_compiledStaticMesh->faceVertexIndex(m_faces.data(), i, 0) >= vertexCount ||
+            m_compiledStaticMesh->faceVertexIndex(m_faces.data(), i, 1) >= vertexCount ||
+            m_compiledStaticMesh->faceVertexIndex(m_faces.data(), i, 2) >= vertexCount) {
+            faceBuckets[i] = Model::NoBucket;
+            continue;
+        }
+
+        if (bucket == Model::NoBucket || key != bucketKey) {
+            auto result = buckets.emplace(key, static_cast<uint32_t>(bucketSizes.size()));
+            if (result.second) {
+                bucketSizes.push_back(0);
+            }
+
+            bucketKey = key;
+            bucket = result.first->second;
+        }
+
+        faceBuckets[i] = bucket;
+        bucketSizes[bucket]++;
+    }
+
+    /*
+        Lay buckets out in material then lightmap group order, one subset each
+    */
+    std::vector<uint32_t> bucketOffsets(bucketSizes.size());
+    uint32_t faceOffset = 0;
+
+    for (const auto &entry : buckets) {
+        Subset subset;
+        subset.material = entry.first.first;
+        subset.lightmapGroup = entry.first.second;
+        subset.offset = faceOffset * 3;
+        subset.count = bucketSizes[entry.second] * 3;
+        subset.hasTangents = false;
+        subset.transparent = false;
+        m_subsets.append(subset);
+
+        bucketOffsets[entry.second] = faceOffset;
+        faceOffset += bucketSizes[entry.second];
+    }
+
+    std::vector<uint32_t> faceOrder(faceOffset);
+
+    for (uint32_t i = 0; i < faceCount; i++) {
+        if (faceBuckets[i] != Model::NoBucket) {
+            faceOrder[bucketOffsets[faceBuckets[i]]++] = i;
+        }
+    }
+
+    /*
+        Allocate vertex data for the bucketed faces only, skipped faces leave no gaps
+    */
+    uint32_t geometryVertexCount = faceOffset * 3;
+
+    m_modelVertices.resize(geometryVertexCount * sizeof(Vertex));
+    Vertex *modelGeometryVertices = reinterpret_cast<Vertex *>(m_modelVertices.data());
+
+    m_normalVertices.resize(geometryVertexCount * 2 * sizeof(Vector3));
+    Vector3 *normalGeometryVertices = reinterpret_cast<Vector3 *>(m_normalVertices.data());
+
+    m_gridVertices.resize(geometryVertexCount  * 3 * sizeof(Vector3));
+    Vector3 *gridGeometryVertices = reinterpret_cast<Vector3 *>(m_gridVertices.data());
+
+    /*
+            Parse faces
+    */
+    m_boundingBox.min = QVector3D(std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    m_boundingBox.max = QVector3D(std::numeric_limits<float>::min(),
+        std::numeric_limits<float>::min(), std::numeric_limits<float>::min());
+
+    for (uint32_t j : faceOrder) {
+        const Vertex *gridVertices = modelGeometryVertices;
+
+        for (uint32_t k = 0; k < 3; k++) {
+            /*
+                Model geometry
+            */
+            m_compiledStaticMesh->vertex(m_faces.data(), j, m_vertices.data(), k,
+                modelGeometryVertices->position.data, modelGeometryVertices->textureCoord.data,
+                modelGeometryVertices->normal.data);
+            m_compiledStaticMesh->faceLightmapCoord(m_faces.data(), j, k,
+                modelGeometryVertices->lightmapCoord.data);
+            uint8_t color[4];
+            m_compiledStaticMesh->vertexColor(m_faces.data(), j, m_vertices.data(), k, color);
+
+            for (uint32_t c = 0; c < 4; c++) {
+                modelGeometryVertices->color.data[c] = static_cast<float>(color[c]) / 255.0f;
+            }
+
+            if (m_normalsRecomputed) {
+                const float *normal = normalGenerator.normal(j, k);
+                modelGeometryVertices->normal.x = normal[0];
+                modelGeometryVertices->normal.y = normal[2];
+                modelGeometryVertices->normal.z = normal[1];
+            }
+
+            /*
+                Normal geometry
+            */
+            normalGeometryVertices->x = modelGeometryVertices->position.x;
+            normalGeometryVertices->y = modelGeometryVertices->position.y;
+            normalGeometryVertices->z = modelGeometryVertices->position.z;
+            normalGeometryVertices++;
+
+            normalGeometryVertices->x = modelGeometryVertices->position.x +
+                modelGeometryVertices->normal.x * Model::NormalGeometryOffset;
+            normalGeometryVertices->y = modelGeometryVertices->position.y +
+                modelGeometryVertices->normal.y * Model::NormalGeometryOffset;
+            normalGeometryVertices->z = modelGeometryVertices->position.z +
+                modelGeometryVertices->normal.z * Model::NormalGeometryOffset;
+            normalGeometryVertices++;
+
+            /*
+                Bounding box
+            */
+            if (m_boundingBox.min.x() > modelGeometryVertices->position.x) {
+                m_boundingBox.min.setX(modelGeometryVertices->position.x);
+            }
+
+            if (m_boundingBox.min.y() > modelGeometryVertices->position.y) {
+                m_boundingBox.min.setY(modelGeometryVertices->position.y);
+            }
+
+            if (m_boundingBox.min.z() > modelGeometryVertices->position.z) {
+                m_boundingBox.min.setZ(modelGeometryVertices->position.z);
+            }
+
+            if (m_boundingBox.max.x() < modelGeometryVertices->position.x) {
+                m_boundingBox.max.setX(modelGeometryVertices->position.x);
+            }
+
+            if (m_boundingBox.max.y() < modelGeometryVertices->position.y) {
+                m_boundingBox.max.setY(modelGeometryVertices->position.y);
+            }
+
+            if (m_boundingBox.max.z() < modelGeometryVertices->position.z) {
+                m_boundingBox.max.setZ(modelGeometryVertices->position.z);
+            }
+
+            modelGeometryVertices++;
+        }
+
+        /*
+            Grid geometry
+        */
+        for (uint32_t k = 0; k < 3; k++) {
+            const Vertex *gridVertex[2];
+
+            switch (k) {
+            case 0:
+                gridVertex[0] = &gridVertices[0];
+                gridVertex[1] = &gridVertices[1];
+                break;
+            case 1:
+                gridVertex[0] = &gridVertices[1];
+                gridVertex[1] = &gridVertices[2];
+                break;
+
+            case 2:
+                gridVertex[0] = &gridVertices[2];
+                gridVertex[1] = &gridVertices[0];
+                break;
+            }
+
+            gridGeometryVertices->x = gridVertex[0]->position.x +
+                gridVertex[0]->normal.x * Model::GridGeometryOffset;
+            gridGeometryVertices->y = gridVertex[0]->position.y +
+                gridVertex[0]->normal.y * Model::GridGeometryOffset;
+            gridGeometryVertices->z = gridVertex[0]->position.z +
+                gridVertex[0]->normal.z * Model::GridGeometryOffset;
+            gridGeometryVertices++;
+
+            gridGeometryVertices->x = gridVertex[1]->position.x +
+                gridVertex[1]->normal.x * Model::GridGeometryOffset;
+            gridGeometryVertices->y = gridVertex[1]->position.y +
+                gridVertex[1]->normal.y * Model::GridGeometryOffset;
+            gridGeometryVertices->z = gridVertex[1]->position.z +
+                gridVertex[1]->normal.z * Model::GridGeometryOffset;
+            gridGeometryVertices++;
+        }
+    }
+
+    for (Subset &subset : m_subsets) {
+        subset.boundsMin = m_boundingBox.min;
+        subset.boundsMax = m_boundingBox.max;
+    }
+
+    /*
+        Model indices start in file order and are only rewritten for transparent subsets
+    */
+    m_modelIndices.resize(geometryVertexCount * sizeof(uint32_t));
+    uint32_t *modelIndices = reinterpret_cast<uint32_t *>(m_modelIndices.data());
+
+    for (uint32_t i = 0; i < geometryVertexCount; i++) {
+        modelIndices[i] = i;
+    }
+
+    m_normalGeometry.setVertexData(m_normalVertices);
+    m_gridGeometry.setVertexData(m_gridVertices);
+    build();
+
+    if (cacheable) {
+        writeCachedGeometry(cacheEntry);
+    }
+
+    return true;
+}
+
+bool Model::openPack(const QString &filename)
+{
+    /*
+        The pack stays mapped while its members are browsed
+    */
+    if (m_pack.isOpen() && m_packFilename == filename) {
+        return true;
+    }
+
+    closePack();
+
+    if (!m_pack.open(filename.toStdString(), CompiledStaticMesh::Interface::Read)) {
+        return false;
+    }
+
+    m_packFilename = filename;
+
+    for (uint32_t i = 0; i < m_pack.entryCount(); i++) {
+        m_packMembers.append(QString::fromStdString(m_pack.entryName(i)));
+    }
+
+    return true;
+}
+
+void Model::closePack()
+{
+    m_pack.close();
+    m_packFilename.clear();
+    m_packMembers.clear();
+}
+
+bool Model::readSourceData()
+{
+    /*
+        Cached loads read the source faces and vertices on first use
+    */
+    if (!m_faces.isEmpty()) {
+        return true;
+    }
+
+    /*
+        Read faces
+    */
+    m_faces.resize(m_compiledStaticMesh->faceCount() * m_compiledStaticMesh->faceSize());
+
+    if (!m_compiledStaticMesh->readFaces(m_faces.data())) {
+        m_faces.clear();
+        return false;
+    }
+
+    /*
+        Read vertices
+    */
+    m_vertices.resize(m_compiledStaticMesh->vertexCount() * m_compiledStaticMesh->vertexSize());
+
+    if (!m_compiledStaticMesh->readVertices(m_vertices.data())) {
+        m_faces.clear();
+        return false;
+    }
+
+    /*
+        Weld vertices
+    */
+    if (m_weldVertices) {
+        CompiledStaticMesh::Welder welder;
+        welder.setDistance(m_weldDistance);
+        welder.setNormalAngle(m_weldNormalAngle);
+
+        if (!welder.weld(m_compiledStaticMesh, m_vertices.data()) ||
+            !welder.apply(m_compiledStaticMesh, m_faces.data(), m_vertices.data())) {
+            m_faces.clear();
+            return false;
+        }
+
+        m_vertices.resize(m_compiledStaticMesh->vertexCount() * m_compiledStaticMesh->vertexSize());
+    }
+
+    return true;
+}
+
+QString Model::geometryCacheOptions() const
+{
+    QString options = "weld=";
+
+    if (m_weldVertices) {
+        options += QString::number(m_weldDistance) + "," + QString::number(m_weldNormalAngle);
+    }
+
+    options += ";normals=";
+
+    if (m_recomputeNormals) {
+        options += QString::number(m_creaseAngle);
+    }
+
+    options += ";region=";
+
+    for (int i = 0; i < m_regionPlanes.count(); i++) {
+        if (i > 0) {
+            options += ",";
+        }
+
+        options += QString::number(m_regionPlanes[i]);
+    }
+
+    return options;
+}
+
+bool Model::loadCachedGeometry(const GeometryCache::Entry &cacheEntry)
+{
+    if (!QFile::exists(cacheEntry.filename)) {
+        return false;
+    }
+
+    GeometryCache::touch(cacheEntry);
+
+    m_cachedGeometry = new CompiledStaticMesh::Geometry;
+
+    if (!m_cachedGeometry->open(cacheEntry.filename.toStdString(), CompiledStaticMesh::Interface::Read) ||
+        !GeometryCache::valid(m_cachedGeometry, cacheEntry) ||
+        m_cachedGeometry->sourceVersion() != m_compiledStaticMesh->version()) {
+        delete m_cachedGeometry;
+        m_cachedGeometry = nullptr;
+        return false;
+    }
+
+    m_geometryCached = true;
+
+    if (!loadGeometry(m_cachedGeometry)) {
+        m_geometryCached = false;
+        delete m_cachedGeometry;
+        m_cachedGeometry = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool Model::writeCachedGeometry(const GeometryCache::Entry &cacheEntry) const
+{
+    QString temporaryFilename = cacheEntry.filename + ".tmp";
+
+    CompiledStaticMesh::Geometry geometry;
+    geometry.setSourceStamp(cacheEntry.sourceStamp);
+
+    if (!writeGeometry(&geometry, temporaryFilename)) {
+        geometry.close();
+        QFile::remove(temporaryFilename);
+        return false;
+    }
+
+    if (!GeometryCache::commit(temporaryFilename, cacheEntry)) {
+        return false;
+    }
+
+    GeometryCache::trim(m_geometryCacheLimit, cacheEntry);
+
+    return true;
+}
+
+bool Model::loadGeometry(const CompiledStaticMesh::Geometry *geometry)
+{
+    /*
+        Sections are handed to the scene as-is, backed by the mapped file
+    */
+    const CompiledStaticMesh::Geometry::Subset *subsets = geometry->subsets();
+    bool hasPosition = false;
+
+    m_normalsRecomputed = (geometry->buildFlags() & CompiledStaticMesh::Geometry::BuildNormalsRecomputed) != 0;
+
+    for (uint32_t i = 0; i < geometry->attributeCount(); i++) {
+        if (geometry->attribute(i).semantic == CompiledStaticMesh::Geometry::PositionSemantic) {
+            hasPosition = true;
+        }
+    }
+
+    if (!hasPosition) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < geometry->subsetCount(); i++) {
+        if (static_cast<uint64_t>(subsets[i].offset) + subsets[i].count > geometry->indexCount()) {
+            return false;
+        }
+    }
+
+    /*
+        Vertices are laid out per face corner, sorting and coverage address them by
+        subset offset while the indices only reorder faces within those vertices
+    */
+    if (geometry->vertexCount() != geometry->indexCount()) {
+        return false;
+    }
+
+    const uint32_t *indices = geometry->indexData();
+
+    for (uint32_t i = 0; i < geometry->indexCount(); i++) {
+        if (indices[i] >= geometry->vertexCount()) {
+            return false;
+        }
+    }
+
+    Vector3 boundsMin;
+    Vector3 boundsMax;
+    geometry->boundingBox(boundsMin.data, boundsMax.data);
+    m_boundingBox.min = QVector3D(boundsMin.x, boundsMin.y, boundsMin.z);
+    m_boundingBox.max = QVector3D(boundsMax.x, boundsMax.y, boundsMax.z);
+
+    for (uint32_t i = 0; i < geometry->attributeCount(); i++) {
+        m_modelAttributes.append(geometry->attribute(i));
+    }
+
+    m_modelStride = geometry->stride();
+    m_modelVertices = QByteArray::fromRawData(reinterpret_cast<const char *>(geometry->vertexData()),
+        static_cast<qsizetype>(geometry->vertexCount()) * m_modelStride);
+    m_modelIndices = QByteArray::fromRawData(reinterpret_cast<const char *>(geometry->indexData()),
+        static_cast<qsizetype>(geometry->indexCount()) * sizeof(uint32_t));
+    m_normalVertices = QByteArray::fromRawData(reinterpret_cast<const char *>(geometry->normalData()),
+        static_cast<qsizetype>(geometry->normalVertexCount()) * sizeof(Vector3));
+    m_gridVertices = QByteArray::fromRawData(reinterpret_cast<const char *>(geometry->gridData()),
+        static_cast<qsizetype>(geometry->gridVertexCount()) * sizeof(Vector3));
+
+    for (uint32_t i = 0; i < geometry->subsetCount(); i++) {
+        Subset subset;
+        subset.material = subsets[i].material;
+        subset.lightmapGroup = subsets[i].lightmapGroup;
+        subset.offset = subsets[i].offset;
+        subset.count = subsets[i].count;
+        subset.boundsMin = QVector3D(subsets[i].boundsMin.x, subsets[i].boundsMin.y, subsets[i].boundsMin.z);
+        subset.boundsMax = QVector3D(subsets[i].boundsMax.x, subsets[i].boundsMax.y, subsets[i].boundsMax.z);
+        subset.hasTangents = (subsets[i].flags & CompiledStaticMesh::Geometry::SubsetHasTangents) != 0;
+        subset.transparent = false;
+        m_subsets.append(subset);
+    }
+
+    m_normalGeometry.setVertexData(m_normalVertices);
+    m_gridGeometry.setVertexData(m_gridVertices);
+    build();
+
+    return true;
+}
+
+bool Model::saveCompiledStaticMesh(const QUrl &filename)
+{
+    if (!hasSourceData() || !readSourceData()) {
+        return false;
+    }
+
+    uint32_t version = m_compiledStaticMesh->version();
+
+    if (version == CompiledStaticMesh::Compressed::Version) {
+        version = static_cast<CompiledStaticMesh::Compressed *>(m_compiledStaticMesh)->sourceVersion();
+    }
+
+    if (version == CompiledStaticMesh::Quantized::Version) {
+        version = CompiledStaticMesh::Version3::Version;
+    }
+
+    if (version == CompiledStaticMesh::Tiled::Version) {
+        version = static_cast<CompiledStaticMesh::Tiled *>(m_compiledStaticMesh)->sourceVersion();
+    }
+
+    if (filename.toLocalFile().endsWith(".csmz", Qt::CaseInsensitive)) {
+        version = CompiledStaticMesh::Compressed::Version;
+    }
+
+    /*
+        Quantized files only archive Version3 data
+    */
+    if (filename.toLocalFile().endsWith(".csmq", Qt::CaseInsensitive)) {
+        if (version != CompiledStaticMesh::Version3::Version) {
+            return false;
+        }
+
+        version = CompiledStaticMesh::Quantized::Version;
+    }
+
+    if (filename.toLocalFile().endsWith(".csmt", Qt::CaseInsensitive)) {
+        version = CompiledStaticMesh::Tiled::Version;
+    }
+
+    CompiledStaticMesh::Interface *compiledStaticMesh;
+
+    switch (version) {
+    case 2:
+        compiledStaticMesh = new CompiledStaticMesh::Version2;
+        break;
+
+    case 3:
+        compiledStaticMesh = new CompiledStaticMesh::Version3;
+        break;
+
+    case CompiledStaticMesh::Compressed::Version:
+        compiledStaticMesh = new CompiledStaticMesh::Compressed;
+        break;
+
+    case CompiledStaticMesh::Quantized::Version:
+        compiledStaticMesh = new CompiledStaticMesh::Quantized;
+        break;
+
+    case CompiledStaticMesh::Tiled::Version:
+        compiledStaticMesh = new CompiledStaticMesh::Tiled;
+        break;
+
+    default:
+        return false;
+    }
+
+    bool result = writeCompiledStaticMesh(compiledStaticMesh, filename.toLocalFile());
+    delete compiledStaticMesh;
+
+    return result;
+}
+
+bool Model::writeCompiledStaticMesh(CompiledStaticMesh::Interface *compiledStaticMesh,
+    const QString &filename) const
+{
+    if (!compiledStaticMesh->open(filename.toStdString(), CompiledStaticMesh::Interface::Write)) {
+        return false;
+    }
+
+    compiledStaticMesh->setHeader(m_compiledStaticMesh->header());
+
+    if (!compiledStaticMesh->writeHeader()) {
+        return false;
+    }
+
+    /*
+        Write materials
+    */
+    if (!compiledStaticMesh->beginWriteMaterials()) {
+        return false;
+    }
+
+    for (const std::string &materialName : m_materialNames) {
+        if (!compiledStaticMesh->writeMaterial(materialName + " ")) {
+            return false;
+        }
+    }
+
+    if (!compiledStaticMesh->endWriteMaterials()) {
+        return false;
+    }
+
+    /*
+        Write faces
+    */
+    if (!compiledStaticMesh->beginWriteFaces()) {
+        return false;
+    }
+
+    uint8_t *faces = const_cast<uint8_t *>(m_faces.data());
+
+    for (uint32_t i = 0; i < m_compiledStaticMesh->faceCount(); i++) {
+        if (!compiledStaticMesh->writeFace(faces + i * m_compiledStaticMesh->faceSize())) {
+            return false;
+        }
+    }
+
+    if (!compiledStaticMesh->endWriteFaces()) {
+        return false;
+    }
+
+    /*
+        Write vertices
+    */
+    if (!compiledStaticMesh->beginWriteVertices()) {
+        return false;
+    }
+
+    uint8_t *vertices = const_cast<uint8_t *>(m_vertices.data());
+
+    for (uint32_t i = 0; i < m_compiledStaticMesh->vertexCount(); i++) {
+        if (!compiledStaticMesh->writeVertex(vertices + i * m_compiledStaticMesh->vertexSize())) {
+            return false;
+        }
+    }
+
+    if (!compiledStaticMesh->endWriteVertices()) {
+        return false;
+    }
+
+    if (!compiledStaticMesh->writeHeader()) {
+        return false;
+    }
+
+    compiledStaticMesh->close();
+
+    return true;
+}
+
+bool Model::saveGeometry(const QUrl &filename)
+{
+    if (m_compiledStaticMesh == nullptr) {
+        return false;
+    }
+
+    CompiledStaticMesh::Geometry geometry;
+    return writeGeometry(&geometry, filename.toLocalFile());
+}
+
+bool Model::savePack(const QUrl &filename, const QList<QUrl> &members) const
+{
+    QString localFilename = filename.toLocalFile();
+    CompiledStaticMesh::Pack pack;
+
+    if (!pack.open(localFilename.toStdString(), CompiledStaticMesh::Interface::Write)) {
+        return false;
+    }
+
+    /*
+        Members are stored as they are on disk and named after their files,
+        only formats a member can be opened as are accepted
+    */
+    bool result = true;
+
+    for (const QUrl &member : members) {
+        QString memberFilename = member.toLocalFile();
+
+        switch (CompiledStaticMesh::fileVersion(memberFilename.toStdString())) {
+        case 2:
+        case 3:
+        case CompiledStaticMesh::Geometry::Version:
+        case CompiledStaticMesh::Compressed::Version:
+        case CompiledStaticMesh::Quantized::Version:
+        case CompiledStaticMesh::Tiled::Version:
+            break;
+
+        default:
+            result = false;
+            break;
+        }
+
+        if (!result) {
+            break;
+        }
+
+        QFile file(memberFilename);
+
+        if (!file.open(QIODevice::ReadOnly)) {
+            result = false;
+            break;
+        }
+
+        QByteArray data = file.readAll();
 
-            const Vertex *gridVertices = modelGeometryVertices;
+        if (static_cast<quint64>(data.size()) > std::numeric_limits<uint32_t>::max() ||
+            !pack.writeEntry(QFileInfo(memberFilename).fileName().toStdString(), data.constData(),
+            static_cast<uint32_t>(data.size()))) {
+            result = false;
+            break;
+        }
+    }
+
+    if (!pack.close() || !result) {
+        QFile::remove(localFilename);
+        return false;
+    }
+
+    return true;
+}
+
+bool Model::writeGeometry(CompiledStaticMesh::Geometry *geometry, const QString &filename) const
+{
+    if (!geometry->open(filename.toStdString(), CompiledStaticMesh::Interface::Write)) {
+        return false;
+    }
+
+    geometry->setFlags(m_compiledStaticMesh->flags());
+
+    if (hasSourceData()) {
+        uint32_t buildFlags = CompiledStaticMesh::Geometry::BuildFlagsNone;
+
+        if (m_weldVertices) {
+            buildFlags |= CompiledStaticMesh::Geometry::BuildWelded;
+        }
+
+        if (m_normalsRecomputed) {
+            buildFlags |= CompiledStaticMesh::Geometry::BuildNormalsRecomputed;
+        }
+
+        geometry->setSourceVersion(m_compiledStaticMesh->version());
+        geometry->setBuildFlags(buildFlags);
+    } else {
+        const CompiledStaticMesh::Geometry *source =
+            static_cast<const CompiledStaticMesh::Geometry *>(m_compiledStaticMesh);
+
+        geometry->setSourceVersion(source->sourceVersion());
+        geometry->setBuildFlags(source->buildFlags());
+    }
+
+    Vector3 boundsMin = {{{m_boundingBox.min.x(), m_boundingBox.min.y(), m_boundingBox.min.z()}}};
+    Vector3 boundsMax = {{{m_boundingBox.max.x(), m_boundingBox.max.y(), m_boundingBox.max.z()}}};
+    geometry->setBoundingBox(boundsMin.data, boundsMax.data);
+
+    if (!geometry->setAttributes(m_modelAttributes.constData(), m_modelAttributes.size(), m_modelStride)) {
+        return false;
+    }
+
+    if (!geometry->writeHeader()) {
+        return false;
+    }
+
+    /*
+        Write materials
+    */
+    if (!geometry->beginWriteMaterials()) {
+        return false;
+    }
+
+    for (const std::string &materialName : m_materialNames) {
+        if (!geometry->writeMaterial(materialName + " ")) {
+            return false;
+        }
+    }
+
+    if (!geometry->endWriteMaterials()) {
+        return false;
+    }
+
+    /*
+        Write subsets
+    */
+    std::vector<CompiledStaticMesh::Geometry::Subset> subsets;
+    subsets.reserve(m_subsets.size());
+
+    for (const Subset &subset : m_subsets) {
+        CompiledStaticMesh::Geometry::Subset geometrySubset;
+        geometrySubset.material = subset.material;
+        geometrySubset.lightmapGroup = subset.lightmapGroup;
+        geometrySubset.flags = CompiledStaticMesh::Geometry::SubsetFlagsNone;
+        geometrySubset.offset = subset.offset;
+        geometrySubset.count = subset.count;
+        geometrySubset.boundsMin = {subset.boundsMin.x(), subset.boundsMin.y(), subset.boundsMin.z()};
+        geometrySubset.boundsMax = {subset.boundsMax.x(), subset.boundsMax.y(), subset.boundsMax.z()};
+
+        if (subset.hasTangents) {
+            geometrySubset.flags |= CompiledStaticMesh::Geometry::SubsetHasTangents;
+        }
+
+        subsets.push_back(geometrySubset);
+    }
+
+    if (!geometry->writeSubsets(subsets.data(), static_cast<uint32_t>(subsets.size()))) {
+        return false;
+    }
+
+    /*
+        Write buffers
+    */
+    if (!geometry->writeVertexData(m_modelVertices.constData(),
+        static_cast<uint32_t>(m_modelVertices.size() / m_modelStride))) {
+        return false;
+    }
+
+    if (!geometry->writeIndexData(reinterpret_cast<const uint32_t *>(m_modelIndices.constData()),
+        static_cast<uint32_t>(m_modelIndices.size() / sizeof(uint32_t)))) {
+        return false;
+    }
+
+    if (!geometry->writeNormalData(m_normalVertices.constData(),
+        static_cast<uint32_t>(m_normalVertices.size() / sizeof(Vector3)))) {
+        return false;
+    }
+
+    if (!geometry->writeGridData(m_gridVertices.constData(),
+        static_cast<uint32_t>(m_gridVertices.size() / sizeof(Vector3)))) {
+        return false;
+    }
+
+    if (!geometry->writeHeader()) {
+        return false;
+    }
+
+    geometry->close();
+
+    return true;
+}
+
+bool Model::analyzeQuality()
+{
+    if (!hasSourceData() || !readSourceData()) {
+        return false;
+    }
+
+    if (!m_analyzer.analyze(m_compiledStaticMesh, m_faces.data(), m_vertices.data())) {
+        return false;
+    }
+
+    m_qualityAnalyzed = true;
+    buildQualityGeometry();
+
+    emit qualityChanged();
+
+    return true;
+}
+
+QList<uint32_t> Model::qualityIndices(int qualityIssue) const
+{
+    if (qualityIssue <= NoQualityIssue ||
+        qualityIssue >= CompiledStaticMesh::Analyzer::IssueCount) {
+        return QList<uint32_t>();
+    }
+
+    const std::vector<uint32_t> &indices = m_analyzer.indices(
+        static_cast<CompiledStaticMesh::Analyzer::Issue>(qualityIssue));
+
+    return QList<uint32_t>(indices.begin(), indices.end());
+}
+
+void Model::buildQualityGeometry()
+{
+    m_qualityGeometry.clear();
+
+    if (m_compiledStaticMesh == nullptr || !m_qualityAnalyzed || m_qualityIssue == NoQualityIssue) {
+        m_qualityGeometry.update();
+        return;
+    }
+
+    const std::vector<uint32_t> &indices = m_analyzer.indices(
+        static_cast<CompiledStaticMesh::Analyzer::Issue>(m_qualityIssue));
+
+    QByteArray qualityGeometryData;
+    Vector3 *qualityGeometryVertices;
+
+    if (m_qualityIssue == UnreferencedVertices) {
+        qualityGeometryData.resize(indices.size() * sizeof(Vector3));
+        qualityGeometryVertices = reinterpret_cast<Vector3 *>(qualityGeometryData.data());
+
+        for (uint32_t index : indices) {
+            float position[3];
+            m_compiledStaticMesh->vertexPosition(m_vertices.data(), index, position);
+
+            qualityGeometryVertices->x = position[0];
+            qualityGeometryVertices->y = position[2];
+            qualityGeometryVertices->z = position[1];
+            qualityGeometryVertices++;
+        }
+
+        m_qualityGeometry.setPrimitiveType(QQuick3DGeometry::PrimitiveType::Points);
+    } else {
+        qualityGeometryData.resize(indices.size() * 3 * sizeof(Vector3));
+        qualityGeometryVertices = reinterpret_cast<Vector3 *>(qualityGeometryData.data());
+
+        uint32_t vertexCount = m_compiledStaticMesh->vertexCount();
+        uint32_t faceCount = 0;
+
+        for (uint32_t index : indices) {
+            bool isValid = true;
 
             for (uint32_t k = 0; k < 3; k++) {
-                /*
-                    Model geometry
-                */
-                m_compiledStaticMesh->vertex(faces.data(), j, vertices.data(), k,
-                    modelGeometryVertices->position.data, modelGeometryVertices->textureCoord.data,
-                    modelGeometryVertices->normal.data);
-
-                /*
-                    Normal geometry
-                */
-                normalGeometryVertices->x = modelGeometryVertices->position.x;
-                normalGeometryVertices->y = modelGeometryVertices->position.y;
-                normalGeometryVertices->z = modelGeometryVertices->position.z;
-                normalGeometryVertices++;
-
-                normalGeometryVertices->x = modelGeometryVertices->position.x +
-                    modelGeometryVertices->normal.x * Model::NormalGeometryOffset;
-                normalGeometryVertices->y = modelGeometryVertices->position.y +
-                    modelGeometryVertices->normal.y * Model::NormalGeometryOffset;
-                normalGeometryVertices->z = modelGeometryVertices->position.z +
-                    modelGeometryVertices->normal.z * Model::NormalGeometryOffset;
-                normalGeometryVertices++;
-
-                /*
-                    Bounding box
-                */
-                if (m_boundingBox.min.x() > modelGeometryVertices->position.x) {
-                    m_boundingBox.min.setX(modelGeometryVertices->position.x);
+                if (m_compiledStaticMesh->faceVertexIndex(m_faces.data(), index, k) >= vertexCount) {
+                    isValid = false;
                 }
+            }
 
-                if (m_boundingBox.min.y() > modelGeometryVertices->position.y) {
-                    m_boundingBox.min.setY(modelGeometryVertices->position.y);
-                }
+            /*
+                Faces with broken indices have nothing to show
+            */
+            if (!isValid) {
+                continue;
+            }
 
-                if (m_boundingBox.min.z() > modelGeometryVertices->position.z) {
-                    m_boundingBox.min.setZ(modelGeometryVertices->position.z);
-                }
+            faceCount++;
 
-                if (m_boundingBox.max.x() < modelGeometryVertices->position.x) {
-                    m_boundingBox.max.setX(modelGeometryVertices->position.x);
-                }
+            for (uint32_t k = 0; k < 3; k++) {
+                Vertex vertex;
+                m_compiledStaticMesh->vertex(m_faces.data(), index, m_vertices.data(), k,
+                    vertex.position.data, vertex.textureCoord.data, vertex.normal.data);
+
+                qualityGeometryVertices->x = vertex.position.x +
+                    vertex.normal.x * Model::QualityGeometryOffset;
+                qualityGeometryVertices->y = vertex.position.y +
+                    vertex.normal.y * Model::QualityGeometryOffset;
+                qualityGeometryVertices->z = vertex.position.z +
+                    vertex.normal.z * Model::QualityGeometryOffset;
+                qualityGeometryVertices++;
+            }
+        }
 
-                if (m_boundingBox.max.y() < modelGeometryVertices->position.y) {
-                    m_boundingBox.max.setY(modelGeometryVertices->position.y);
-                }
+        qualityGeometryData.resize(faceCount * 3 * sizeof(Vector3));
+        m_qualityGeometry.setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
+    }
 
-                if (m_boundingBox.max.z() < modelGeometryVertices->position.z) {
-                    m_boundingBox.max.setZ(modelGeometryVertices->position.z);
-                }
+    m_qualityGeometry.addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
+        sizeof(float) * 0, QQuick3DGeometry::Attribute::F32Type);
+    m_qualityGeometry.setStride(sizeof(float) * 3);
+    m_qualityGeometry.setVertexData(qualityGeometryData);
+    m_qualityGeometry.setBounds(m_boundingBox.min, m_boundingBox.max);
+    m_qualityGeometry.update();
+}
+
+CompiledStaticMesh::Version3 *Model::sideSource() const
+{
+    if (m_compiledStaticMesh == nullptr ||
+        m_compiledStaticMesh->version() != CompiledStaticMesh::Version3::Version) {
+        return nullptr;
+    }
+
+    CompiledStaticMesh::Version3 *compiledStaticMesh =
+        static_cast<CompiledStaticMesh::Version3 *>(m_compiledStaticMesh);
+
+    if (!compiledStaticMesh->hasSides()) {
+        return nullptr;
+    }
+
+    return compiledStaticMesh;
+}
+
+void Model::buildSideGeometry()
+{
+    m_sideGeometry.clear();
+    m_sideVertices.clear();
+
+    CompiledStaticMesh::Version3 *compiledStaticMesh = sideSource();
+
+    /*
+        Nothing is mapped or read until the overlay is turned on
+    */
+    if (!m_sidesVisible || compiledStaticMesh == nullptr || !compiledStaticMesh->mapSides()) {
+        m_sideGeometry.update();
+        return;
+    }
+
+    uint32_t sideCount = compiledStaticMesh->sideCount();
+    uint32_t pointCount = compiledStaticMesh->pointCount();
+    std::vector<uint32_t> sideOffsets(sideCount + 1);
+
+    /*
+        Each side outline is a closed loop, one line per point
+    */
+    for (uint32_t i = 0; i < sideCount; i++) {
+        const CompiledStaticMesh::Version3::Side *side = compiledStaticMesh->side(i);
+        uint32_t count = 0;
+
+        if (side->pointCount >= 2 && side->firstPoint <= pointCount &&
+            side->pointCount <= pointCount - side->firstPoint) {
+            count = side->pointCount;
+        }
+
+        sideOffsets[i + 1] = sideOffsets[i] + count;
+    }
+
+    m_sideVertices.resize(static_cast<qsizetype>(sideOffsets[sideCount]) * 2 * sizeof(Vector3));
+    Vector3 *sideVertices = reinterpret_cast<Vector3 *>(m_sideVertices.data());
 
-                modelGeometryVertices++;
-                meshSize++;
+    CompiledStaticMesh::Parallel::forEach(sideCount, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t count = sideOffsets[i + 1] - sideOffsets[i];
+            if (count == 0) {
+                continue;
             }
 
+            const CompiledStaticMesh::Version3::Side *side = compiledStaticMesh->side(i);
+            Vector3 *vertices = sideVertices + static_cast<size_t>(sideOffsets[i]) * 2;
+            QVector3D normal;
+
             /*
-                Grid geometry
+                Lift the outline off its faces along the Newell normal of the polygon
             */
-            for (uint32_t k = 0; k < 3; k++) {
-                const Vertex *gridVertex[2];
-
-                switch (k) {
-                case 0:
-                    gridVertex[0] = &gridVertices[0];
-                    gridVertex[1] = &gridVertices[1];
-                    break;
-                case 1:
-                    gridVertex[0] = &gridVertices[1];
-                    gridVertex[1] = &gridVertices[2];
-                    break;
-
-                case 2:
-                    gridVertex[0] = &gridVertices[2];
-                    gridVertex[1] = &gridVertices[0];
-                    break;
+            for (uint32_t j = 0; j < count; j++) {
+                const CompiledStaticMesh::Version3::Vector3 &current =
+                    compiledStaticMesh->point(side->firstPoint + j)->position;
+                const CompiledStaticMesh::Version3::Vector3 &next =
+                    compiledStaticMesh->point(side->firstPoint + (j + 1) % count)->position;
+
+                normal += QVector3D((current.z - next.z) * (current.y + next.y),
+                    (current.x - next.x) * (current.z + next.z),
+                    (current.y - next.y) * (current.x + next.x));
+            }
+
+            normal = normal.normalized() * Model::SideGeometryOffset;
+
+            for (uint32_t j = 0; j < count; j++) {
+                for (uint32_t k = 0; k < 2; k++) {
+                    const CompiledStaticMesh::Version3::Vector3 &position =
+                        compiledStaticMesh->point(side->firstPoint + (j + k) % count)->position;
+
+                    vertices->x = position.x + normal.x();
+                    vertices->y = position.z + normal.z();
+                    vertices->z = position.y + normal.y();
+                    vertices++;
                 }
+            }
+        }
+    });
+
+    m_sideGeometry.addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
+        sizeof(float) * 0, QQuick3DGeometry::Attribute::F32Type);
+    m_sideGeometry.setPrimitiveType(QQuick3DGeometry::PrimitiveType::Lines);
+    m_sideGeometry.setStride(sizeof(float) * 3);
+    m_sideGeometry.setVertexData(m_sideVertices);
+    m_sideGeometry.setBounds(m_boundingBox.min, m_boundingBox.max);
+    m_sideGeometry.update();
+}
+
+int Model::faceSide(int faceIndex)
+{
+    CompiledStaticMesh::Version3 *compiledStaticMesh = sideSource();
+
+    if (compiledStaticMesh == nullptr || faceIndex < 0 ||
+        static_cast<uint32_t>(faceIndex) >= compiledStaticMesh->faceCount()) {
+        return -1;
+    }
+
+    /*
+        Invert the side face ranges on first lookup. Side ranges may overlap, so
+        they are walked in order on one thread and the last side covering a face wins
+    */
+    if (m_faceSides.isEmpty()) {
+        if (!compiledStaticMesh->mapSides()) {
+            return -1;
+        }
 
-                gridGeometryVertices->x = gridVertex[0]->position.x +
-                    gridVertex[0]->normal.x * Model::GridGeometryOffset;
-                gridGeometryVertices->y = gridVertex[0]->position.y +
-                    gridVertex[0]->normal.y * Model::GridGeometryOffset;
-                gridGeometryVertices->z = gridVertex[0]->position.z +
-                    gridVertex[0]->normal.z * Model::GridGeometryOffset;
-                gridGeometryVertices++;
-
-                gridGeometryVertices->x = gridVertex[1]->position.x +
-                    gridVertex[1]->normal.x * Model::GridGeometryOffset;
-                gridGeometryVertices->y = gridVertex[1]->position.y +
-                    gridVertex[1]->normal.y * Model::GridGeometryOffset;
-                gridGeometryVertices->z = gridVertex[1]->position.z +
-                    gridVertex[1]->normal.z * Model::GridGeometryOffset;
-                gridGeometryVertices++;
+        uint32_t faceCount = compiledStaticMesh->faceCount();
+        uint32_t sideCount = compiledStaticMesh->sideCount();
+        m_faceSides.fill(-1, faceCount);
+        int32_t *faceSides = m_faceSides.data();
+
+        for (uint32_t i = 0; i < sideCount; i++) {
+            const CompiledStaticMesh::Version3::Side *side = compiledStaticMesh->side(i);
+
+            if (side->firstFace > faceCount || side->faceCount > faceCount - side->firstFace) {
+                continue;
             }
+
+            std::fill(faceSides + side->firstFace, faceSides + side->firstFace + side->faceCount,
+                static_cast<int32_t>(i));
+        }
+    }
+
+    return m_faceSides[faceIndex];
+}
+
+bool Model::generateTangents(const QList<int> &materialIndices)
+{
+    std::vector<CompiledStaticMesh::TangentGenerator::Range> ranges;
+
+    for (Subset &subset : m_subsets) {
+        if (subset.hasTangents || !materialIndices.contains(static_cast<int>(subset.material))) {
+            continue;
         }
 
-        m_modelGeometry.addSubset(meshOffset, meshSize, m_boundingBox.min, m_boundingBox.max);
-        meshOffset += meshSize;
+        CompiledStaticMesh::TangentGenerator::Range range;
+        range.offset = subset.offset;
+        range.count = subset.count;
+        ranges.push_back(range);
+        subset.hasTangents = true;
     }
 
-    m_modelGeometry.setVertexData(modelGeometryData);
-    m_normalGeometry.setVertexData(normalGeometryData);
-    m_gridGeometry.setVertexData(gridGeometryData);
-    build();
+    if (ranges.empty()) {
+        return true;
+    }
+
+    uint32_t vertexCount = static_cast<uint32_t>(m_modelVertices.size() / m_modelStride);
+
+    /*
+        Widen the interleaved layout once, the first time any subset needs tangents
+    */
+    if (modelAttributeOffset(CompiledStaticMesh::Geometry::TangentSemantic) < 0) {
+        uint32_t stride = m_modelStride;
+        appendModelAttribute(CompiledStaticMesh::Geometry::TangentSemantic, sizeof(Vector3));
+        appendModelAttribute(CompiledStaticMesh::Geometry::BinormalSemantic, sizeof(Vector3));
+
+        QByteArray modelVertices(static_cast<qsizetype>(vertexCount) * m_modelStride, 0);
+        const uint8_t *source = reinterpret_cast<const uint8_t *>(m_modelVertices.constData());
+        uint8_t *target = reinterpret_cast<uint8_t *>(modelVertices.data());
+
+        CompiledStaticMesh::Parallel::forEach(vertexCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+            Q_UNUSED(thread)
+
+            for (uint32_t i = begin; i < end; i++) {
+                std::memcpy(target + static_cast<size_t>(i) * m_modelStride,
+                    source + static_cast<size_t>(i) * stride, stride);
+            }
+        });
+
+        m_modelVertices = modelVertices;
+    }
+
+    CompiledStaticMesh::TangentGenerator::Layout layout;
+    layout.stride = m_modelStride;
+    layout.positionOffset = modelAttributeOffset(CompiledStaticMesh::Geometry::PositionSemantic);
+    layout.textureCoordOffset = modelAttributeOffset(CompiledStaticMesh::Geometry::TextureCoordSemantic);
+    layout.normalOffset = modelAttributeOffset(CompiledStaticMesh::Geometry::NormalSemantic);
+
+    CompiledStaticMesh::TangentGenerator tangentGenerator;
+    if (!tangentGenerator.generate(m_modelVertices.constData(), layout, ranges, vertexCount)) {
+        return false;
+    }
+
+    uint8_t *vertices = reinterpret_cast<uint8_t *>(m_modelVertices.data());
+    uint32_t tangentOffset = modelAttributeOffset(CompiledStaticMesh::Geometry::TangentSemantic);
+    uint32_t binormalOffset = modelAttributeOffset(CompiledStaticMesh::Geometry::BinormalSemantic);
+
+    for (const CompiledStaticMesh::TangentGenerator::Range &range : ranges) {
+        for (uint32_t i = range.offset; i < range.offset + range.count; i++) {
+            uint8_t *vertex = vertices + static_cast<size_t>(i) * m_modelStride;
+            std::memcpy(vertex + tangentOffset, tangentGenerator.tangent(i), sizeof(Vector3));
+            std::memcpy(vertex + binormalOffset, tangentGenerator.binormal(i), sizeof(Vector3));
+        }
+    }
+
+    buildModelGeometry();
 
     return true;
 }
+
+void Model::setTransparentMaterials(const QList<int> &materialIndices)
+{
+    for (Subset &subset : m_subsets) {
+        subset.transparent = materialIndices.contains(static_cast<int>(subset.material));
+    }
+
+    m_sortValid = false;
+}
+
+bool Model::sortTransparent(const QVector3D &cameraPosition)
+{
+    /*
+        Skip until the camera has moved a fraction of the model size since the last sort
+    */
+    float threshold = (m_boundingBox.max - m_boundingBox.min).length() * Model::TransparentSortDistance;
+
+    if (m_sortValid && (cameraPosition - m_sortPosition).length() < threshold) {
+        return false;
+    }
+
+    const uint8_t *vertices = reinterpret_cast<const uint8_t *>(m_modelVertices.constData()) +
+        modelAttributeOffset(CompiledStaticMesh::Geometry::PositionSemantic);
+    uint32_t *indices = reinterpret_cast<uint32_t *>(m_modelIndices.data());
+    bool sorted = false;
+    std::vector<uint32_t> keys;
+
+    for (const Subset &subset : m_subsets) {
+        if (!subset.transparent) {
+            continue;
+        }
+
+        uint32_t triangleCount = subset.count / 3;
+        keys.resize(triangleCount);
+
+        CompiledStaticMesh::Parallel::forEach(triangleCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+            Q_UNUSED(thread)
+
+            for (uint32_t i = begin; i < end; i++) {
+                const uint8_t *triangle = vertices + static_cast<size_t>(subset.offset + i * 3) * m_modelStride;
+                Vector3 centroid = {};
+                float distance = 0.0f;
+
+                for (uint32_t k = 0; k < 3; k++) {
+                    Vector3 position;
+                    std::memcpy(position.data, triangle + static_cast<size_t>(k) * m_modelStride, sizeof(Vector3));
+
+                    for (uint32_t j = 0; j < 3; j++) {
+                        centroid.data[j] += position.data[j] / 3.0f;
+                    }
+                }
+
+                for (uint32_t j = 0; j < 3; j++) {
+                    float delta = centroid.data[j] - cameraPosition[j];
+                    distance += delta * delta;
+                }
+
+                keys[i] = CompiledStaticMesh::RadixSort::floatKey(-distance);
+            }
+        });
+
+        m_radixSort.sort(keys.data(), triangleCount);
+        const std::vector<uint32_t> &order = m_radixSort.indices();
+
+        CompiledStaticMesh::Parallel::forEach(triangleCount, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+            Q_UNUSED(thread)
+
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t *triangle = indices + subset.offset + i * 3;
+                uint32_t source = subset.offset + order[i] * 3;
+
+                triangle[0] = source;
+                triangle[1] = source + 1;
+                triangle[2] = source + 2;
+            }
+        });
+
+        m_modelGeometry.setIndexData(subset.offset * sizeof(uint32_t),
+            QByteArray::fromRawData(reinterpret_cast<const char *>(indices + subset.offset),
+                triangleCount * 3 * sizeof(uint32_t)));
+        sorted = true;
+    }
+
+    m_sortPosition = cameraPosition;
+    m_sortValid = true;
+
+    if (sorted) {
+        m_modelGeometry.update();
+    }
+
+    return sorted;
+}
+
+QList<float> Model::materialCoverage(const QVector3D &position, const QVector3D &forward,
+    const QVector3D &up, float fieldOfView, float aspectRatio) const
+{
+    /*
+        Triangles with their centroid in view add their solid angle, relative to the
+        solid angle of the view, to the material of their subset
+    */
+    QList<float> coverage(m_materials.size(), 0.0f);
+
+    if (m_modelVertices.isEmpty()) {
+        return coverage;
+    }
+
+    QVector3D direction = forward.normalized();
+    QVector3D right = QVector3D::crossProduct(direction, up).normalized();
+    QVector3D cameraUp = QVector3D::crossProduct(right, direction);
+    float tanVertical = qTan(qDegreesToRadians(fieldOfView) / 2.0f);
+    float tanHorizontal = tanVertical * aspectRatio;
+    float viewSolidAngle = 4.0f * tanVertical * tanHorizontal;
+
+    const uint8_t *vertices = reinterpret_cast<const uint8_t *>(m_modelVertices.constData()) +
+        modelAttributeOffset(CompiledStaticMesh::Geometry::PositionSemantic);
+    std::vector<float> sums(CompiledStaticMesh::Parallel::threadCount());
+
+    for (const Subset &subset : m_subsets) {
+        if (subset.material >= static_cast<uint32_t>(coverage.size())) {
+            continue;
+        }
+
+        std::fill(sums.begin(), sums.end(), 0.0f);
+
+        CompiledStaticMesh::Parallel::forEach(subset.count / 3, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+            float sum = 0.0f;
+
+            for (uint32_t i = begin; i < end; i++) {
+                const uint8_t *triangle = vertices + static_cast<size_t>(subset.offset + i * 3) * m_modelStride;
+                QVector3D corners[3];
+
+                for (uint32_t k = 0; k < 3; k++) {
+                    Vector3 corner;
+                    std::memcpy(corner.data, triangle + static_cast<size_t>(k) * m_modelStride, sizeof(Vector3));
+                    corners[k] = QVector3D(corner.data[0], corner.data[1], corner.data[2]);
+                }
+
+                QVector3D toCentroid = (corners[0] + corners[1] + corners[2]) / 3.0f - position;
+                float depth = QVector3D::dotProduct(toCentroid, direction);
+
+                if (depth <= 0.0f ||
+                    qAbs(QVector3D::dotProduct(toCentroid, right)) > depth * tanHorizontal ||
+                    qAbs(QVector3D::dotProduct(toCentroid, cameraUp)) > depth * tanVertical) {
+                    continue;
+                }
+
+                float distanceSquared = toCentroid.lengthSquared();
+                QVector3D normal = QVector3D::crossProduct(corners[1] - corners[0], corners[2] - corners[0]);
+
+                sum += qAbs(QVector3D::dotProduct(normal, toCentroid)) /
+                    (2.0f * distanceSquared * qSqrt(distanceSquared));
+            }
+
+            sums[thread] += sum;
+        });
+
+        for (float sum : sums) {
+            coverage[static_cast<qsizetype>(subset.material)] += sum / viewSolidAngle;
+        }
+    }
+
+    return coverage;
+}
@@ -1,15 +1,22 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <map>
+#include <QFile>
 #include <QFileInfo>
 #include <QDir>
 #include <QString>
 #include <QObject>
 #include <QQuick3DGeometry>
+#include <QVariantMap>
 #include <QVector3D>
+#include <QtMath>
 #include <qqml.h>
 #include "CompiledStaticMesh.h"
+#include "GeometryCache.h"
 #include "ImageProvider.h"
+#include "TextureBudget.h"
+#include "TextureCache.h"
 
 #undef min
 #undef max
@@ -20,6 +27,10 @@ class Model: public QObject
 public:
     static constexpr const float NormalGeometryOffset = 8.0f;
     static constexpr const float GridGeometryOffset = 0.001f;
+    static constexpr const float QualityGeometryOffset = 0.002f;
+    static constexpr const float SideGeometryOffset = 0.003f;
+    static constexpr const float TransparentSortDistance = 0.01f;
+    static constexpr const uint32_t NoBucket = 0xffffffff;
 
     Q_OBJECT
     Q_PROPERTY(const QQuick3DGeometry *modelGeometry READ modelGeometry NOTIFY geometryChanged)
@@ -27,6 +38,7 @@ public:
     Q_PROPERTY(const QQuick3DGeometry *normalGeometry READ normalGeometry NOTIFY geometryChanged)
     Q_PROPERTY(uint32_t materialCount READ materialCount NOTIFY geometryChanged)
     Q_PROPERTY(QStringList materials READ materials NOTIFY geometryChanged)
+    Q_PROPERTY(QList<int> subsetMaterials READ subsetMaterials NOTIFY geometryChanged)
     Q_PROPERTY(QStringList materialDirectories READ materialDirectories NOTIFY geometryChanged)
     Q_PROPERTY(uint32_t version READ version NOTIFY geometryChanged)
     Q_PROPERTY(uint32_t faceCount READ faceCount NOTIFY geometryChanged)
@@ -36,8 +48,49 @@ public:
     Q_PROPERTY(QVector3D boundingBoxMin READ boundingBoxMin NOTIFY boundingBoxChanged)
     Q_PROPERTY(QVector3D boundingBoxMax READ boundingBoxMax NOTIFY boundingBoxChanged)
     Q_PROPERTY(QString path READ path NOTIFY geometryChanged)
+    Q_PROPERTY(bool weldVertices READ weldVertices WRITE setWeldVertices NOTIFY optionsChanged)
+    Q_PROPERTY(float weldDistance READ weldDistance WRITE setWeldDistance NOTIFY optionsChanged)
+    Q_PROPERTY(float weldNormalAngle READ weldNormalAngle WRITE setWeldNormalAngle NOTIFY optionsChanged)
+    Q_PROPERTY(bool recomputeNormals READ recomputeNormals WRITE setRecomputeNormals NOTIFY optionsChanged)
+    Q_PROPERTY(float creaseAngle READ creaseAngle WRITE setCreaseAngle NOTIFY optionsChanged)
+    Q_PROPERTY(bool normalsRecomputed READ normalsRecomputed NOTIFY geometryChanged)
+    Q_PROPERTY(bool hasSourceData READ hasSourceData NOTIFY geometryChanged)
+    Q_PROPERTY(bool hasVertexColors READ hasVertexColors NOTIFY geometryChanged)
+    Q_PROPERTY(int geometryCacheLimit READ geometryCacheLimit WRITE setGeometryCacheLimit NOTIFY optionsChanged)
+    Q_PROPERTY(bool geometryCached READ geometryCached NOTIFY geometryChanged)
+    Q_PROPERTY(int textureCacheLimit READ textureCacheLimit WRITE setTextureCacheLimit NOTIFY optionsChanged)
+    Q_PROPERTY(int textureBudget READ textureBudget WRITE setTextureBudget NOTIFY optionsChanged)
+    Q_PROPERTY(bool hasSides READ hasSides NOTIFY geometryChanged)
+    Q_PROPERTY(bool hasTiles READ hasTiles NOTIFY geometryChanged)
+    Q_PROPERTY(bool regionLoaded READ regionLoaded NOTIFY geometryChanged)
+    Q_PROPERTY(QString packFilename READ packFilename NOTIFY geometryChanged)
+    Q_PROPERTY(QStringList packMembers READ packMembers NOTIFY geometryChanged)
+    Q_PROPERTY(QString packMember READ packMember NOTIFY geometryChanged)
+    Q_PROPERTY(bool sidesVisible READ sidesVisible WRITE setSidesVisible NOTIFY sidesChanged)
+    Q_PROPERTY(const QQuick3DGeometry *sideGeometry READ sideGeometry NOTIFY sidesChanged)
+    Q_PROPERTY(const QQuick3DGeometry *qualityGeometry READ qualityGeometry NOTIFY qualityChanged)
+    Q_PROPERTY(bool qualityAnalyzed READ qualityAnalyzed NOTIFY qualityChanged)
+    Q_PROPERTY(int qualityIssue READ qualityIssue WRITE setQualityIssue NOTIFY qualityChanged)
+    Q_PROPERTY(uint32_t degenerateFaceCount READ degenerateFaceCount NOTIFY qualityChanged)
+    Q_PROPERTY(uint32_t zeroAreaFaceCount READ zeroAreaFaceCount NOTIFY qualityChanged)
+    Q_PROPERTY(uint32_t duplicateFaceCount READ duplicateFaceCount NOTIFY qualityChanged)
+    Q_PROPERTY(uint32_t nonManifoldEdgeCount READ nonManifoldEdgeCount NOTIFY qualityChanged)
+    Q_PROPERTY(uint32_t openEdgeCount READ openEdgeCount NOTIFY qualityChanged)
+    Q_PROPERTY(uint32_t unreferencedVertexCount READ unreferencedVertexCount NOTIFY qualityChanged)
     QML_ELEMENT
 
+public:
+    enum QualityIssue {
+        NoQualityIssue = -1,
+        DegenerateFaces = CompiledStaticMesh::Analyzer::DegenerateFaces,
+        ZeroAreaFaces = CompiledStaticMesh::Analyzer::ZeroAreaFaces,
+        DuplicateFaces = CompiledStaticMesh::Analyzer::DuplicateFaces,
+        NonManifoldEdges = CompiledStaticMesh::Analyzer::NonManifoldEdges,
+        OpenEdges = CompiledStaticMesh::Analyzer::OpenEdges,
+        UnreferencedVertices = CompiledStaticMesh::Analyzer::UnreferencedVertices
+    };
+    Q_ENUM(QualityIssue)
+
     struct Vector3 {
         union {
             struct {
@@ -61,10 +114,36 @@ public:
         };
     };
 
+    struct Color {
+        union {
+            struct {
+                float r;
+                float g;
+                float b;
+                float a;
+            };
+
+            float data[4];
+        };
+    };
+
     struct Vertex {
         Vector3 position;
         Vector2 textureCoord;
         Vector3 normal;
+        Vector2 lightmapCoord;
+        Color color;
+    };
+
+    struct Subset {
+        uint32_t material;
+        int32_t lightmapGroup;
+        uint32_t offset;
+        uint32_t count;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+        bool hasTangents;
+        bool transparent;
     };
 
     struct BoundingBox {
@@ -74,14 +153,68 @@ public:
 
 private:
     CompiledStaticMesh::Interface *m_compiledStaticMesh;
+    CompiledStaticMesh::Geometry *m_cachedGeometry;
+    CompiledStaticMesh::Analyzer m_analyzer;
+    std::vector<std::string> m_materialNames;
+    QVector<uint8_t> m_faces;
+    QVector<uint8_t> m_vertices;
+    bool m_qualityAnalyzed;
+    int m_qualityIssue;
+    bool m_weldVertices;
+    float m_weldDistance;
+    float m_weldNormalAngle;
+    bool m_recomputeNormals;
+    float m_creaseAngle;
+    bool m_normalsRecomputed;
+    int m_geometryCacheLimit;
+    bool m_geometryCached;
     QStringList m_materials;
     BoundingBox m_boundingBox;
     QStringList m_materialDirectories;
     QString m_filename;
     QString m_path;
+    QByteArray m_modelVertices;
+    QByteArray m_modelIndices;
+    QVector<CompiledStaticMesh::Geometry::Attribute> m_modelAttributes;
+    uint32_t m_modelStride;
+    QByteArray m_normalVertices;
+    QByteArray m_gridVertices;
+    QVector<Subset> m_subsets;
+    CompiledStaticMesh::RadixSort m_radixSort;
+    QVector3D m_sortPosition;
+    bool m_sortValid;
+    bool m_sidesVisible;
+    QVector<int32_t> m_faceSides;
+    QVector<float> m_regionPlanes;
+    CompiledStaticMesh::Pack m_pack;
+    QString m_packFilename;
+    QStringList m_packMembers;
+    QString m_packMember;
+    QByteArray m_sideVertices;
     QQuick3DGeometry m_modelGeometry;
     QQuick3DGeometry m_normalGeometry;
     QQuick3DGeometry m_gridGeometry;
+    QQuick3DGeometry m_qualityGeometry;
+    QQuick3DGeometry m_sideGeometry;
+
+    void buildModelGeometry();
+    void appendModelAttribute(CompiledStaticMesh::Geometry::Semantic semantic, uint32_t size,
+        CompiledStaticMesh::Geometry::ComponentType componentType = CompiledStaticMesh::Geometry::F32Type);
+    int modelAttributeOffset(CompiledStaticMesh::Geometry::Semantic semantic) const;
+    bool loadCompiledStaticMeshRegion(const QUrl &filename, const QVector<float> &regionPlanes);
+    bool openPack(const QString &filename);
+    void closePack();
+    bool readSourceData();
+    QString geometryCacheOptions() const;
+    bool loadCachedGeometry(const GeometryCache::Entry &cacheEntry);
+    bool writeCachedGeometry(const GeometryCache::Entry &cacheEntry) const;
+    bool loadGeometry(const CompiledStaticMesh::Geometry *geometry);
+    void buildQualityGeometry();
+    CompiledStaticMesh::Version3 *sideSource() const;
+    void buildSideGeometry();
+    bool writeCompiledStaticMesh(CompiledStaticMesh::Interface *compiledStaticMesh,
+        const QString &filename) const;
+    bool writeGeometry(CompiledStaticMesh::Geometry *geometry, const QString &filename) const;
 
 public:
     explicit Model(QObject *parent = nullptr);
@@ -92,6 +225,7 @@ public:
     const QQuick3DGeometry *gridGeometry() const;
     uint32_t materialCount() const;
     QStringList materials() const;
+    QList<int> subsetMaterials() const;
     uint32_t version() const;
     uint32_t faceCount() const;
     uint32_t faceDataSize() const;
@@ -101,13 +235,73 @@ public:
     QStringList materialDirectories() const;
     QVector3D boundingBoxMin() const;
     QVector3D boundingBoxMax() const;
+    bool weldVertices() const;
+    void setWeldVertices(bool weldVertices);
+    float weldDistance() const;
+    void setWeldDistance(float weldDistance);
+    float weldNormalAngle() const;
+    void setWeldNormalAngle(float weldNormalAngle);
+    bool recomputeNormals() const;
+    void setRecomputeNormals(bool recomputeNormals);
+    float creaseAngle() const;
+    void setCreaseAngle(float creaseAngle);
+    bool normalsRecomputed() const;
+    int geometryCacheLimit() const;
+    void setGeometryCacheLimit(int geometryCacheLimit);
+    bool geometryCached() const;
+    int textureCacheLimit() const;
+    void setTextureCacheLimit(int textureCacheLimit);
+    Q_INVOKABLE QVariantMap textureCacheStatistics() const;
+    int textureBudget() const;
+    void setTextureBudget(int textureBudget);
+    Q_INVOKABLE QVariantMap textureBudgetStatistics() const;
+    bool hasSourceData() const;
+    bool hasVertexColors() const;
+    bool hasSides() const;
+    bool hasTiles() const;
+    bool regionLoaded() const;
+    QString packFilename() const;
+    QStringList packMembers() const;
+    QString packMember() const;
+    bool sidesVisible() const;
+    void setSidesVisible(bool sidesVisible);
+    const QQuick3DGeometry *sideGeometry() const;
+    const QQuick3DGeometry *qualityGeometry() const;
+    bool qualityAnalyzed() const;
+    int qualityIssue() const;
+    void setQualityIssue(int qualityIssue);
+    uint32_t degenerateFaceCount() const;
+    uint32_t zeroAreaFaceCount() const;
+    uint32_t duplicateFaceCount() const;
+    uint32_t nonManifoldEdgeCount() const;
+    uint32_t openEdgeCount() const;
+    uint32_t unreferencedVertexCount() const;
     void release();
     void build();
     Q_INVOKABLE bool loadCompiledStaticMesh(const QUrl &filename);
+    Q_INVOKABLE bool loadCompiledStaticMeshBox(const QUrl &filename, const QVector3D &boundsMin,
+        const QVector3D &boundsMax);
+    Q_INVOKABLE bool loadCompiledStaticMeshFrustum(const QUrl &filename, const QVector3D &position,
+        const QVector3D &forward, const QVector3D &up, float fieldOfView, float aspectRatio,
+        float clipNear, float clipFar);
+    Q_INVOKABLE bool saveCompiledStaticMesh(const QUrl &filename);
+    Q_INVOKABLE bool saveGeometry(const QUrl &filename);
+    Q_INVOKABLE bool savePack(const QUrl &filename, const QList<QUrl> &members) const;
+    Q_INVOKABLE bool generateTangents(const QList<int> &materialIndices);
+    Q_INVOKABLE void setTransparentMaterials(const QList<int> &materialIndices);
+    Q_INVOKABLE bool sortTransparent(const QVector3D &cameraPosition);
+    Q_INVOKABLE QList<float> materialCoverage(const QVector3D &position, const QVector3D &forward,
+        const QVector3D &up, float fieldOfView, float aspectRatio) const;
+    Q_INVOKABLE bool analyzeQuality();
+    Q_INVOKABLE QList<uint32_t> qualityIndices(int qualityIssue) const;
+    Q_INVOKABLE int faceSide(int faceIndex);
 
 signals:
     void boundingBoxChanged();
     void geometryChanged();
+    void optionsChanged();
+    void qualityChanged();
+    void sidesChanged();
 
 };
 
@@ -0,0 +1,130 @@
+#include <QBuffer>
+#include <QImageReader>
+#include "CompiledStaticMesh.h"
+#include "QtImageDecoder.h"
+
+bool QtImageDecoder::isDirectFormat(QImage::Format format)
+{
+    /*
+        Formats that end up as RGBA8 with at most a red and blue swap
+    */
+    switch (format) {
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBX8888:
+        return true;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+bool QtImageDecoder::canDecode(const QString &suffix, const QByteArray &fileData) const
+{
+    return suffix == "png" || suffix == "jpg" || suffix == "jpeg" || suffix == "bmp" ||
+        fileData.startsWith("\x89PNG") || fileData.startsWith("\xff\xd8\xff") || fileData.startsWith("BM");
+}
+
+bool QtImageDecoder::decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const
+{
+    Q_UNUSED(suffix)
+
+    QBuffer buffer;
+    buffer.setData(fileData);
+
+    if (!buffer.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(false);
+
+    QSize size = reader.size();
+    QImage::Format format = reader.imageFormat();
+    QImage decoded;
+
+    image->format = QQuick3DTextureData::Format::RGBA8;
+    image->levelCount = 1;
+
+    /*
+        Readers reuse a target of the size and format they decode to, so 32 bit
+        images land in the texture buffer and are swizzled there
+    */
+    if (size.isValid() && !size.isEmpty() && isDirectFormat(format)) {
+        image->data = QByteArray(static_cast<qsizetype>(size.width()) * size.height() * 4, Qt::Uninitialized);
+        uchar *pixels = reinterpret_cast<uchar *>(image->data.data());
+        decoded = QImage(pixels, size.width(), size.height(), size.width() * 4, format);
+
+        if (!reader.read(&decoded)) {
+            image->data.clear();
+            return false;
+        }
+
+        if (decoded.constBits() == pixels) {
+            if (format == QImage::Format_RGB32 || format == QImage::Format_ARGB32) {
+                CompiledStaticMesh::PixelConverter::swapRedBlue(pixels, static_cast<size_t>(size.width()) * size.height());
+            }
+
+            image->size = size;
+            return true;
+        }
+    } else if (!reader.read(&decoded)) {
+        return false;
+    }
+
+    /*
+        Indexed, gray and premultiplied images are converted and copied once
+    */
+    decoded.convertTo(QImage::Format_RGBA8888);
+    image->data = QByteArray(reinterpret_cast<const char *>(decoded.constBits()), decoded.sizeInBytes());
+    image->size = decoded.size();
+
+    return !image->data.isEmpty();
+}
+
+bool QtImageDecoder::decodePreview(const QString &suffix, const QByteArray &fileData, int maxSize,
+    Texture::DecodedImage *image) const
+{
+    Q_UNUSED(suffix)
+
+    QBuffer buffer;
+    buffer.setData(fileData);
+
+    if (!buffer.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(false);
+
+    /*
+        Only handlers that scale while decoding, like JPEG, make a preview cheaper than the full image
+    */
+    QSize size = reader.size();
+
+    if (!reader.supportsOption(QImageIOHandler::ScaledSize) || !size.isValid() ||
+        qMax(size.width(), size.height()) <= maxSize) {
+        return false;
+    }
+
+    reader.setScaledSize(size.scaled(maxSize, maxSize, Qt::KeepAspectRatio).expandedTo(QSize(1, 1)));
+
+    QImage decoded;
+
+    if (!reader.read(&decoded)) {
+        return false;
+    }
+
+    decoded.convertTo(QImage::Format_RGBA8888);
+    image->data = QByteArray(reinterpret_cast<const char *>(decoded.constBits()), decoded.sizeInBytes());
+    image->format = QQuick3DTextureData::Format::RGBA8;
+    image->size = decoded.size();
+    image->levelCount = 1;
+
+    return !image->data.isEmpty();
+}
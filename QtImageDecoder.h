@@ -0,0 +1,24 @@
+#ifndef QTIMAGEDECODER_H
+#define QTIMAGEDECODER_H
+
+#include <QImage>
+#include "ImageDecoder.h"
+
+/*
+    PNG, JPEG and BMP files through the reentrant Qt image readers
+*/
+class QtImageDecoder: public ImageDecoder
+{
+
+private:
+    static bool isDirectFormat(QImage::Format format);
+
+public:
+    bool canDecode(const QString &suffix, const QByteArray &fileData) const override;
+    bool decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const override;
+    bool decodePreview(const QString &suffix, const QByteArray &fileData, int maxSize,
+        Texture::DecodedImage *image) const override;
+
+};
+
+#endif // QTIMAGEDECODER_H
@@ -1,10 +1,33 @@
+#include <QFileInfo>
+#include <QtConcurrent>
+#include "CompiledStaticMesh.h"
+#include "DdsImage.h"
+#include "ImageDecoder.h"
 #include "Texture.h"
+#include "TextureBudget.h"
+#include "TextureCache.h"
+#include "TextureResolver.h"
 
 Texture::Texture(QQuick3DTextureData *parent) :
     QQuick3DTextureData(parent),
-    m_isAlpha(false)
+    m_isAlpha(false),
+    m_isAlphaMask(false),
+    m_isCompressed(false),
+    m_loadPriority(0),
+    m_loadStage(FullStage),
+    m_loadAnnounced(false),
+    m_loadPending(false),
+    m_isLoading(false),
+    m_usage(0),
+    m_isReduced(false)
 {
+    connect(&m_loadWatcher, &QFutureWatcher<DecodedImage>::finished, this, &Texture::loadWatcherFinished);
+}
 
+Texture::~Texture()
+{
+    setLoading(false);
+    TextureBudget::replace(m_usage, m_isReduced, 0, false);
 }
 
 void Texture::registerQmlType()
@@ -17,120 +40,226 @@ bool Texture::isAlpha()
     return m_isAlpha;
 }
 
-QString Texture::filename() const
+bool Texture::isAlphaMask() const
 {
-    return m_filename;
+    return m_isAlphaMask;
 }
 
-bool Texture::load(const QString &directory, const QString &name, const QString &mapName)
+bool Texture::isCompressed() const
 {
-    static const char *ext[4] = {
-        "dds",
-        "png",
-        "bmp",
-        "jpg"
-    };
-
-    QString filename = directory + name;
+    return m_isCompressed;
+}
 
-    for (uint32_t i = 0; i < sizeof(ext) / sizeof(char *); i++) {
-        QString path = filename + "." + QString(ext[i]);
-        if (QFile::exists(path)) {
-            filename = path;
-            break;
-        }
-    }
+QString Texture::filename() const
+{
+    return m_filename;
+}
 
-    return loadByFilename(filename, mapName);
+QString Texture::directory() const
+{
+    return m_directory;
 }
 
-bool Texture::loadByFilename(const QString &filename, const QString &mapName)
+QString Texture::imageFilename(const QString &directory, const QString &name)
 {
-    static bool ilIsInit = false;
+    return TextureResolver::instance()->resolve(directory, name);
+}
 
-    if (!ilIsInit) {
-        ilInit();
-        ilIsInit = true;
+bool Texture::decodeImage(const QString &filename, DecodedImage *image)
+{
+    /*
+        Decoders are reentrant and run concurrently on the pool, only files left
+        to DevIL are decoded one at a time
+    */
+    if (TextureCache::find(filename, image)) {
+        return true;
     }
 
-    ILuint id;
-    ilGenImages(1, &id);
-    ilBindImage(id);
+    image->isAlpha = false;
+    image->isAlphaMask = false;
+    image->source = QImage();
 
-    if (ilLoadImage(filename.toStdString().c_str()) != IL_TRUE) {
-        ilDeleteImages(1, &id);
+    if (!ImageDecoder::decodeFile(filename, image)) {
         return false;
     }
 
-    int width = ilGetInteger(IL_IMAGE_WIDTH);
-    int height = ilGetInteger(IL_IMAGE_HEIGHT);
-    int channels = ilGetInteger(IL_IMAGE_CHANNELS);
-    int format;
+    if (image->format == QQuick3DTextureData::Format::RGBA8) {
+        image->source = sharedImage(image->data, image->size);
+    }
+
+    scanAlpha(image);
+
+    image->filename = filename;
+    TextureCache::insert(filename, *image);
 
-    switch (channels) {
-    case 3:
-        format = IL_RGB;
-        break;
+    return true;
+}
 
-    case 4:
-        format = IL_RGBA;
-        break;
+void Texture::scanAlpha(DecodedImage *image)
+{
+    /*
+        Uncompressed images are scanned at full resolution, block compressed ones
+        through their decompressed thumbnail level
+    */
+    CompiledStaticMesh::AlphaScanner::Coverage coverage = image->isAlpha ?
+        CompiledStaticMesh::AlphaScanner::Graded : CompiledStaticMesh::AlphaScanner::Opaque;
 
-    default:
-        format = IL_FALSE;
-        break;
+    if (!image->source.isNull()) {
+        coverage = CompiledStaticMesh::AlphaScanner::scan(image->source.constBits(),
+            static_cast<size_t>(image->source.width()) * image->source.height());
     }
 
-    if (width < 1 || height < 1 || format == IL_FALSE) {
-        ilDeleteImages(1, &id);
-        return false;
+    image->isAlpha = coverage != CompiledStaticMesh::AlphaScanner::Opaque;
+    image->isAlphaMask = coverage == CompiledStaticMesh::AlphaScanner::Binary;
+}
+
+QImage Texture::sharedImage(const QByteArray &data, const QSize &size)
+{
+    /*
+        The image keeps its own reference to the pixels instead of a copy
+    */
+    QByteArray *pixels = new QByteArray(data);
+
+    return QImage(reinterpret_cast<const uchar *>(pixels->constData()), size.width(), size.height(),
+        QImage::Format::Format_RGBA8888, [](void *info) {
+            delete reinterpret_cast<QByteArray *>(info);
+        }, pixels);
+}
+
+qint64 Texture::imageUsage(QQuick3DTextureData::Format format, const QSize &size)
+{
+    /*
+        Uncompressed textures get a generated mip chain on upload, a third of the base level
+    */
+    if (format == QQuick3DTextureData::Format::RGBA8) {
+        qint64 levelSize = static_cast<qint64>(size.width()) * size.height() * 4;
+        return levelSize + levelSize / 3;
     }
 
-    QByteArray data;
+    return DdsImage::dataSize(format, size);
+}
+
+void Texture::fitImage(DecodedImage *image, qint64 allowance, bool parallel)
+{
+    /*
+        Block compressed images drop their leading mip levels, uncompressed ones are
+        halved in linear light, neither is reduced past the minimum size. Decodes on
+        the pool halve on their own thread
+    */
+    image->isReduced = false;
+
+    if (image->format != QQuick3DTextureData::Format::RGBA8) {
+        int level = 0;
+        qsizetype offset = 0;
 
-    if (ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE)) {
-        char *pixels = reinterpret_cast<char *>(ilGetData());
-        if (pixels != nullptr) {
-            data.append(pixels, sizeof(char) * channels * width * height);
+        while (level + 1 < image->levelCount &&
+            imageUsage(image->format, DdsImage::levelSize(image->size, level)) > allowance &&
+            qMax(DdsImage::levelSize(image->size, level).width(), DdsImage::levelSize(image->size, level).height()) > MinimumSize) {
+            offset += DdsImage::dataSize(image->format, DdsImage::levelSize(image->size, level));
+            level++;
         }
+
+        QSize size = DdsImage::levelSize(image->size, level);
+        image->data = image->data.mid(offset, DdsImage::dataSize(image->format, size));
+        image->size = size;
+        image->levelCount = 1;
+        image->isReduced = level > 0;
+
+        return;
     }
 
-    ilDeleteImages(1, &id);
+    while (imageUsage(image->format, image->size) > allowance &&
+        qMax(image->size.width(), image->size.height()) > MinimumSize) {
+        uint32_t width = static_cast<uint32_t>(image->size.width());
+        uint32_t height = static_cast<uint32_t>(image->size.height());
+        QSize size(static_cast<int>(CompiledStaticMesh::MipGenerator::levelSize(width, 1)),
+            static_cast<int>(CompiledStaticMesh::MipGenerator::levelSize(height, 1)));
+        QByteArray data(static_cast<qsizetype>(size.width()) * size.height() * 4, Qt::Uninitialized);
 
-    if (data.isEmpty()) {
-        return false;
+        CompiledStaticMesh::MipGenerator::downsample(reinterpret_cast<const uint8_t *>(image->data.constData()),
+            width, height, reinterpret_cast<uint8_t *>(data.data()), parallel);
+
+        image->data = data;
+        image->size = size;
+        image->isReduced = true;
     }
 
-    setTextureData(data);
-    setFormat(QQuick3DTextureData::Format::RGBA8);
-    setSize(QSize(width, height));
+    if (image->isReduced) {
+        image->source = sharedImage(image->data, image->size);
+    }
+}
 
-    QImage imageProviderImage;
+Texture::DecodedImage Texture::findPreview(const QStringList &directories, const QStringList &names)
+{
+    /*
+        The first existing candidate names the file, its preview is left empty when
+        the decoder has no cheap way to a small image
+    */
+    for (const QString &name : names) {
+        for (const QString &directory : directories) {
+            QString filename = imageFilename(directory, name);
+
+            if (filename.isEmpty()) {
+                continue;
+            }
+
+            DecodedImage image = DecodedImage();
+            image.filename = filename;
+            image.directory = directory;
 
-    if (width > 256 || height > 256) {
-        if (width > height) {
-            imageProviderImage = QImage(reinterpret_cast<const uchar *>(data.data()),
-                                        width, height, QImage::Format::Format_RGBA8888).scaledToWidth(256);
-        } else {
-            imageProviderImage = QImage(reinterpret_cast<const uchar *>(data.data()),
-                                        width, height, QImage::Format::Format_RGBA8888).scaledToHeight(256);
+            if (!ImageDecoder::decodeFilePreview(filename, PreviewSize, &image)) {
+                image.data.clear();
+                return image;
+            }
+
+            if (image.format == QQuick3DTextureData::Format::RGBA8) {
+                image.source = sharedImage(image.data, image.size);
+            }
+
+            scanAlpha(&image);
+
+            return image;
         }
-    } else {
-        imageProviderImage = QImage(reinterpret_cast<const uchar *>(data.data()),
-                                    width, height, QImage::Format::Format_RGBA8888);
     }
 
-    m_isAlpha = false;
+    return DecodedImage();
+}
+
+Texture::DecodedImage Texture::findImage(const QStringList &directories, const QStringList &names, qint64 usage)
+{
+    DecodedImage image;
+
+    for (const QString &name : names) {
+        for (const QString &directory : directories) {
+            QString filename = imageFilename(directory, name);
 
-    for (int x = 0; x < imageProviderImage.width(); x++) {
-        for (int y = 0; y < imageProviderImage.height(); y++) {
-            if (qAlpha(imageProviderImage.pixel(x, y)) != 255) {
-                m_isAlpha = true;
-                break;
+            if (!filename.isEmpty() && decodeImage(filename, &image)) {
+                fitImage(&image, TextureBudget::allowance(usage), false);
+                image.directory = directory;
+                return image;
             }
         }
     }
 
+    return DecodedImage();
+}
+
+void Texture::applyImage(const DecodedImage &image, const QString &mapName)
+{
+    qint64 usage = imageUsage(image.format, image.size);
+    TextureBudget::replace(m_usage, m_isReduced, usage, image.isReduced);
+    m_usage = usage;
+    m_isReduced = image.isReduced;
+
+    setTextureData(image.data);
+    setFormat(image.format);
+    setSize(image.size);
+
+    m_isCompressed = image.format != QQuick3DTextureData::Format::RGBA8;
+    emit isCompressedChanged();
+
+    m_isAlpha = image.isAlpha;
+    m_isAlphaMask = image.isAlphaMask;
     emit isAlphaChanged();
 
     if (m_isAlpha) {
@@ -139,9 +268,132 @@ bool Texture::loadByFilename(const QString &filename, const QString &mapName)
         setHasTransparency(false);
     }
 
-    ImageProvider::appendImage(mapName, new QPixmap(QPixmap::fromImage(imageProviderImage)));
-    m_filename = filename;
+    ImageProvider::appendImage(mapName, image.source);
+    m_filename = image.filename;
+    m_directory = image.directory;
     update();
+}
+
+bool Texture::load(const QString &directory, const QString &name, const QString &mapName)
+{
+    QString filename = imageFilename(directory, name);
+
+    if (filename.isEmpty()) {
+        return false;
+    }
+
+    return loadByFilename(filename, mapName);
+}
+
+bool Texture::loadByFilename(const QString &filename, const QString &mapName)
+{
+    /*
+        An explicit load replaces any decode still running on the pool
+    */
+    m_loadPending = false;
+    setLoading(true);
+
+    DecodedImage image;
+
+    if (!decodeImage(filename, &image)) {
+        setLoading(false);
+        return false;
+    }
+
+    fitImage(&image, TextureBudget::allowance(m_usage), true);
+    image.directory = QFileInfo(filename).path() + "/";
+    applyImage(image, mapName);
+    setLoading(false);
 
     return true;
 }
+
+void Texture::loadAsync(const QStringList &directories, const QStringList &names, const QString &mapName,
+    float coverage)
+{
+    /*
+        Previews of every texture are queued ahead of all full decodes, which follow
+        in order of the screen area covered by their material
+    */
+    m_loadPending = true;
+    m_loadMapName = mapName;
+    m_loadDirectories = directories;
+    m_loadNames = names;
+    m_loadPriority = qRound(qBound(0.0f, coverage, 1.0f) * CoveragePriorityScale);
+    m_loadStage = PreviewStage;
+    m_loadAnnounced = false;
+    setLoading(true);
+
+    m_loadWatcher.setFuture(QtConcurrent::task(&Texture::findPreview)
+        .withArguments(directories, names)
+        .withPriority(PreviewPriority)
+        .spawn());
+}
+
+void Texture::loadWatcherFinished()
+{
+    if (!m_loadPending) {
+        return;
+    }
+
+    DecodedImage image = m_loadWatcher.result();
+
+    if (m_loadStage == PreviewStage) {
+        if (image.filename.isEmpty()) {
+            m_loadPending = false;
+            setLoading(false);
+            emit loadFinished(false);
+            return;
+        }
+
+        if (!image.data.isEmpty()) {
+            applyImage(image, m_loadMapName);
+            m_loadAnnounced = true;
+            emit loadFinished(true);
+        }
+
+        m_loadStage = FullStage;
+        m_loadWatcher.setFuture(QtConcurrent::task(&Texture::findImage)
+            .withArguments(m_loadDirectories, m_loadNames, m_usage)
+            .withPriority(m_loadPriority)
+            .spawn());
+        return;
+    }
+
+    m_loadPending = false;
+
+    bool loaded = !image.data.isEmpty();
+
+    if (loaded) {
+        applyImage(image, m_loadMapName);
+    }
+
+    setLoading(false);
+
+    /*
+        A failed full decode keeps the preview that was already announced
+    */
+    if (!m_loadAnnounced) {
+        emit loadFinished(loaded);
+    } else if (loaded) {
+        emit fullResolutionLoaded();
+    }
+}
+
+void Texture::setLoading(bool loading)
+{
+    /*
+        Loading textures share what is left of the budget
+    */
+    if (m_isLoading == loading) {
+        return;
+    }
+
+    m_isLoading = loading;
+
+    if (loading) {
+        TextureBudget::beginLoad();
+    } else {
+        TextureBudget::endLoad();
+    }
+}
@@ -1,36 +1,98 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
-#include <QFile>
+#include <QFutureWatcher>
+#include <QImage>
 #include <QObject>
 #include <QQuick3DTextureData>
 #include <QSize>
+#include <QStringList>
 #include <qqml.h>
 #include "ImageProvider.h"
 
-#undef _UNICODE
-#include "DevIL/include/IL/il.h"
-
 class Texture: public QQuick3DTextureData
 {
     Q_OBJECT
     Q_PROPERTY(bool isAlpha READ isAlpha NOTIFY isAlphaChanged)
+    Q_PROPERTY(bool isAlphaMask READ isAlphaMask NOTIFY isAlphaChanged)
+    Q_PROPERTY(bool isCompressed READ isCompressed NOTIFY isCompressedChanged)
     QML_ELEMENT
 
+public:
+    static constexpr const int MinimumSize = 64;
+    static constexpr const int PreviewSize = 128;
+    static constexpr const int PreviewPriority = 1 << 30;
+    static constexpr const int CoveragePriorityScale = 1 << 20;
+
+    enum LoadStage {
+        PreviewStage,
+        FullStage
+    };
+
+    struct DecodedImage {
+        QByteArray data;
+        QQuick3DTextureData::Format format;
+        QSize size;
+        int levelCount;
+        bool isReduced;
+        QImage source;
+        bool isAlpha;
+        bool isAlphaMask;
+        QString filename;
+        QString directory;
+    };
+
 private:
     bool m_isAlpha;
+    bool m_isAlphaMask;
+    bool m_isCompressed;
     QString m_filename;
+    QString m_directory;
+    QFutureWatcher<DecodedImage> m_loadWatcher;
+    QString m_loadMapName;
+    QStringList m_loadDirectories;
+    QStringList m_loadNames;
+    int m_loadPriority;
+    LoadStage m_loadStage;
+    bool m_loadAnnounced;
+    bool m_loadPending;
+    bool m_isLoading;
+    qint64 m_usage;
+    bool m_isReduced;
+
+    static QString imageFilename(const QString &directory, const QString &name);
+    static bool decodeImage(const QString &filename, DecodedImage *image);
+    static QImage sharedImage(const QByteArray &data, const QSize &size);
+    static void scanAlpha(DecodedImage *image);
+    static qint64 imageUsage(QQuick3DTextureData::Format format, const QSize &size);
+    static void fitImage(DecodedImage *image, qint64 allowance, bool parallel);
+    static DecodedImage findPreview(const QStringList &directories, const QStringList &names);
+    static DecodedImage findImage(const QStringList &directories, const QStringList &names, qint64 usage);
+    void applyImage(const DecodedImage &image, const QString &mapName);
+    void setLoading(bool loading);
+
+private slots:
+    void loadWatcherFinished();
 
 public:
     explicit Texture(QQuick3DTextureData *parent = nullptr);
+    ~Texture() override;
     static void registerQmlType();
     bool isAlpha();
+    bool isAlphaMask() const;
+    bool isCompressed() const;
     Q_INVOKABLE bool load(const QString &directory, const QString &name, const QString &mapName);
     Q_INVOKABLE bool loadByFilename(const QString &filename, const QString &mapName);
+    Q_INVOKABLE void loadAsync(const QStringList &directories, const QStringList &names,
+        const QString &mapName, float coverage = 0.0f);
     Q_INVOKABLE QString filename() const;
+    Q_INVOKABLE QString directory() const;
 
 signals:
     void isAlphaChanged();
+    void isCompressedChanged();
+    void loadFinished(bool loaded);
+    void fullResolutionLoaded();
 
 };
 
@@ -0,0 +1,74 @@
+#include <limits>
+#include <QMutexLocker>
+#include "TextureBudget.h"
+
+QMutex TextureBudget::m_mutex;
+qint64 TextureBudget::m_usage = 0;
+qint64 TextureBudget::m_limit = TextureBudget::DefaultLimit * TextureBudget::Megabyte;
+int TextureBudget::m_textureCount = 0;
+int TextureBudget::m_reducedCount = 0;
+int TextureBudget::m_loadingCount = 0;
+
+void TextureBudget::beginLoad()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_loadingCount++;
+}
+
+void TextureBudget::endLoad()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_loadingCount = qMax(0, m_loadingCount - 1);
+}
+
+qint64 TextureBudget::allowance(qint64 usage)
+{
+    /*
+        A texture being replaced gets its own usage back before the share is taken
+    */
+    QMutexLocker locker(&m_mutex);
+
+    if (m_limit == 0) {
+        return std::numeric_limits<qint64>::max();
+    }
+
+    return qMax<qint64>(0, m_limit - m_usage + usage) / qMax(1, m_loadingCount);
+}
+
+void TextureBudget::replace(qint64 previousUsage, bool previousReduced, qint64 usage, bool reduced)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_usage += usage - previousUsage;
+    m_textureCount += (usage > 0 ? 1 : 0) - (previousUsage > 0 ? 1 : 0);
+    m_reducedCount += (reduced ? 1 : 0) - (previousReduced ? 1 : 0);
+}
+
+void TextureBudget::setLimit(int megabytes)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_limit = static_cast<qint64>(qMax(0, megabytes)) * Megabyte;
+}
+
+int TextureBudget::limit()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return static_cast<int>(m_limit / Megabyte);
+}
+
+TextureBudget::Statistics TextureBudget::statistics()
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics statistics;
+    statistics.usage = m_usage;
+    statistics.limit = m_limit;
+    statistics.textureCount = m_textureCount;
+    statistics.reducedCount = m_reducedCount;
+
+    return statistics;
+}
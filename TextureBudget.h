@@ -0,0 +1,45 @@
+#ifndef TEXTUREBUDGET_H
+#define TEXTUREBUDGET_H
+
+#include <QMutex>
+#include <QtGlobal>
+
+/*
+    Memory held by the textures of the scene, counted with the mip levels
+    generated on upload. The part of the limit not used yet is shared evenly
+    by the textures still loading, which are reduced on decode to fit it.
+*/
+class TextureBudget
+{
+
+public:
+    static constexpr const int DefaultLimit = 2048;
+    static constexpr const qint64 Megabyte = 1024 * 1024;
+
+    struct Statistics {
+        qint64 usage;
+        qint64 limit;
+        int textureCount;
+        int reducedCount;
+    };
+
+private:
+    static QMutex m_mutex;
+    static qint64 m_usage;
+    static qint64 m_limit;
+    static int m_textureCount;
+    static int m_reducedCount;
+    static int m_loadingCount;
+
+public:
+    static void beginLoad();
+    static void endLoad();
+    static qint64 allowance(qint64 usage);
+    static void replace(qint64 previousUsage, bool previousReduced, qint64 usage, bool reduced);
+    static void setLimit(int megabytes);
+    static int limit();
+    static Statistics statistics();
+
+};
+
+#endif // TEXTUREBUDGET_H
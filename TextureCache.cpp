@@ -0,0 +1,143 @@
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include "TextureCache.h"
+
+QMutex TextureCache::m_mutex;
+QHash<QString, TextureCache::Entry> TextureCache::m_entries;
+qint64 TextureCache::m_usage = 0;
+qint64 TextureCache::m_limit = TextureCache::DefaultLimit * TextureCache::Megabyte;
+quint64 TextureCache::m_useCounter = 0;
+quint64 TextureCache::m_hits = 0;
+quint64 TextureCache::m_misses = 0;
+
+QString TextureCache::key(const QString &filename)
+{
+    if (filename.isEmpty()) {
+        return QString();
+    }
+
+    QFileInfo fileInfo(filename);
+
+    if (!fileInfo.isFile()) {
+        return QString();
+    }
+
+    return fileInfo.absoluteFilePath() + "|" + QString::number(fileInfo.size()) + "|" +
+        QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+void TextureCache::trim()
+{
+    /*
+        Least recently used entries go first until the cache fits its limit
+    */
+    while (m_usage > m_limit && !m_entries.isEmpty()) {
+        QHash<QString, Entry>::iterator oldest = m_entries.begin();
+
+        for (QHash<QString, Entry>::iterator i = m_entries.begin(); i != m_entries.end(); ++i) {
+            if (i->lastUse < oldest->lastUse) {
+                oldest = i;
+            }
+        }
+
+        m_usage -= oldest->size;
+        m_entries.erase(oldest);
+    }
+}
+
+bool TextureCache::find(const QString &filename, Texture::DecodedImage *image)
+{
+    QString entryKey = key(filename);
+
+    if (entryKey.isEmpty()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, Entry>::iterator entry = m_entries.find(entryKey);
+
+    if (entry == m_entries.end()) {
+        m_misses++;
+        return false;
+    }
+
+    entry->lastUse = ++m_useCounter;
+    *image = entry->image;
+    m_hits++;
+
+    return true;
+}
+
+void TextureCache::insert(const QString &filename, const Texture::DecodedImage &image)
+{
+    QString entryKey = key(filename);
+
+    if (entryKey.isEmpty()) {
+        return;
+    }
+
+    Entry entry;
+    entry.image = image;
+    entry.size = image.data.size();
+
+    if (image.format != QQuick3DTextureData::Format::RGBA8) {
+        entry.size += image.source.sizeInBytes();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (entry.size > m_limit) {
+        return;
+    }
+
+    QHash<QString, Entry>::iterator previous = m_entries.find(entryKey);
+
+    if (previous != m_entries.end()) {
+        m_usage -= previous->size;
+    }
+
+    entry.lastUse = ++m_useCounter;
+    m_entries.insert(entryKey, entry);
+    m_usage += entry.size;
+
+    trim();
+}
+
+void TextureCache::setLimit(int megabytes)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_limit = static_cast<qint64>(qMax(0, megabytes)) * Megabyte;
+    trim();
+}
+
+int TextureCache::limit()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return static_cast<int>(m_limit / Megabyte);
+}
+
+TextureCache::Statistics TextureCache::statistics()
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics statistics;
+    statistics.usage = m_usage;
+    statistics.limit = m_limit;
+    statistics.hits = m_hits;
+    statistics.misses = m_misses;
+    statistics.entryCount = static_cast<int>(m_entries.size());
+
+    return statistics;
+}
+
+void TextureCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_entries.clear();
+    m_usage = 0;
+}
@@ -0,0 +1,58 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include "Texture.h"
+
+/*
+    Decoded textures shared by every material and reload in the process,
+    keyed by path, size and modification time. Pixel buffers are implicitly
+    shared with the textures using them, so evicting an entry never
+    invalidates an uploaded texture.
+*/
+class TextureCache
+{
+
+public:
+    static constexpr const int DefaultLimit = 512;
+    static constexpr const qint64 Megabyte = 1024 * 1024;
+
+    struct Statistics {
+        qint64 usage;
+        qint64 limit;
+        quint64 hits;
+        quint64 misses;
+        int entryCount;
+    };
+
+private:
+    struct Entry {
+        Texture::DecodedImage image;
+        qint64 size;
+        quint64 lastUse;
+    };
+
+    static QMutex m_mutex;
+    static QHash<QString, Entry> m_entries;
+    static qint64 m_usage;
+    static qint64 m_limit;
+    static quint64 m_useCounter;
+    static quint64 m_hits;
+    static quint64 m_misses;
+
+    static QString key(const QString &filename);
+    static void trim();
+
+public:
+    static bool find(const QString &filename, Texture::DecodedImage *image);
+    static void insert(const QString &filename, const Texture::DecodedImage &image);
+    static void setLimit(int megabytes);
+    static int limit();
+    static Statistics statistics();
+    static void clear();
+
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,99 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include "TextureResolver.h"
+
+TextureResolver::TextureResolver(QObject *parent) :
+    QObject(parent)
+{
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &TextureResolver::directoryChanged);
+}
+
+TextureResolver *TextureResolver::instance()
+{
+    /*
+        Resolving starts on pool threads, the watcher needs the event loop of the application thread
+    */
+    static TextureResolver *resolver = []() {
+        TextureResolver *resolver = new TextureResolver();
+        resolver->moveToThread(QCoreApplication::instance()->thread());
+        return resolver;
+    }();
+
+    return resolver;
+}
+
+TextureResolver::DirectoryIndex TextureResolver::directoryIndex(const QString &path)
+{
+    QString key = QDir::cleanPath(path).toCaseFolded();
+
+    {
+        QReadLocker locker(&m_lock);
+        QHash<QString, DirectoryIndex>::const_iterator i = m_directories.constFind(key);
+
+        if (i != m_directories.constEnd()) {
+            return *i;
+        }
+    }
+
+    /*
+        One listing per directory replaces a stat call per name and extension
+    */
+    DirectoryIndex index;
+    QStringList filenames = QDir(path).entryList(QDir::Files | QDir::Readable);
+
+    for (const QString &filename : filenames) {
+        index.insert(filename.toCaseFolded(), filename);
+    }
+
+    {
+        QWriteLocker locker(&m_lock);
+        m_directories.insert(key, index);
+    }
+
+    if (QFileInfo(path).isDir()) {
+        QMetaObject::invokeMethod(this, [this, path]() {
+            if (!m_watcher.directories().contains(path)) {
+                m_watcher.addPath(path);
+            }
+        }, Qt::QueuedConnection);
+    }
+
+    return index;
+}
+
+void TextureResolver::directoryChanged(const QString &path)
+{
+    QWriteLocker locker(&m_lock);
+    m_directories.remove(QDir::cleanPath(path).toCaseFolded());
+}
+
+QString TextureResolver::resolve(const QString &directory, const QString &name)
+{
+    static const char *ext[5] = {
+        "dds",
+        "png",
+        "bmp",
+        "jpg",
+        "tga"
+    };
+
+    QFileInfo fileInfo(directory + name);
+    DirectoryIndex index = directoryIndex(fileInfo.path());
+
+    for (uint32_t i = 0; i < sizeof(ext) / sizeof(char *); i++) {
+        QString file = index.value((fileInfo.fileName() + "." + QString(ext[i])).toCaseFolded());
+
+        if (!file.isEmpty()) {
+            return fileInfo.path() + "/" + file;
+        }
+    }
+
+    /*
+        A name missing from the index does not exist, callers skip it instead of
+        probing the file system again
+    */
+    return QString();
+}
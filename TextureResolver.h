@@ -0,0 +1,38 @@
+#ifndef TEXTURERESOLVER_H
+#define TEXTURERESOLVER_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QString>
+
+/*
+    Finds texture files through a case-insensitive index of every directory
+    tried, built on first use and shared by all materials and loads. A file
+    watcher drops the index of a directory when its contents change.
+*/
+class TextureResolver: public QObject
+{
+    Q_OBJECT
+
+private:
+    using DirectoryIndex = QHash<QString, QString>;
+
+    QReadWriteLock m_lock;
+    QHash<QString, DirectoryIndex> m_directories;
+    QFileSystemWatcher m_watcher;
+
+    explicit TextureResolver(QObject *parent = nullptr);
+    DirectoryIndex directoryIndex(const QString &path);
+
+private slots:
+    void directoryChanged(const QString &path);
+
+public:
+    static TextureResolver *instance();
+    QString resolve(const QString &directory, const QString &name);
+
+};
+
+#endif // TEXTURERESOLVER_H
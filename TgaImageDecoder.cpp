@@ -0,0 +1,139 @@
+#include <cstring>
+#include "CompiledStaticMesh.h"
+#include "TgaImageDecoder.h"
+
+uint16_t TgaImageDecoder::read16(const uchar *data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+void TgaImageDecoder::convert(const uchar *source, uint32_t bytesPerPixel, uchar *target, size_t pixelCount)
+{
+    switch (bytesPerPixel) {
+    case 4:
+        std::memcpy(target, source, pixelCount * 4);
+        CompiledStaticMesh::PixelConverter::swapRedBlue(target, pixelCount);
+        break;
+
+    case 3:
+        CompiledStaticMesh::PixelConverter::expandBgr(source, target, pixelCount);
+        break;
+
+    default:
+        CompiledStaticMesh::PixelConverter::expandGray(source, target, pixelCount);
+        break;
+    }
+}
+
+bool TgaImageDecoder::canDecode(const QString &suffix, const QByteArray &fileData) const
+{
+    return suffix == "tga" && fileData.size() > HeaderSize;
+}
+
+bool TgaImageDecoder::decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const
+{
+    Q_UNUSED(suffix)
+
+    const uchar *data = reinterpret_cast<const uchar *>(fileData.constData());
+    const uchar *end = data + fileData.size();
+    uint32_t idLength = data[0];
+    uint32_t colorMapType = data[1];
+    uint32_t imageType = data[2];
+    uint32_t width = read16(data + 12);
+    uint32_t height = read16(data + 14);
+    uint32_t depth = data[16];
+    uint32_t descriptor = data[17];
+
+    bool isGray = imageType == 3 || imageType == 11;
+    bool isEncoded = imageType == 10 || imageType == 11;
+
+    if (colorMapType != 0 || (imageType != 2 && imageType != 3 && !isEncoded) ||
+        (isGray && depth != 8) || (!isGray && depth != 24 && depth != 32) ||
+        width == 0 || height == 0 || (descriptor & RightOriginFlag) != 0) {
+        return false;
+    }
+
+    uint32_t bytesPerPixel = depth / 8;
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    const uchar *pixels = data + HeaderSize + idLength;
+
+    if (!isEncoded && (pixels > end || static_cast<size_t>(end - pixels) < pixelCount * bytesPerPixel)) {
+        return false;
+    }
+
+    image->data = QByteArray(static_cast<qsizetype>(pixelCount) * 4, Qt::Uninitialized);
+    uchar *target = reinterpret_cast<uchar *>(image->data.data());
+    bool isTopOrigin = (descriptor & TopOriginFlag) != 0;
+
+    /*
+        Rows are written in place, bottom origin files are flipped on the way
+    */
+    if (!isEncoded) {
+        for (uint32_t y = 0; y < height; y++) {
+            uint32_t row = isTopOrigin ? y : height - 1 - y;
+            convert(pixels + static_cast<size_t>(y) * width * bytesPerPixel, bytesPerPixel,
+                target + static_cast<size_t>(row) * width * 4, width);
+        }
+    } else {
+        uint32_t x = 0;
+        uint32_t y = 0;
+
+        while (y < height) {
+            if (pixels >= end) {
+                image->data.clear();
+                return false;
+            }
+
+            uint32_t packet = *pixels++;
+            uint32_t count = (packet & 0x7f) + 1;
+            bool isRun = (packet & 0x80) != 0;
+            size_t packetSize = isRun ? bytesPerPixel : static_cast<size_t>(count) * bytesPerPixel;
+
+            if (static_cast<size_t>(end - pixels) < packetSize) {
+                image->data.clear();
+                return false;
+            }
+
+            /*
+                Packets may cross rows, each part is converted into its own row
+            */
+            while (count > 0 && y < height) {
+                uint32_t part = qMin(count, width - x);
+                uchar *rowTarget = target + (static_cast<size_t>(isTopOrigin ? y : height - 1 - y) * width + x) * 4;
+
+                if (isRun) {
+                    convert(pixels, bytesPerPixel, rowTarget, 1);
+
+                    for (uint32_t i = 1; i < part; i++) {
+                        std::memcpy(rowTarget + i * 4, rowTarget, 4);
+                    }
+                } else {
+                    convert(pixels, bytesPerPixel, rowTarget, part);
+                    pixels += static_cast<size_t>(part) * bytesPerPixel;
+                }
+
+                count -= part;
+                x += part;
+
+                if (x == width) {
+                    x = 0;
+                    y++;
+                }
+            }
+
+            if (isRun) {
+                pixels += bytesPerPixel;
+            }
+        }
+    }
+
+    if (bytesPerPixel == 4 && (descriptor & AlphaBitsMask) == 0) {
+        CompiledStaticMesh::PixelConverter::setOpaque(target, pixelCount);
+    }
+
+    image->format = QQuick3DTextureData::Format::RGBA8;
+    image->size = QSize(static_cast<int>(width), static_cast<int>(height));
+    image->levelCount = 1;
+
+    return true;
+}
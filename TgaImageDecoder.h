@@ -0,0 +1,29 @@
+#ifndef TGAIMAGEDECODER_H
+#define TGAIMAGEDECODER_H
+
+#include "ImageDecoder.h"
+
+/*
+    True color and gray TGA files, raw or run length encoded. Color mapped
+    and 16 bit files are left to the fallback decoder.
+*/
+class TgaImageDecoder: public ImageDecoder
+{
+
+public:
+    static constexpr const int HeaderSize = 18;
+    static constexpr const uint8_t TopOriginFlag = 0x20;
+    static constexpr const uint8_t RightOriginFlag = 0x10;
+    static constexpr const uint8_t AlphaBitsMask = 0x0f;
+
+private:
+    static uint16_t read16(const uchar *data);
+    static void convert(const uchar *source, uint32_t bytesPerPixel, uchar *target, size_t pixelCount);
+
+public:
+    bool canDecode(const QString &suffix, const QByteArray &fileData) const override;
+    bool decode(const QString &suffix, const QByteArray &fileData, Texture::DecodedImage *image) const override;
+
+};
+
+#endif // TGAIMAGEDECODER_H